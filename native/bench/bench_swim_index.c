@@ -0,0 +1,95 @@
+/**
+ * LSDAMM - SWIM Membership Lookup Benchmark
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Compares node lookup cost of the linked-list walk against the hash index
+ * at 16, 256 and 4096 members.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/mesh/swim_gossip.h"
+#include "../src/mesh/swim_index.h"
+
+#define LOOKUPS 2000000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * Lookup by walking the list (pre-index behaviour)
+ */
+static swim_node_t* list_find(swim_node_t *head, const char *id) {
+    for (swim_node_t *node = head; node; node = node->next) {
+        if (strcmp(node->id, id) == 0) return node;
+    }
+    return NULL;
+}
+
+static void bench_members(uint32_t members) {
+    swim_node_t *nodes = (swim_node_t*)calloc(members, sizeof(swim_node_t));
+    swim_index_t index;
+    swim_index_init(&index, 0);
+
+    // Realistic IDs sharing a long common prefix
+    for (uint32_t i = 0; i < members; i++) {
+        snprintf(nodes[i].id, SWIM_NODE_ID_SIZE, "lsdamm-server-01-node-%u-1735689600", i);
+        nodes[i].id_hash = swim_hash_id(nodes[i].id);
+        nodes[i].next = (i + 1 < members) ? &nodes[i + 1] : NULL;
+        swim_index_insert(&index, &nodes[i]);
+    }
+
+    // Pre-generate query IDs (90% hits, 10% misses)
+    enum { QUERY_SET = 1024 };
+    static char queries[QUERY_SET][SWIM_NODE_ID_SIZE];
+    srand(42);
+    for (int q = 0; q < QUERY_SET; q++) {
+        if (q % 10 == 9) {
+            snprintf(queries[q], SWIM_NODE_ID_SIZE, "lsdamm-server-99-node-%d-1735689600", q);
+        } else {
+            strcpy(queries[q], nodes[rand() % members].id);
+        }
+    }
+
+    uint32_t list_iters = members >= 4096 ? LOOKUPS / 100 : LOOKUPS / 10;
+    size_t found = 0;
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < list_iters; i++) {
+        found += list_find(nodes, queries[i % QUERY_SET]) != NULL;
+    }
+    double list_ns = (now_ns() - start) / list_iters;
+
+    start = now_ns();
+    for (uint32_t i = 0; i < LOOKUPS; i++) {
+        const char *id = queries[i % QUERY_SET];
+        found += swim_index_find(&index, id, swim_hash_id(id)) != NULL;
+    }
+    double index_ns = (now_ns() - start) / LOOKUPS;
+
+    printf("%8u members: list %10.1f ns/lookup   index %6.1f ns/lookup   (%.0fx)  [%zu]\n",
+           members, list_ns, index_ns, list_ns / index_ns, found);
+
+    swim_index_destroy(&index);
+    free(nodes);
+}
+
+int main(void) {
+    printf("SWIM node lookup benchmark\n");
+    printf("==========================\n");
+
+    bench_members(16);
+    bench_members(256);
+    bench_members(4096);
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * LSDAMM - SWIM Batched I/O Benchmark
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Syscalls and time per datagram for per-datagram sendto/recvfrom versus
+ * sendmmsg/recvmmsg (and UDP_SEGMENT for trains to one peer) over loopback.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "../src/mesh/swim_io.h"
+
+#define PEERS   256
+#define ROUNDS  200
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int open_socket(uint16_t port, struct sockaddr_in *addr) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+    int rcvbuf = 8 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(sock, (struct sockaddr*)addr, sizeof(*addr));
+
+    socklen_t len = sizeof(*addr);
+    getsockname(sock, (struct sockaddr*)addr, &len);
+    return sock;
+}
+
+static void drain(int sock) {
+    uint8_t buf[65536];
+    while (recv(sock, buf, sizeof(buf), MSG_DONTWAIT) > 0) {}
+}
+
+static void report(const char *label, uint64_t syscalls, uint64_t datagrams, double ns) {
+    printf("  %-28s %8.3f syscalls/msg   %7.0f ns/msg\n",
+           label, (double)syscalls / (double)datagrams, ns / (double)datagrams);
+}
+
+/**
+ * One datagram to each of PEERS distinct peers (swim_broadcast pattern)
+ */
+static void bench_fanout(int sock, int *peers, struct sockaddr_in *peer_addr, bool batched) {
+    swim_io_t io;
+    uint8_t payload[96];
+    memset(payload, 0xAB, sizeof(payload));
+
+    swim_io_init(&io, sock);
+    io.use_mmsg = io.use_mmsg && batched;
+
+    double start = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int p = 0; p < PEERS; p++) {
+            swim_io_queue_ref(&io, &peer_addr[p], payload, sizeof(payload));
+        }
+        swim_io_flush(&io);
+        if (r % 16 == 15) {
+            for (int p = 0; p < PEERS; p++) drain(peers[p]);
+        }
+    }
+    double elapsed = now_ns() - start;
+
+    report(batched ? "fan-out, sendmmsg" : "fan-out, sendto",
+           io.tx_syscalls, io.tx_datagrams + io.tx_dropped, elapsed);
+    swim_io_destroy(&io);
+    for (int p = 0; p < PEERS; p++) drain(peers[p]);
+}
+
+/**
+ * Train of equal-sized datagrams to one peer (GSO applies)
+ */
+static void bench_train(int sock, int peer, const struct sockaddr_in *addr, bool batched, bool gso) {
+    swim_io_t io;
+    uint8_t payload[1200];
+    memset(payload, 0xCD, sizeof(payload));
+
+    swim_io_init(&io, sock);
+    io.use_mmsg = io.use_mmsg && batched;
+    bool have_gso = io.use_gso;
+    io.use_gso = io.use_gso && gso;
+    if (gso && !have_gso) {
+        printf("  %-28s (UDP_SEGMENT not supported)\n", "train, sendmmsg + GSO");
+        swim_io_destroy(&io);
+        return;
+    }
+
+    double start = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < SWIM_IO_BATCH; i++) {
+            swim_io_queue_ref(&io, addr, payload, sizeof(payload));
+        }
+        swim_io_flush(&io);
+        drain(peer);
+    }
+    double elapsed = now_ns() - start;
+
+    report(gso ? "train, sendmmsg + GSO" : batched ? "train, sendmmsg" : "train, sendto",
+           io.tx_syscalls, io.tx_datagrams + io.tx_dropped, elapsed);
+    swim_io_destroy(&io);
+}
+
+/**
+ * Drain bursts of PEERS datagrams (swim_process pattern)
+ */
+static void bench_receive(int sender, int sock, const struct sockaddr_in *addr, bool batched) {
+    swim_io_t io;
+    uint8_t payload[96];
+    memset(payload, 0xEF, sizeof(payload));
+
+    swim_io_init(&io, sock);
+    io.use_mmsg = io.use_mmsg && batched;
+
+    double elapsed = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int p = 0; p < PEERS; p++) {
+            sendto(sender, payload, sizeof(payload), 0, (const struct sockaddr*)addr, sizeof(*addr));
+        }
+
+        double start = now_ns();
+        while (swim_io_recv(&io) == SWIM_IO_BATCH) {}
+        elapsed += now_ns() - start;
+    }
+
+    report(batched ? "receive, recvmmsg" : "receive, recvfrom",
+           io.rx_syscalls, io.rx_datagrams, elapsed);
+    swim_io_destroy(&io);
+}
+
+int main(void) {
+    struct sockaddr_in self_addr, peer_addr[PEERS];
+    int peers[PEERS];
+
+    int self = open_socket(0, &self_addr);
+    for (int p = 0; p < PEERS; p++) {
+        peers[p] = open_socket(0, &peer_addr[p]);
+    }
+
+    printf("SWIM batched I/O benchmark (loopback, batch %d)\n", SWIM_IO_BATCH);
+    printf("===============================================\n");
+
+    printf("\nBroadcast to %d peers, 96 B\n", PEERS);
+    bench_fanout(self, peers, peer_addr, false);
+    bench_fanout(self, peers, peer_addr, true);
+
+    printf("\nTrain of %d x 1200 B to one peer\n", SWIM_IO_BATCH);
+    bench_train(self, peers[0], &peer_addr[0], false, false);
+    bench_train(self, peers[0], &peer_addr[0], true, false);
+    bench_train(self, peers[0], &peer_addr[0], true, true);
+
+    printf("\nReceive bursts of %d x 96 B\n", PEERS);
+    bench_receive(peers[1], self, &self_addr, false);
+    bench_receive(peers[1], self, &self_addr, true);
+
+    for (int p = 0; p < PEERS; p++) close(peers[p]);
+    close(self);
+    return 0;
+}
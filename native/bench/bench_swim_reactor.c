@@ -0,0 +1,108 @@
+/**
+ * LSDAMM - SWIM Reactor Benchmark
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Idle 16-instance server: a protocol thread per SWIM context versus one
+ * shared reactor. Reports thread wakeups (context switches) per second and
+ * CPU time. Usage: bench_swim_reactor [seconds] [reactor threads]
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../src/mesh/swim_reactor.h"
+#include "../src/util/logging.h"
+
+#define INSTANCES       16
+#define BASE_PORT       8100
+
+typedef struct {
+    double cpu_ms;
+    double switches;
+} usage_t;
+
+static usage_t sample_usage(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    usage_t u;
+    u.cpu_ms = (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000.0 +
+               (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000.0;
+    u.switches = (double)(ru.ru_nvcsw + ru.ru_nivcsw);
+    return u;
+}
+
+/**
+ * Run an idle cluster for seconds after it converges
+ */
+static void run_mode(const char *name, uint32_t reactor_threads, int seconds, uint16_t base_port) {
+    swim_reactor_t *reactor = reactor_threads ? swim_reactor_create(reactor_threads, true) : NULL;
+    swim_context_t *nodes[INSTANCES];
+
+    for (int i = 0; i < INSTANCES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "bench-node-%02d", i);
+        nodes[i] = swim_init(id, (uint16_t)(base_port + i), SWIM_DEFAULT_INTERVAL);
+        if (!nodes[i]) {
+            fprintf(stderr, "failed to create node %d\n", i);
+            exit(1);
+        }
+        if (reactor) swim_reactor_attach(reactor, nodes[i]);
+        swim_start(nodes[i]);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", base_port);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        bool converged = true;
+        for (int j = 0; j < INSTANCES; j++) {
+            converged = converged && swim_get_node_count(nodes[j], NODE_STATE_ALIVE) >= INSTANCES;
+        }
+        if (converged) break;
+        usleep(100000);
+    }
+
+    swim_reactor_stats_t before = {0}, after = {0};
+    if (reactor) swim_reactor_get_stats(reactor, &before);
+    usage_t start = sample_usage();
+    sleep((unsigned)seconds);
+    usage_t end = sample_usage();
+    if (reactor) swim_reactor_get_stats(reactor, &after);
+
+    printf("  %-22s %8.1f switches/s", name, (end.switches - start.switches) / seconds);
+    if (reactor) {
+        printf("  %6.1f loop wakeups/s", (double)(after.wakeups - before.wakeups) / seconds);
+    } else {
+        printf("  %22s", "");
+    }
+    printf("  %6.2f ms CPU/s\n", (end.cpu_ms - start.cpu_ms) / seconds);
+
+    for (int i = 0; i < INSTANCES; i++) swim_destroy(nodes[i]);
+    swim_reactor_destroy(reactor);
+}
+
+int main(int argc, char **argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 5;
+    uint32_t threads = argc > 2 ? (uint32_t)atoi(argv[2]) : 1;
+    if (seconds < 1) seconds = 1;
+    if (threads < 1) threads = 1;
+
+    log_set_level(LOG_LEVEL_ERROR);
+
+    printf("SWIM reactor benchmark\n");
+    printf("======================\n");
+    printf("  %d idle instances, %d ms protocol period, %d s measured\n\n",
+           INSTANCES, SWIM_DEFAULT_INTERVAL, seconds);
+
+    run_mode("thread per instance", 0, seconds, BASE_PORT);
+
+    char name[32];
+    snprintf(name, sizeof(name), "reactor (%u thread%s)", threads, threads == 1 ? "" : "s");
+    run_mode(name, threads, seconds, BASE_PORT + INSTANCES);
+
+    return 0;
+}
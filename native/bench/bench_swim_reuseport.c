@@ -0,0 +1,135 @@
+/**
+ * LSDAMM - SWIM Receive Shard Benchmark
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * High fan-in seed: blaster threads, each on its own source port, flood
+ * one SWIM port with PINGs. Reports PINGs handled per second by a seed
+ * with 1, 2 and 4 SO_REUSEPORT receive sockets.
+ * Usage: bench_swim_reuseport [seconds] [blasters]
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "../src/mesh/swim_gossip.h"
+#include "../src/mesh/swim_wire.h"
+#include "../src/util/logging.h"
+
+#define BASE_PORT       8140
+#define MAX_BLASTERS    32
+#define BURST           32
+
+typedef struct {
+    int index;
+    uint16_t seed_port;
+    volatile int *running;
+    uint64_t sent;
+} blaster_t;
+
+/**
+ * Send bursts of PINGs, each with its own seq so none is dropped as a
+ * duplicate, discarding the ACKs
+ */
+static void* blast(void *arg) {
+    blaster_t *b = (blaster_t*)arg;
+
+    uint8_t ping[256];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.type = SWIM_MSG_PING;
+    header.incarnation = 1;
+    snprintf(header.sender_id, sizeof(header.sender_id), "blaster-%02d", b->index);
+    snprintf(header.target_id, sizeof(header.target_id), "bench-seed");
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(b->seed_port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    uint8_t sink[2048];
+    while (*b->running) {
+        for (int i = 0; i < BURST; i++) {
+            header.seq_num++;
+            swim_wire_writer_init(&w, ping, sizeof(ping));
+            swim_wire_write_header(&w, &header);
+            if (sendto(sock, ping, w.len, 0, (struct sockaddr*)&to, sizeof(to)) > 0) b->sent++;
+        }
+        while (recv(sock, sink, sizeof(sink), MSG_DONTWAIT) > 0) {}
+    }
+
+    close(sock);
+    return NULL;
+}
+
+/**
+ * Flood a seed with rx_shards receive sockets for seconds
+ */
+static void run_mode(uint32_t rx_shards, int blasters, int seconds, uint16_t port) {
+    swim_context_t *seed = swim_init_sharded("bench-seed", port, SWIM_DEFAULT_INTERVAL, rx_shards);
+    if (!seed) {
+        fprintf(stderr, "failed to create seed on port %d\n", port);
+        exit(1);
+    }
+    swim_start(seed);
+
+    volatile int running = 1;
+    blaster_t b[MAX_BLASTERS];
+    pthread_t threads[MAX_BLASTERS];
+    for (int i = 0; i < blasters; i++) {
+        b[i] = (blaster_t){ i, port, &running, 0 };
+        pthread_create(&threads[i], NULL, blast, &b[i]);
+    }
+
+    usleep(200000);
+    swim_stats_t before, after;
+    swim_get_detailed_stats(seed, &before);
+    sleep((unsigned)seconds);
+    swim_get_detailed_stats(seed, &after);
+
+    running = 0;
+    uint64_t sent = 0;
+    for (int i = 0; i < blasters; i++) {
+        pthread_join(threads[i], NULL);
+        sent += b[i].sent;
+    }
+
+    double handled = (double)(after.messages_received - before.messages_received) / seconds;
+    double on_shards = (double)(after.shard_rx_datagrams - before.shard_rx_datagrams) / seconds;
+    printf("  %2u socket%s %10.0f msgs/s handled  %10.0f on shards  %10.0f sent/s\n",
+           after.rx_shards, after.rx_shards == 1 ? " " : "s", handled, on_shards,
+           (double)sent / (seconds + 0.2));
+
+    swim_destroy(seed);
+}
+
+int main(int argc, char **argv) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 3;
+    int blasters = argc > 2 ? atoi(argv[2]) : 8;
+    if (seconds < 1) seconds = 1;
+    if (blasters < 1) blasters = 1;
+    if (blasters > MAX_BLASTERS) blasters = MAX_BLASTERS;
+
+    log_set_level(LOG_LEVEL_ERROR);
+
+    printf("SWIM receive shard benchmark\n");
+    printf("============================\n");
+    printf("  %d blasters, %ld CPUs, %d s measured\n\n", blasters, sysconf(_SC_NPROCESSORS_ONLN), seconds);
+
+    run_mode(1, blasters, seconds, BASE_PORT);
+    run_mode(2, blasters, seconds, BASE_PORT + 1);
+    run_mode(4, blasters, seconds, BASE_PORT + 2);
+
+    return 0;
+}
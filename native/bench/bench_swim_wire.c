@@ -0,0 +1,171 @@
+/**
+ * LSDAMM - SWIM Wire Format Benchmark
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Encode/decode cost of the compact wire format, and bytes on the wire per
+ * message and per protocol round compared with the raw v1 structs.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/mesh/swim_gossip.h"
+#include "../src/mesh/swim_wire.h"
+
+#define ITERATIONS 1000000
+
+// v1 layouts: host-endian structs sent as-is
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint16_t payload_len;
+    uint32_t seq_num;
+    char sender_id[64];
+    uint32_t incarnation;
+} v1_header_t;
+
+typedef struct {
+    v1_header_t header;
+    char target_id[64];
+} v1_ping_t;
+
+typedef struct {
+    v1_header_t header;
+    char target_id[64];
+    char source_id[64];
+} v1_ping_req_t;
+
+typedef struct {
+    v1_header_t header;
+    char target_id[64];
+    uint8_t payload[1024];
+    uint16_t payload_len;
+} v1_ack_t;
+
+typedef struct {
+    char id[64];
+    char address[64];
+    uint16_t port;
+    uint8_t state;
+    uint32_t incarnation;
+    uint8_t is_main_node;
+} v1_update_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void make_update(swim_wire_update_t *update, int i) {
+    memset(update, 0, sizeof(*update));
+    snprintf(update->id, sizeof(update->id), "lsdamm-server-01-node-%d-1735689600", i);
+    snprintf(update->address, sizeof(update->address), "10.0.%d.%d", i / 250, i % 250 + 1);
+    update->port = 7946;
+    update->state = NODE_STATE_ALIVE;
+    update->incarnation = 3 + i;
+}
+
+/**
+ * Encode one message with the given number of piggybacked updates
+ */
+static size_t encode(uint8_t *buf, size_t cap, uint8_t type, uint32_t seq,
+                     const swim_wire_update_t *updates, int count) {
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+
+    header.type = type;
+    header.seq_num = seq;
+    header.incarnation = 7;
+    strcpy(header.sender_id, "lsdamm-server-01-node-0-1735689600");
+    strcpy(header.target_id, "lsdamm-server-01-node-1-1735689600");
+
+    swim_wire_writer_init(&w, buf, cap);
+    swim_wire_write_header(&w, &header);
+    for (int i = 0; i < count; i++) {
+        swim_wire_write_update(&w, &updates[i]);
+    }
+    return w.len;
+}
+
+/**
+ * Decode one message, returning its update count
+ */
+static int decode(const uint8_t *buf, size_t len) {
+    swim_wire_reader_t r;
+    swim_wire_header_t header;
+    swim_wire_update_t update;
+    int count = 0;
+
+    swim_wire_reader_init(&r, buf, len);
+    if (swim_wire_read_header(&r, &header) != 0) return -1;
+    while (swim_wire_read_update(&r, &update) > 0) count++;
+    return count;
+}
+
+static void bench_codec(const swim_wire_update_t *updates, int count) {
+    uint8_t buf[SWIM_MAX_DATAGRAM];
+    size_t len = 0;
+    long check = 0;
+
+    double start = now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        len = encode(buf, sizeof(buf), SWIM_MSG_PING, i, updates, count);
+        check += (long)len;
+    }
+    double encode_ns = (now_ns() - start) / ITERATIONS;
+
+    start = now_ns();
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        check += decode(buf, len);
+    }
+    double decode_ns = (now_ns() - start) / ITERATIONS;
+
+    printf("  PING + %d updates: encode %6.1f ns   decode %6.1f ns   [%ld]\n",
+           count, encode_ns, decode_ns, check);
+}
+
+int main(void) {
+    swim_wire_update_t updates[SWIM_PIGGYBACK_MAX];
+    uint8_t buf[SWIM_MAX_DATAGRAM];
+
+    for (int i = 0; i < SWIM_PIGGYBACK_MAX; i++) {
+        make_update(&updates[i], i + 2);
+    }
+
+    printf("SWIM wire format benchmark\n");
+    printf("==========================\n");
+
+    printf("\nEncode/decode (%d iterations)\n", ITERATIONS);
+    bench_codec(updates, 0);
+    bench_codec(updates, 4);
+    bench_codec(updates, SWIM_PIGGYBACK_MAX);
+
+    printf("\nBytes per message            v1 structs   compact\n");
+    printf("  PING                       %10zu   %7zu\n", sizeof(v1_ping_t),
+           encode(buf, sizeof(buf), SWIM_MSG_PING, 1000, updates, 0));
+    printf("  PING_REQ                   %10zu   %7zu\n", sizeof(v1_ping_req_t),
+           encode(buf, sizeof(buf), SWIM_MSG_PING_REQ, 1000, updates, 0));
+    printf("  ACK                        %10zu   %7zu\n", sizeof(v1_ack_t),
+           encode(buf, sizeof(buf), SWIM_MSG_ACK, 1000, updates, 0));
+    printf("  update entry               %10zu   %7zu\n", sizeof(v1_update_t),
+           encode(buf, sizeof(buf), SWIM_MSG_ACK, 1000, updates, 1) -
+           encode(buf, sizeof(buf), SWIM_MSG_ACK, 1000, updates, 0));
+
+    // One probe round: PING out, ACK back, each carrying k piggybacked updates
+    printf("\nBytes per round (PING + ACK)  v1 structs   compact\n");
+    for (int k = 0; k <= SWIM_PIGGYBACK_MAX; k += 4) {
+        size_t v1 = sizeof(v1_ping_t) + sizeof(v1_ack_t) + 2 * (size_t)k * sizeof(v1_update_t);
+        size_t compact = encode(buf, sizeof(buf), SWIM_MSG_PING, 1000, updates, k) +
+                         encode(buf, sizeof(buf), SWIM_MSG_ACK, 1000, updates, k);
+        printf("  %d updates each way         %10zu   %7zu   (%.1fx)\n",
+               k, v1, compact, (double)v1 / (double)compact);
+    }
+
+    return 0;
+}
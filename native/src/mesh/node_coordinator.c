@@ -5,8 +5,13 @@
  * (c) 2025 Lackadaisical Security
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "node_coordinator.h"
 #include "../util/logging.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -34,13 +39,13 @@ static int64_t random_election_timeout(void) {
 }
 
 // Node event callback
-static void on_node_event(swim_node_t *node, swim_node_state_t old_state,
+static void on_node_event(const swim_member_t *member, swim_node_state_t old_state,
                           swim_node_state_t new_state, void *user_data) {
     node_coordinator_t *coord = (node_coordinator_t*)user_data;
     
     // If leader went down, start election
-    if (strcmp(node->id, coord->leader_id) == 0 && new_state != NODE_STATE_ALIVE) {
-        log_info("COORD: Leader %s is no longer alive, starting election", node->id);
+    if (strcmp(member->id, coord->leader_id) == 0 && new_state != NODE_STATE_ALIVE) {
+        log_info("COORD: Leader %s is no longer alive, starting election", member->id);
         coordinator_start_election(coord);
     }
 }
@@ -51,6 +51,16 @@ node_manager_t* node_manager_init(const char *server_id, uint16_t port_start, ui
     mgr->next_available_port = mgr->port_range_start;
     mgr->max_instances = MAX_NODES_PER_SERVER;
     
+    mgr->shm_hub = swim_shm_hub_create();
+    if (!mgr->shm_hub) {
+        log_warn("Shared-memory hub unavailable, nodes will gossip over UDP only");
+    }
+    
+    mgr->reactor = swim_reactor_create(NODE_MANAGER_REACTOR_THREADS, false);
+    if (!mgr->reactor) {
+        log_warn("Reactor unavailable, each node will run its own protocol thread");
+    }
+    
 #ifdef _WIN32
     InitializeCriticalSection(&mgr->lock);
 #else
@@ -90,6 +100,9 @@ void node_manager_destroy(node_manager_t *mgr) {
     mgr->instance_count = 0;
     mgr_unlock(mgr);
     
+    swim_reactor_destroy(mgr->reactor);
+    swim_shm_hub_destroy(mgr->shm_hub);
+    
 #ifdef _WIN32
     DeleteCriticalSection(&mgr->lock);
 #else
@@ -199,14 +212,24 @@ node_instance_t* node_manager_create_node(node_manager_t *mgr, const node_instan
     node->is_main_node = config->is_main_node;
     node->is_running = false;
     
-    // Create SWIM context
-    node->swim = swim_init(node->id, swim_port, SWIM_DEFAULT_INTERVAL);
+    // Create SWIM context (a NULL hub gives a plain UDP transport)
+    swim_transport_t *transport = swim_transport_shm(mgr->shm_hub, swim_port);
+    node->swim = swim_init_transport(node->id, swim_port, SWIM_DEFAULT_INTERVAL, transport);
     if (!node->swim) {
         log_error("Failed to create SWIM context for node %s", node->id);
         free(node);
         return NULL;
     }
     
+    // The shm transport owns the UDP port, so joins can bootstrap over TCP
+    if (swim_listen_bootstrap(node->swim) != 0) {
+        log_warn("Node %s joins and is joined over UDP only", node->id);
+    }
+    
+    if (mgr->reactor) {
+        swim_reactor_attach(mgr->reactor, node->swim);
+    }
+    
     // Create coordinator
     node->coordinator = coordinator_init(node->swim, config->is_main_node);
     if (!node->coordinator) {
@@ -464,10 +487,7 @@ void node_manager_process(node_manager_t *mgr) {
     
     while (node) {
         if (node->is_running) {
-            // Process SWIM
-            if (node->swim) {
-                swim_process(node->swim);
-            }
+            // SWIM sockets and timers belong to the reactor (or the node's own thread)
             
             // Process coordinator
             if (node->coordinator) {
@@ -14,11 +14,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "swim_gossip.h"
+#include "swim_shm.h"
+#include "swim_reactor.h"
 #include "node_coordinator.h"
 
 // Maximum nodes per server
 #define MAX_NODES_PER_SERVER 16
 
+// Event loop threads shared by all nodes (each node is driven by exactly one)
+#define NODE_MANAGER_REACTOR_THREADS 1
+
 // Node instance configuration
 typedef struct {
     char node_id[64];
@@ -60,6 +65,12 @@ typedef struct {
     uint16_t port_range_end;
     uint16_t next_available_port;
     
+    // Co-located instances gossip through shared-memory rings
+    swim_shm_hub_t *shm_hub;
+    
+    // Event loops owning every instance's socket and protocol timers
+    swim_reactor_t *reactor;
+    
     // Shared configuration
     char server_id[64];
     char mesh_url[256];
@@ -169,7 +180,7 @@ void node_manager_set_callbacks(
 );
 
 /**
- * Process all nodes (call from main loop)
+ * Run coordinator logic for all nodes (call from main loop; SWIM runs on the reactor)
  */
 void node_manager_process(node_manager_t *mgr);
 
@@ -0,0 +1,304 @@
+/**
+ * LSDAMM - SWIM Bootstrap Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "swim_bootstrap.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#endif
+
+// A peer that went away must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define SWIM_BOOTSTRAP_SEND_FLAGS   MSG_NOSIGNAL
+#else
+#define SWIM_BOOTSTRAP_SEND_FLAGS   0
+#endif
+
+/**
+ * Close a socket
+ */
+void swim_bootstrap_close(swim_socket_t sock) {
+    if (sock == SWIM_TRANSPORT_NO_FD) return;
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+/**
+ * Switch a socket between blocking and non-blocking
+ */
+static void swim_bootstrap_set_blocking(swim_socket_t sock, bool blocking) {
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+/**
+ * Non-blocking, so every wait goes through swim_bootstrap_wait
+ */
+static void swim_bootstrap_configure(swim_socket_t sock) {
+    swim_bootstrap_set_blocking(sock, false);
+
+    // The frame goes out in one piece; don't hold its tail back for an ACK
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+}
+
+/**
+ * Deadline SWIM_BOOTSTRAP_TIMEOUT_MS from now (ms, monotonic)
+ */
+static uint64_t swim_bootstrap_deadline(void) {
+    return swim_transport_system_us() / 1000 + SWIM_BOOTSTRAP_TIMEOUT_MS;
+}
+
+/**
+ * Wait until sock is ready for events or the deadline passes
+ * @return 0 if ready, -1 on timeout or error
+ */
+static int swim_bootstrap_wait(swim_socket_t sock, short events, uint64_t deadline_ms) {
+    for (;;) {
+        uint64_t now = swim_transport_system_us() / 1000;
+        if (now >= deadline_ms) return -1;
+#ifdef _WIN32
+        WSAPOLLFD pfd = { sock, events, 0 };
+        int ready = WSAPoll(&pfd, 1, (int)(deadline_ms - now));
+#else
+        struct pollfd pfd = { sock, events, 0 };
+        int ready = poll(&pfd, 1, (int)(deadline_ms - now));
+        if (ready < 0 && errno == EINTR) continue;
+#endif
+        return ready > 0 ? 0 : -1;
+    }
+}
+
+/**
+ * Whether the last send or recv failed only because it would block
+ */
+static bool swim_bootstrap_would_block(void) {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+/**
+ * Send all of buf before the deadline
+ */
+static int swim_bootstrap_send_all(swim_socket_t sock, const uint8_t *buf, size_t len, uint64_t deadline_ms) {
+    while (len > 0) {
+        int chunk = len > (1u << 30) ? (1 << 30) : (int)len;
+#ifdef _WIN32
+        int n = send(sock, (const char*)buf, chunk, 0);
+#else
+        ssize_t n = send(sock, buf, (size_t)chunk, SWIM_BOOTSTRAP_SEND_FLAGS);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n < 0 && swim_bootstrap_would_block()) {
+            if (swim_bootstrap_wait(sock, POLLOUT, deadline_ms) != 0) return -1;
+            continue;
+        }
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Receive exactly len bytes before the deadline
+ */
+static int swim_bootstrap_recv_all(swim_socket_t sock, uint8_t *buf, size_t len, uint64_t deadline_ms) {
+    while (len > 0) {
+        int chunk = len > (1u << 30) ? (1 << 30) : (int)len;
+#ifdef _WIN32
+        int n = recv(sock, (char*)buf, chunk, 0);
+#else
+        ssize_t n = recv(sock, buf, (size_t)chunk, 0);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n < 0 && swim_bootstrap_would_block()) {
+            if (swim_bootstrap_wait(sock, POLLIN, deadline_ms) != 0) return -1;
+            continue;
+        }
+        if (n <= 0) return -1;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * Send one frame
+ */
+static int swim_bootstrap_write_frame(swim_socket_t sock, const uint8_t *data, size_t len, uint64_t deadline_ms) {
+    if (len > SWIM_BOOTSTRAP_MAX_FRAME) return -1;
+
+    uint8_t prefix[4] = {
+        (uint8_t)(len >> 24), (uint8_t)(len >> 16), (uint8_t)(len >> 8), (uint8_t)len
+    };
+    if (swim_bootstrap_send_all(sock, prefix, sizeof(prefix), deadline_ms) != 0) return -1;
+    return swim_bootstrap_send_all(sock, data, len, deadline_ms);
+}
+
+/**
+ * Receive one frame of at most max_len bytes into a malloc'd buffer
+ */
+static int swim_bootstrap_read_frame(swim_socket_t sock, size_t max_len, uint64_t deadline_ms,
+                                     uint8_t **data, size_t *len) {
+    uint8_t prefix[4];
+    if (swim_bootstrap_recv_all(sock, prefix, sizeof(prefix), deadline_ms) != 0) return -1;
+
+    // Checked before allocating: the prefix comes from an unauthenticated peer
+    size_t n = ((size_t)prefix[0] << 24) | ((size_t)prefix[1] << 16) | ((size_t)prefix[2] << 8) | prefix[3];
+    if (n == 0 || n > max_len || n > SWIM_BOOTSTRAP_MAX_FRAME) return -1;
+
+    uint8_t *buf = (uint8_t*)malloc(n);
+    if (!buf) return -1;
+    if (swim_bootstrap_recv_all(sock, buf, n, deadline_ms) != 0) {
+        free(buf);
+        return -1;
+    }
+
+    *data = buf;
+    *len = n;
+    return 0;
+}
+
+/**
+ * Listen for exchanges
+ */
+swim_socket_t swim_bootstrap_listen(uint16_t port) {
+#ifdef _WIN32
+    swim_socket_t sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) {
+#else
+    swim_socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+#endif
+        log_error("SWIM: Failed to create bootstrap socket");
+        return SWIM_TRANSPORT_NO_FD;
+    }
+
+    // Restarted nodes rebind while old connections sit in TIME_WAIT
+    int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(sock, SWIM_BOOTSTRAP_BACKLOG) != 0) {
+        log_warn("SWIM: Failed to listen for bootstrap on TCP port %d", port);
+        swim_bootstrap_close(sock);
+        return SWIM_TRANSPORT_NO_FD;
+    }
+
+    swim_bootstrap_set_blocking(sock, false);
+    return sock;
+}
+
+/**
+ * Accept and answer one connection
+ */
+int swim_bootstrap_serve(swim_socket_t listener, size_t max_request, swim_bootstrap_handler handler, void *arg) {
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+    swim_socket_t sock = accept(listener, (struct sockaddr*)&from, &from_len);
+    if (sock == SWIM_TRANSPORT_NO_FD) return -1;
+    swim_bootstrap_configure(sock);
+    uint64_t deadline_ms = swim_bootstrap_deadline();
+
+    uint8_t *request = NULL;
+    uint8_t *response = NULL;
+    size_t request_len = 0;
+    size_t response_len = 0;
+    int result = -1;
+
+    if (swim_bootstrap_read_frame(sock, max_request, deadline_ms, &request, &request_len) == 0 &&
+        handler(arg, &from, request, request_len, &response, &response_len) == 0) {
+        result = swim_bootstrap_write_frame(sock, response, response_len, deadline_ms);
+    }
+
+    free(request);
+    free(response);
+    swim_bootstrap_close(sock);
+    return result;
+}
+
+/**
+ * Connect before the deadline
+ */
+static swim_socket_t swim_bootstrap_connect(const struct sockaddr_in *to, uint64_t deadline_ms) {
+#ifdef _WIN32
+    swim_socket_t sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return SWIM_TRANSPORT_NO_FD;
+#else
+    swim_socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) return SWIM_TRANSPORT_NO_FD;
+#endif
+
+    swim_bootstrap_configure(sock);
+    if (connect(sock, (const struct sockaddr*)to, sizeof(*to)) != 0) {
+#ifdef _WIN32
+        bool pending = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        bool pending = errno == EINPROGRESS;
+#endif
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (!pending || swim_bootstrap_wait(sock, POLLOUT, deadline_ms) != 0 ||
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, (char*)&error, &error_len) != 0 || error != 0) {
+            swim_bootstrap_close(sock);
+            return SWIM_TRANSPORT_NO_FD;
+        }
+    }
+
+    return sock;
+}
+
+/**
+ * Exchange frames with a listener
+ */
+int swim_bootstrap_exchange(const struct sockaddr_in *to, const uint8_t *request, size_t len,
+                            uint8_t **response, size_t *response_len) {
+    uint64_t deadline_ms = swim_bootstrap_deadline();
+    swim_socket_t sock = swim_bootstrap_connect(to, deadline_ms);
+    if (sock == SWIM_TRANSPORT_NO_FD) return -1;
+
+    int result = swim_bootstrap_write_frame(sock, request, len, deadline_ms);
+    if (result == 0) {
+        result = swim_bootstrap_read_frame(sock, SWIM_BOOTSTRAP_MAX_FRAME, deadline_ms, response, response_len);
+    }
+
+    swim_bootstrap_close(sock);
+    return result;
+}
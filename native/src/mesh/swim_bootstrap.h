@@ -0,0 +1,67 @@
+/**
+ * LSDAMM - SWIM Bootstrap Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * One-shot TCP exchange of full membership state, used when a node joins:
+ * the joiner connects to the seed's port, sends its own state and reads
+ * the seed's complete table back, so it knows the whole cluster after one
+ * round trip plus the transfer instead of after many gossip rounds.
+ *
+ * Each side sends a single frame, len:u32 (big-endian) followed by len
+ * bytes of SWIM wire message; what the frames contain is the caller's
+ * business. The whole exchange, connect included, has SWIM_BOOTSTRAP_TIMEOUT_MS
+ * to finish, so a slow or stalled peer holds either side no longer than
+ * that, and the connection is closed after it.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_BOOTSTRAP_H
+#define SWIM_BOOTSTRAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "swim_transport.h"
+
+#define SWIM_BOOTSTRAP_TIMEOUT_MS   2000                // Whole exchange, connect included
+#define SWIM_BOOTSTRAP_MAX_FRAME    (16 * 1024 * 1024)  // Largest frame sent or accepted
+#define SWIM_BOOTSTRAP_BACKLOG      16                  // Pending connections per listener
+
+/**
+ * Answer one request
+ * @param from Address the connection came from
+ * @param response Set to a malloc'd frame body (freed by the caller)
+ * @return 0 to send the response, -1 to close without one
+ */
+typedef int (*swim_bootstrap_handler)(void *arg, const struct sockaddr_in *from,
+                                      const uint8_t *request, size_t len,
+                                      uint8_t **response, size_t *response_len);
+
+/**
+ * Listen for exchanges on a TCP port (non-blocking, for poll)
+ * @return Listening socket, or SWIM_TRANSPORT_NO_FD on failure
+ */
+swim_socket_t swim_bootstrap_listen(uint16_t port);
+
+/**
+ * Accept one pending connection and answer it through handler
+ * @param max_request Largest request frame accepted; a longer length
+ *        prefix closes the connection before anything is allocated
+ * @return 0 if a response was sent, -1 otherwise
+ */
+int swim_bootstrap_serve(swim_socket_t listener, size_t max_request, swim_bootstrap_handler handler, void *arg);
+
+/**
+ * Send request to a listener and read its response (blocks)
+ * @param response Set to a malloc'd frame body on success
+ * @return 0 on success, -1 on connect, I/O or framing failure
+ */
+int swim_bootstrap_exchange(const struct sockaddr_in *to, const uint8_t *request, size_t len,
+                            uint8_t **response, size_t *response_len);
+
+/**
+ * Close a socket from this module
+ */
+void swim_bootstrap_close(swim_socket_t sock);
+
+#endif // SWIM_BOOTSTRAP_H
@@ -0,0 +1,311 @@
+/**
+ * LSDAMM - SWIM Reliable Channel Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_channel.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Queued fragment by sequence number
+ */
+static swim_channel_frag_t* swim_channel_at(swim_channel_t *ch, uint32_t seq) {
+    return &ch->frags[seq % SWIM_CHANNEL_QUEUE];
+}
+
+/**
+ * Fail queued messages and empty the send queue
+ */
+static void swim_channel_drop_send(swim_channel_t *ch, swim_channel_done_cb done, void *arg) {
+    for (uint32_t s = ch->una; s != ch->tail; s++) {
+        swim_channel_frag_t *f = swim_channel_at(ch, s);
+        if (f->flags & SWIM_CHANNEL_FLAG_LAST) {
+            if (done) done(arg, f->msg_id, false);
+            free(f->msg);
+        }
+        f->msg = NULL;
+    }
+    ch->una = ch->next = ch->tail = 0;
+    ch->peer_window = SWIM_CHANNEL_WINDOW;
+}
+
+/**
+ * Forget the receive stream
+ */
+static void swim_channel_drop_receive(swim_channel_t *ch) {
+    for (uint32_t i = 0; i < SWIM_CHANNEL_WINDOW; i++) {
+        free(ch->slots[i].data);
+        ch->slots[i].data = NULL;
+        ch->slots[i].present = false;
+    }
+    ch->held = 0;
+    ch->expected = 0;
+    ch->partial_len = 0;
+    ch->discarding = false;
+}
+
+/**
+ * Create channel
+ */
+swim_channel_t* swim_channel_create(uint32_t session) {
+    swim_channel_t *ch = (swim_channel_t*)calloc(1, sizeof(swim_channel_t));
+    if (!ch) return NULL;
+
+    ch->session = session;
+    ch->peer_window = SWIM_CHANNEL_WINDOW;
+    ch->next_msg_id = 1;
+    return ch;
+}
+
+/**
+ * Destroy channel
+ */
+void swim_channel_destroy(swim_channel_t *ch, swim_channel_done_cb done, void *arg) {
+    if (!ch) return;
+
+    swim_channel_drop_send(ch, done, arg);
+    swim_channel_drop_receive(ch);
+    free(ch->partial);
+    free(ch);
+}
+
+/**
+ * Restart send session
+ */
+void swim_channel_reset(swim_channel_t *ch, uint32_t session, swim_channel_done_cb done, void *arg) {
+    swim_channel_drop_send(ch, done, arg);
+    ch->session = session;
+}
+
+/**
+ * Queue message
+ */
+int swim_channel_enqueue(swim_channel_t *ch, const uint8_t *data, size_t len, uint32_t frag_size,
+                         uint32_t *msg_id) {
+    if (len > SWIM_CHANNEL_MAX_MESSAGE || frag_size == 0) return -1;
+
+    uint32_t count = len ? (uint32_t)((len + frag_size - 1) / frag_size) : 1;
+    if (ch->tail - ch->una + count > SWIM_CHANNEL_QUEUE) return -1;
+
+    uint8_t *msg = (uint8_t*)malloc(len ? len : 1);
+    if (!msg) return -1;
+    if (len) memcpy(msg, data, len);
+
+    uint32_t id = ch->next_msg_id++;
+    for (uint32_t i = 0; i < count; i++) {
+        swim_channel_frag_t *f = swim_channel_at(ch, ch->tail++);
+        memset(f, 0, sizeof(*f));
+        f->msg = msg;
+        f->offset = i * frag_size;
+        f->len = (uint32_t)(len - f->offset < frag_size ? len - f->offset : frag_size);
+        f->msg_id = id;
+        f->flags = (uint8_t)((i == 0 ? SWIM_CHANNEL_FLAG_FIRST : 0) |
+                             (i == count - 1 ? SWIM_CHANNEL_FLAG_LAST : 0));
+    }
+
+    if (msg_id) *msg_id = id;
+    return 0;
+}
+
+/**
+ * Next fragment to transmit
+ */
+int swim_channel_next(swim_channel_t *ch, uint64_t now_us, uint64_t rto_us, uint32_t *seq) {
+    for (uint32_t s = ch->una; s != ch->next; s++) {
+        swim_channel_frag_t *f = swim_channel_at(ch, s);
+        if (f->sacked) continue;
+        if (!f->lost && now_us < f->sent_us + (rto_us << (f->sends - 1))) continue;
+        if (f->sends >= SWIM_CHANNEL_MAX_RETRIES) return -1;
+
+        f->sends++;
+        f->lost = false;
+        f->sent_us = now_us;
+        *seq = s;
+        return 2;
+    }
+
+    // A closed window still lets one fragment out, to learn when it reopens
+    uint32_t window = ch->peer_window < SWIM_CHANNEL_WINDOW ? ch->peer_window : SWIM_CHANNEL_WINDOW;
+    if (window == 0) window = 1;
+
+    if (ch->next != ch->tail && ch->next - ch->una < window) {
+        swim_channel_frag_t *f = swim_channel_at(ch, ch->next);
+        f->sends = 1;
+        f->sent_us = now_us;
+        *seq = ch->next++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Fragment by sequence number
+ */
+const swim_channel_frag_t* swim_channel_frag(const swim_channel_t *ch, uint32_t seq) {
+    return &ch->frags[seq % SWIM_CHANNEL_QUEUE];
+}
+
+/**
+ * Earliest retransmission deadline
+ */
+uint64_t swim_channel_deadline(const swim_channel_t *ch, uint64_t rto_us) {
+    uint64_t deadline = UINT64_MAX;
+
+    for (uint32_t s = ch->una; s != ch->next; s++) {
+        const swim_channel_frag_t *f = swim_channel_frag(ch, s);
+        if (f->sacked) continue;
+        uint64_t due = f->lost ? f->sent_us : f->sent_us + (rto_us << (f->sends - 1));
+        if (due < deadline) deadline = due;
+    }
+
+    return deadline;
+}
+
+/**
+ * Apply acknowledgement
+ */
+uint64_t swim_channel_on_ack(swim_channel_t *ch, uint32_t session, uint32_t cum, uint32_t window,
+                             uint64_t sack, uint64_t now_us, swim_channel_done_cb done, void *arg) {
+    // Stale session, or a position past anything we sent
+    if (session != ch->session || cum - ch->una > ch->next - ch->una) return 0;
+
+    // A resend among the covered fragments means the ACK waited on it
+    uint64_t rtt_us = 0;
+    bool clean = cum != ch->una;
+    if (clean) {
+        const swim_channel_frag_t *newest = swim_channel_at(ch, cum - 1);
+        if (now_us > newest->sent_us) rtt_us = now_us - newest->sent_us;
+    }
+
+    while (ch->una != cum) {
+        swim_channel_frag_t *f = swim_channel_at(ch, ch->una++);
+        if (f->sends != 1) clean = false;
+        if (f->flags & SWIM_CHANNEL_FLAG_LAST) {
+            if (done) done(arg, f->msg_id, true);
+            free(f->msg);
+        }
+        f->msg = NULL;
+    }
+    ch->peer_window = window;
+
+    for (uint32_t i = 1; i < SWIM_CHANNEL_WINDOW; i++) {
+        uint32_t s = cum + i;
+        if (s - ch->una >= ch->next - ch->una) break;
+        if ((sack >> i) & 1) swim_channel_at(ch, s)->sacked = true;
+    }
+
+    // Sent once and passed by DUP_THRESH SACKed fragments: resend now;
+    // later resends of the same fragment wait for its timeout
+    uint32_t above = 0;
+    for (uint32_t s = ch->next; s != ch->una;) {
+        swim_channel_frag_t *f = swim_channel_at(ch, --s);
+        if (f->sacked) {
+            above++;
+        } else if (above >= SWIM_CHANNEL_DUP_THRESH && f->sends == 1) {
+            f->lost = true;
+        }
+    }
+
+    return clean ? rtt_us : 0;
+}
+
+/**
+ * Append an in-order fragment to the message being reassembled
+ */
+static void swim_channel_accept(swim_channel_t *ch, uint8_t flags, const uint8_t *data, uint32_t len,
+                                swim_channel_deliver_cb deliver, void *arg) {
+    ch->expected++;
+
+    if (flags & SWIM_CHANNEL_FLAG_FIRST) {
+        ch->partial_len = 0;
+        ch->discarding = false;
+    }
+
+    if (!ch->discarding && len > 0) {
+        uint32_t need = ch->partial_len + len;
+        if (need > SWIM_CHANNEL_MAX_MESSAGE) {
+            ch->discarding = true;
+        } else if (need > ch->partial_cap) {
+            uint32_t cap = ch->partial_cap ? ch->partial_cap : 4096;
+            while (cap < need) cap *= 2;
+            uint8_t *buf = (uint8_t*)realloc(ch->partial, cap);
+            if (buf) {
+                ch->partial = buf;
+                ch->partial_cap = cap;
+            } else {
+                ch->discarding = true;
+            }
+        }
+        if (!ch->discarding) {
+            memcpy(ch->partial + ch->partial_len, data, len);
+            ch->partial_len = need;
+        }
+    }
+
+    if (flags & SWIM_CHANNEL_FLAG_LAST) {
+        if (!ch->discarding) deliver(arg, ch->partial, ch->partial_len);
+        ch->partial_len = 0;
+        ch->discarding = false;
+    }
+}
+
+/**
+ * Accept fragment
+ */
+void swim_channel_on_data(swim_channel_t *ch, uint32_t session, uint32_t seq, uint8_t flags,
+                          const uint8_t *data, uint32_t len, swim_channel_deliver_cb deliver, void *arg) {
+    if (session != ch->peer_session) {
+        swim_channel_drop_receive(ch);
+        ch->peer_session = session;
+    }
+    ch->ack_pending = true;
+
+    // Duplicates wrap to large distances too
+    uint32_t distance = seq - ch->expected;
+    if (distance >= SWIM_CHANNEL_WINDOW) return;
+
+    if (distance > 0) {
+        swim_channel_slot_t *slot = &ch->slots[seq % SWIM_CHANNEL_WINDOW];
+        if (slot->present) return;
+        slot->data = (uint8_t*)malloc(len ? len : 1);
+        if (!slot->data) return;
+        if (len) memcpy(slot->data, data, len);
+        slot->seq = seq;
+        slot->len = len;
+        slot->flags = flags;
+        slot->present = true;
+        ch->held++;
+        return;
+    }
+
+    swim_channel_accept(ch, flags, data, len, deliver, arg);
+
+    // Held fragments that are now in order
+    for (;;) {
+        swim_channel_slot_t *slot = &ch->slots[ch->expected % SWIM_CHANNEL_WINDOW];
+        if (!slot->present || slot->seq != ch->expected) break;
+        swim_channel_accept(ch, slot->flags, slot->data, slot->len, deliver, arg);
+        free(slot->data);
+        slot->data = NULL;
+        slot->present = false;
+        ch->held--;
+    }
+}
+
+/**
+ * Acknowledgement for the receive side
+ */
+void swim_channel_ack_state(const swim_channel_t *ch, uint32_t *cum, uint32_t *window, uint64_t *sack) {
+    *cum = ch->expected;
+    *window = SWIM_CHANNEL_WINDOW - ch->held;
+    *sack = 0;
+
+    for (uint32_t i = 1; i < SWIM_CHANNEL_WINDOW; i++) {
+        const swim_channel_slot_t *slot = &ch->slots[(ch->expected + i) % SWIM_CHANNEL_WINDOW];
+        if (slot->present && slot->seq == ch->expected + i) *sack |= (uint64_t)1 << i;
+    }
+}
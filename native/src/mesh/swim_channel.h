@@ -0,0 +1,158 @@
+/**
+ * LSDAMM - SWIM Reliable Channel Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Per-peer reliable, ordered message stream carried in SWIM datagrams.
+ * Messages are cut into fragments numbered consecutively within a session;
+ * the receiver reassembles them in order and answers with its cumulative
+ * position, free window and a selective-acknowledgement bitmap of the
+ * out-of-order fragments it holds.
+ *
+ * The sender keeps at most min(SWIM_CHANNEL_WINDOW, advertised window)
+ * fragments in flight (one when the window is closed, as a probe), resends
+ * a fragment when its retransmission timeout (the peer's probe timeout,
+ * doubled per retry) passes, and immediately once SWIM_CHANNEL_DUP_THRESH
+ * later fragments have been selectively acknowledged.
+ *
+ * Pure state machine: encoding, sending and timers belong to the caller.
+ *
+ * References: RFC 2018 (TCP selective acknowledgements), RFC 6675 (loss
+ * recovery with SACK)
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_CHANNEL_H
+#define SWIM_CHANNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SWIM_CHANNEL_WINDOW         64      // Fragments in flight / held out of order (SACK width)
+#define SWIM_CHANNEL_QUEUE          1024    // Fragments queued per peer, sent or not
+#define SWIM_CHANNEL_MAX_MESSAGE    (256 * 1024)
+#define SWIM_CHANNEL_MAX_RETRIES    8       // Sends of one fragment before the session fails
+#define SWIM_CHANNEL_DUP_THRESH     3       // Later fragments SACKed before a resend
+
+#define SWIM_CHANNEL_FLAG_FIRST     0x01
+#define SWIM_CHANNEL_FLAG_LAST      0x02
+
+// Queued fragment (a slice of a message buffer shared by its fragments)
+typedef struct {
+    uint8_t *msg;               // Freed when the LAST fragment is acknowledged
+    uint32_t offset;
+    uint32_t len;
+    uint32_t msg_id;
+    uint8_t flags;
+    uint8_t sends;
+    bool sacked;
+    bool lost;                  // Resend without waiting for the timeout
+    uint64_t sent_us;           // Last transmission
+} swim_channel_frag_t;
+
+// Out-of-order fragment held by the receiver
+typedef struct {
+    uint8_t *data;
+    uint32_t seq;
+    uint32_t len;
+    uint8_t flags;
+    bool present;
+} swim_channel_slot_t;
+
+typedef struct swim_channel {
+    // Send side: fragments [una, next) are in flight, [next, tail) unsent
+    uint32_t session;
+    uint32_t una;
+    uint32_t next;
+    uint32_t tail;
+    uint32_t peer_window;
+    uint32_t next_msg_id;
+    swim_channel_frag_t frags[SWIM_CHANNEL_QUEUE];
+
+    // Receive side
+    uint32_t peer_session;
+    uint32_t expected;          // Next in-order fragment
+    uint32_t held;
+    swim_channel_slot_t slots[SWIM_CHANNEL_WINDOW];
+    uint8_t *partial;           // Message being reassembled
+    uint32_t partial_len;
+    uint32_t partial_cap;
+    bool discarding;            // Oversized message: skip to the next FIRST fragment
+    bool ack_pending;
+} swim_channel_t;
+
+// Message outcome (delivered false when the session failed first)
+typedef void (*swim_channel_done_cb)(void *arg, uint32_t msg_id, bool delivered);
+
+// Reassembled message, in order
+typedef void (*swim_channel_deliver_cb)(void *arg, const uint8_t *msg, size_t len);
+
+/**
+ * Create a channel
+ * @param session Random nonzero id for our send stream
+ * @return Channel, or NULL on allocation failure
+ */
+swim_channel_t* swim_channel_create(uint32_t session);
+
+/**
+ * Free a channel; messages not yet acknowledged are reported undelivered
+ * @param done May be NULL
+ */
+void swim_channel_destroy(swim_channel_t *ch, swim_channel_done_cb done, void *arg);
+
+/**
+ * Fail every queued message and start a new send session (receive state kept)
+ */
+void swim_channel_reset(swim_channel_t *ch, uint32_t session, swim_channel_done_cb done, void *arg);
+
+/**
+ * Copy a message into the send queue, cut into frag_size fragments
+ * @param msg_id Set to the message id reported to done (may be NULL)
+ * @return 0 on success, -1 if too large, the queue lacks room, or out of memory
+ */
+int swim_channel_enqueue(swim_channel_t *ch, const uint8_t *data, size_t len, uint32_t frag_size,
+                         uint32_t *msg_id);
+
+/**
+ * Pick the next fragment to transmit: a lost or timed-out one first, then
+ * a new one if the window allows. The fragment is marked sent at now_us.
+ * @param rto_us Retransmission timeout for a first resend
+ * @return 1 for a new fragment, 2 for a resend, 0 if none, -1 if a fragment
+ *         ran out of retries (reset the session)
+ */
+int swim_channel_next(swim_channel_t *ch, uint64_t now_us, uint64_t rto_us, uint32_t *seq);
+
+/**
+ * Fragment by sequence number (valid for [una, tail))
+ */
+const swim_channel_frag_t* swim_channel_frag(const swim_channel_t *ch, uint32_t seq);
+
+/**
+ * Earliest retransmission deadline (us), UINT64_MAX if nothing is in flight
+ */
+uint64_t swim_channel_deadline(const swim_channel_t *ch, uint64_t rto_us);
+
+/**
+ * Apply an acknowledgement: frees fragments before cum, marks SACKed ones
+ * and those to resend early, and reports completed messages to done
+ * @param sack Bit i: fragment cum + i is held by the receiver
+ * @return Round trip (us) of the newest fragment it covers, or 0 when any
+ *         covered fragment was resent (the ACK may have waited on it)
+ */
+uint64_t swim_channel_on_ack(swim_channel_t *ch, uint32_t session, uint32_t cum, uint32_t window,
+                             uint64_t sack, uint64_t now_us, swim_channel_done_cb done, void *arg);
+
+/**
+ * Accept a fragment; complete messages go to deliver in order. A new peer
+ * session restarts the receive stream.
+ */
+void swim_channel_on_data(swim_channel_t *ch, uint32_t session, uint32_t seq, uint8_t flags,
+                          const uint8_t *data, uint32_t len, swim_channel_deliver_cb deliver, void *arg);
+
+/**
+ * Acknowledgement to send for the receive side
+ */
+void swim_channel_ack_state(const swim_channel_t *ch, uint32_t *cum, uint32_t *window, uint64_t *sack);
+
+#endif // SWIM_CHANNEL_H
@@ -0,0 +1,112 @@
+/**
+ * LSDAMM - SWIM Network Coordinates Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_coord.h"
+#include <math.h>
+
+#define SWIM_COORD_EPSILON      1.0e-6
+
+/**
+ * Initialize coordinate
+ */
+void swim_coord_init(swim_coord_t *coord) {
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        coord->vec[i] = 0.0f;
+    }
+    coord->height = SWIM_COORD_HEIGHT_MIN;
+    coord->error = SWIM_COORD_ERROR_MAX;
+}
+
+/**
+ * Validate coordinate
+ */
+bool swim_coord_valid(const swim_coord_t *coord) {
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        if (!isfinite(coord->vec[i])) return false;
+    }
+    return isfinite(coord->height) && coord->height >= 0.0f &&
+           isfinite(coord->error) && coord->error >= 0.0f && coord->error <= SWIM_COORD_ERROR_MAX;
+}
+
+/**
+ * Euclidean distance plus both heights
+ */
+double swim_coord_distance_ms(const swim_coord_t *a, const swim_coord_t *b) {
+    double sum = 0;
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        double d = (double)a->vec[i] - b->vec[i];
+        sum += d * d;
+    }
+    return sqrt(sum) + a->height + b->height;
+}
+
+/**
+ * Unit vector from b to a; a random direction if they coincide
+ * @return Distance between the points (0 if they coincide)
+ */
+static double swim_coord_unit(const swim_coord_t *a, const swim_coord_t *b, double *unit, uint64_t random) {
+    double mag = 0;
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        unit[i] = (double)a->vec[i] - b->vec[i];
+        mag += unit[i] * unit[i];
+    }
+    mag = sqrt(mag);
+
+    if (mag > SWIM_COORD_EPSILON) {
+        for (int i = 0; i < SWIM_COORD_DIM; i++) unit[i] /= mag;
+        return mag;
+    }
+
+    // Eight bits of random per axis, centred on zero
+    double norm = 0;
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        unit[i] = (double)((random >> (i * 8)) & 0xFF) - 127.5;
+        norm += unit[i] * unit[i];
+    }
+    norm = sqrt(norm);
+    for (int i = 0; i < SWIM_COORD_DIM; i++) unit[i] /= norm;
+    return 0;
+}
+
+/**
+ * Vivaldi update with adaptive timestep
+ */
+bool swim_coord_update(swim_coord_t *local, const swim_coord_t *remote, double rtt_ms, uint64_t random) {
+    if (!(rtt_ms > 0) || rtt_ms > SWIM_COORD_RTT_MAX_MS || !swim_coord_valid(remote)) return false;
+    if (rtt_ms < SWIM_COORD_EPSILON) rtt_ms = SWIM_COORD_EPSILON;
+
+    double dist = swim_coord_distance_ms(local, remote);
+    double wrongness = fabs(dist - rtt_ms) / rtt_ms;
+
+    // Trust the sample in proportion to how uncertain we are relative to the remote
+    double total_error = (double)local->error + remote->error;
+    if (total_error < SWIM_COORD_EPSILON) total_error = SWIM_COORD_EPSILON;
+    double weight = local->error / total_error;
+
+    double error = SWIM_COORD_CE * weight * wrongness + local->error * (1.0 - SWIM_COORD_CE * weight);
+    local->error = (float)(error > SWIM_COORD_ERROR_MAX ? SWIM_COORD_ERROR_MAX : error);
+
+    // Spring force: positive pushes away (too close), negative pulls in
+    double force = SWIM_COORD_CC * weight * (rtt_ms - dist);
+    double unit[SWIM_COORD_DIM];
+    double mag = swim_coord_unit(local, remote, unit, random);
+
+    for (int i = 0; i < SWIM_COORD_DIM; i++) {
+        local->vec[i] = (float)(local->vec[i] + unit[i] * force);
+    }
+    if (mag > SWIM_COORD_EPSILON) {
+        double height = ((double)local->height + remote->height) * force / mag + local->height;
+        local->height = (float)(height < SWIM_COORD_HEIGHT_MIN ? SWIM_COORD_HEIGHT_MIN : height);
+    }
+
+    // Never let one bad sample poison the coordinate for good
+    if (!swim_coord_valid(local)) {
+        swim_coord_init(local);
+        return false;
+    }
+    return true;
+}
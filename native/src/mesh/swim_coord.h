@@ -0,0 +1,62 @@
+/**
+ * LSDAMM - SWIM Network Coordinates Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Vivaldi synthetic coordinates: every member holds a point in a small
+ * Euclidean space plus a height (its access-link delay). Each measured
+ * PING -> ACK round trip pulls the local point toward or away from the
+ * responder's advertised point, so after a few rounds the distance between
+ * any two members' coordinates predicts their RTT without them ever
+ * having probed each other. The error term weights updates: a confident
+ * node moves little when it hears from an uncertain one.
+ *
+ * Reference: Dabek et al., "Vivaldi: A Decentralized Network Coordinate
+ * System" (SIGCOMM 2004); Ledlie et al., "Network Coordinates in the
+ * Wild" (NSDI 2007) for the height vector.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_COORD_H
+#define SWIM_COORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SWIM_COORD_DIM          8       // Euclidean dimensions
+#define SWIM_COORD_ERROR_MAX    1.5f    // Error of a fresh coordinate
+#define SWIM_COORD_HEIGHT_MIN   0.01f   // ms
+#define SWIM_COORD_CE           0.25f   // Error adaptation gain
+#define SWIM_COORD_CC           0.25f   // Movement gain
+#define SWIM_COORD_RTT_MAX_MS   10000.0 // Larger samples are discarded
+
+// Coordinate (all distances in ms)
+typedef struct {
+    float vec[SWIM_COORD_DIM];
+    float height;
+    float error;                // Relative prediction error, 0 to SWIM_COORD_ERROR_MAX
+} swim_coord_t;
+
+/**
+ * Fresh coordinate: origin, minimum height, maximum error
+ */
+void swim_coord_init(swim_coord_t *coord);
+
+/**
+ * True if every component is finite and in range (remote input check)
+ */
+bool swim_coord_valid(const swim_coord_t *coord);
+
+/**
+ * Predicted RTT between two coordinates (ms)
+ */
+double swim_coord_distance_ms(const swim_coord_t *a, const swim_coord_t *b);
+
+/**
+ * Move local after measuring rtt_ms to a member advertising remote.
+ * random picks the push direction when both points coincide.
+ * @return false if the sample was rejected
+ */
+bool swim_coord_update(swim_coord_t *local, const swim_coord_t *remote, double rtt_ms, uint64_t random);
+
+#endif // SWIM_COORD_H
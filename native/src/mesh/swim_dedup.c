@@ -0,0 +1,75 @@
+/**
+ * LSDAMM - SWIM Duplicate Filter Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_dedup.h"
+#include <string.h>
+
+/**
+ * Mix a key into 64 well-spread bits (splitmix64 finalizer)
+ */
+static uint64_t swim_dedup_hash(uint32_t sender_hash, uint32_t seq, uint8_t type) {
+    uint64_t x = ((uint64_t)sender_hash << 32 | seq) ^ ((uint64_t)type << 56) ^ type;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Whether every bit of a key is set in one filter
+ */
+static bool swim_dedup_test(const uint64_t *bits, uint32_t h1, uint32_t h2) {
+    for (uint32_t i = 0; i < SWIM_DEDUP_HASHES; i++) {
+        uint32_t bit = (h1 + i * h2) & (SWIM_DEDUP_BITS - 1);
+        if (!(bits[bit / 64] & (1ull << (bit % 64)))) return false;
+    }
+    return true;
+}
+
+/**
+ * Initialize
+ */
+void swim_dedup_init(swim_dedup_t *dedup, uint64_t now_ms) {
+    memset(dedup, 0, sizeof(*dedup));
+    dedup->rotated_ms = now_ms;
+}
+
+/**
+ * Look up and remember a key
+ */
+bool swim_dedup_seen(swim_dedup_t *dedup, uint32_t sender_hash, uint32_t seq, uint8_t type,
+                     uint64_t now_ms) {
+    if (dedup->count >= SWIM_DEDUP_CAPACITY || now_ms - dedup->rotated_ms >= SWIM_DEDUP_WINDOW_MS) {
+        // After a quiet spell the older filter is out of the window too
+        if (now_ms - dedup->rotated_ms >= 2 * SWIM_DEDUP_WINDOW_MS) {
+            memset(dedup->bits[dedup->current], 0, sizeof(dedup->bits[0]));
+        }
+        dedup->current ^= 1;
+        memset(dedup->bits[dedup->current], 0, sizeof(dedup->bits[0]));
+        dedup->count = 0;
+        dedup->rotated_ms = now_ms;
+    }
+
+    // Double hashing: probe i is h1 + i*h2, with h2 odd so the probes differ
+    uint64_t h = swim_dedup_hash(sender_hash, seq, type);
+    uint32_t h1 = (uint32_t)h;
+    uint32_t h2 = (uint32_t)(h >> 32) | 1;
+
+    uint64_t *bits = dedup->bits[dedup->current];
+    if (swim_dedup_test(bits, h1, h2) || swim_dedup_test(dedup->bits[dedup->current ^ 1], h1, h2)) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < SWIM_DEDUP_HASHES; i++) {
+        uint32_t bit = (h1 + i * h2) & (SWIM_DEDUP_BITS - 1);
+        bits[bit / 64] |= 1ull << (bit % 64);
+    }
+    dedup->count++;
+    return false;
+}
@@ -0,0 +1,55 @@
+/**
+ * LSDAMM - SWIM Duplicate Filter Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Remembers the (sender, seq, type) keys of recently received messages so
+ * an exact copy - the network duplicating a datagram, or a peer replaying
+ * one - is dropped as soon as its header is read.
+ *
+ * Two Bloom filters: keys go into the current one and are looked up in
+ * both. The older one is cleared and becomes current when the window has
+ * passed or the current one holds SWIM_DEDUP_CAPACITY keys, so a key is
+ * remembered for one to two windows (less under heavy traffic). At the
+ * capacity the false positive rate is about (1 - e^(-k*n/m))^k = 4e-8 per
+ * filter; a false positive drops a message that was never seen.
+ *
+ * Pure state: the caller supplies the clock.
+ *
+ * Reference: Bloom, "Space/Time Trade-offs in Hash Coding with Allowable
+ * Errors" (CACM 1970)
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_DEDUP_H
+#define SWIM_DEDUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SWIM_DEDUP_BITS         (1u << 17)  // Bits per filter (16 KB)
+#define SWIM_DEDUP_HASHES       8           // Bits set per key
+#define SWIM_DEDUP_CAPACITY     2048        // Keys per filter before it rotates
+#define SWIM_DEDUP_WINDOW_MS    1000        // Rotation period when traffic is light
+
+typedef struct {
+    uint64_t bits[2][SWIM_DEDUP_BITS / 64];
+    uint32_t current;           // Filter keys are added to
+    uint32_t count;             // Keys added to it
+    uint64_t rotated_ms;        // When it became current
+} swim_dedup_t;
+
+/**
+ * Initialize (empty)
+ */
+void swim_dedup_init(swim_dedup_t *dedup, uint64_t now_ms);
+
+/**
+ * Look a message key up and remember it
+ * @param sender_hash swim_hash_id of the sender
+ * @return true if the key was seen within the window (a duplicate)
+ */
+bool swim_dedup_seen(swim_dedup_t *dedup, uint32_t sender_hash, uint32_t seq, uint8_t type,
+                     uint64_t now_ms);
+
+#endif // SWIM_DEDUP_H
@@ -0,0 +1,232 @@
+/**
+ * LSDAMM - SWIM Failure Detector Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_detector.h"
+#include "swim_gossip.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ * STATIC: fixed timeouts
+ */
+
+static const swim_detector_ops_t swim_detector_static_ops = {
+    "static", NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+/*
+ * LIFEGUARD: local health awareness and confirmation-driven suspicion
+ */
+
+/**
+ * Probe timing stretches with local health (a slow node waits longer)
+ */
+static uint32_t swim_lifeguard_scale(const swim_detector_t *det, uint32_t base_ms) {
+    return base_ms * (det->health + 1);
+}
+
+/**
+ * A successful probe is evidence this node is keeping up
+ */
+static void swim_lifeguard_on_ack(swim_detector_t *det, struct swim_node *node, double rtt_ms) {
+    (void)node;
+    (void)rtt_ms;
+    if (det->health > 0) det->health--;
+}
+
+/**
+ * A failed probe may be our own fault (CPU starvation, lost packets)
+ */
+static void swim_lifeguard_on_probe_failed(swim_detector_t *det, struct swim_node *node) {
+    (void)node;
+    if (det->health < SWIM_LIFEGUARD_MAX_HEALTH) det->health++;
+}
+
+/**
+ * Others suspecting us means we are not answering in time
+ */
+static void swim_lifeguard_on_refute(swim_detector_t *det) {
+    if (det->health < SWIM_LIFEGUARD_MAX_HEALTH) det->health++;
+}
+
+/**
+ * Suspicion timeout: max(min, max - (max - min) * log(C + 1) / log(K + 1))
+ * with min = base * max(1, log10 n), max = SWIM_LIFEGUARD_MAX_MULT * min,
+ * and K expected confirmations (fewer in tiny clusters).
+ */
+static uint32_t swim_lifeguard_suspect_timeout(const swim_detector_t *det, uint32_t member_count,
+                                               uint32_t confirmations) {
+    double node_scale = member_count > 10 ? log10((double)member_count) : 1.0;
+    double min_ms = (double)det->suspect_timeout_ms * node_scale;
+    double max_ms = min_ms * SWIM_LIFEGUARD_MAX_MULT;
+
+    uint32_t expected = member_count > 2 ? member_count - 2 : 0;
+    if (expected > SWIM_LIFEGUARD_CONFIRMATIONS) expected = SWIM_LIFEGUARD_CONFIRMATIONS;
+    if (expected == 0) return (uint32_t)min_ms;
+
+    double frac = log((double)confirmations + 1.0) / log((double)expected + 1.0);
+    double timeout = max_ms - frac * (max_ms - min_ms);
+    return (uint32_t)(timeout < min_ms ? min_ms : timeout);
+}
+
+static const swim_detector_ops_t swim_detector_lifeguard_ops = {
+    "lifeguard",
+    swim_lifeguard_scale,
+    swim_lifeguard_on_ack,
+    swim_lifeguard_on_probe_failed,
+    swim_lifeguard_on_refute,
+    NULL,
+    swim_lifeguard_suspect_timeout
+};
+
+/*
+ * PHI: accrual over per-member ACK delays
+ */
+
+/**
+ * Record delay for later phi evaluation
+ */
+static void swim_phi_on_ack(swim_detector_t *det, struct swim_node *node, double rtt_ms) {
+    (void)det;
+    swim_detector_record_ack(&node->detector, rtt_ms);
+}
+
+/**
+ * Keep the probe open while its delay is still plausible for this member
+ */
+static uint32_t swim_phi_grace(const swim_detector_t *det, const struct swim_node *node, uint32_t elapsed_ms) {
+    uint32_t max_wait = det->probe_timeout_ms * 2 * SWIM_PHI_MAX_WAIT_MULT;
+    if (elapsed_ms >= max_wait) return 0;
+    if (swim_detector_phi(&node->detector, (double)elapsed_ms) >= det->phi_threshold) return 0;
+
+    // Re-evaluate in quarter-timeout steps
+    uint32_t step = det->probe_timeout_ms / 4 ? det->probe_timeout_ms / 4 : 1;
+    return elapsed_ms + step > max_wait ? max_wait - elapsed_ms : step;
+}
+
+static const swim_detector_ops_t swim_detector_phi_ops = {
+    "phi-accrual",
+    NULL,
+    swim_phi_on_ack,
+    NULL,
+    NULL,
+    swim_phi_grace,
+    NULL
+};
+
+/**
+ * Initialize detector
+ */
+void swim_detector_init(swim_detector_t *det, swim_detector_mode_t mode,
+                        uint32_t probe_timeout_ms, uint32_t suspect_timeout_ms) {
+    memset(det, 0, sizeof(*det));
+    det->ops = swim_detector_builtin(mode);
+    det->probe_timeout_ms = probe_timeout_ms;
+    det->suspect_timeout_ms = suspect_timeout_ms;
+    det->phi_threshold = SWIM_PHI_THRESHOLD;
+}
+
+/**
+ * Built-in policy lookup
+ */
+const swim_detector_ops_t* swim_detector_builtin(swim_detector_mode_t mode) {
+    switch (mode) {
+        case SWIM_DETECTOR_LIFEGUARD: return &swim_detector_lifeguard_ops;
+        case SWIM_DETECTOR_PHI:       return &swim_detector_phi_ops;
+        default:                      return &swim_detector_static_ops;
+    }
+}
+
+/**
+ * Policy dispatch
+ */
+uint32_t swim_detector_scale(const swim_detector_t *det, uint32_t base_ms) {
+    return det->ops->scale ? det->ops->scale(det, base_ms) : base_ms;
+}
+
+void swim_detector_on_ack(swim_detector_t *det, struct swim_node *node, double rtt_ms) {
+    if (det->ops->on_ack) det->ops->on_ack(det, node, rtt_ms);
+}
+
+void swim_detector_on_probe_failed(swim_detector_t *det, struct swim_node *node) {
+    if (det->ops->on_probe_failed) det->ops->on_probe_failed(det, node);
+}
+
+void swim_detector_on_refute(swim_detector_t *det) {
+    if (det->ops->on_refute) det->ops->on_refute(det);
+}
+
+uint32_t swim_detector_grace(const swim_detector_t *det, const struct swim_node *node, uint32_t elapsed_ms) {
+    return det->ops->grace ? det->ops->grace(det, node, elapsed_ms) : 0;
+}
+
+uint32_t swim_detector_suspect_timeout(const swim_detector_t *det, uint32_t member_count, uint32_t confirmations) {
+    if (det->ops->suspect_timeout) {
+        return det->ops->suspect_timeout(det, member_count, confirmations);
+    }
+    return det->suspect_timeout_ms;
+}
+
+/**
+ * Start tracking a suspicion
+ */
+void swim_detector_suspect(swim_detector_node_t *state, uint32_t accuser_hash) {
+    memset(state->accusers, 0, sizeof(state->accusers));
+    state->accusers[0] = accuser_hash;
+    state->confirmations = 0;
+}
+
+/**
+ * Record another accuser
+ */
+bool swim_detector_confirm(swim_detector_node_t *state, uint32_t accuser_hash) {
+    if (state->confirmations >= SWIM_LIFEGUARD_CONFIRMATIONS) return false;
+
+    for (uint32_t i = 0; i <= state->confirmations; i++) {
+        if (state->accusers[i] == accuser_hash) return false;
+    }
+
+    state->accusers[++state->confirmations] = accuser_hash;
+    return true;
+}
+
+/**
+ * Record ACK delay sample
+ */
+void swim_detector_record_ack(swim_detector_node_t *state, double rtt_ms) {
+    state->ack_ms[state->ack_next] = (float)rtt_ms;
+    state->ack_next = (uint8_t)((state->ack_next + 1) % SWIM_PHI_WINDOW);
+    if (state->ack_count < SWIM_PHI_WINDOW) state->ack_count++;
+}
+
+/**
+ * Phi for a probe outstanding elapsed_ms: -log10(P(delay > elapsed)),
+ * using the logistic approximation of the normal CDF
+ */
+double swim_detector_phi(const swim_detector_node_t *state, double elapsed_ms) {
+    // Too little history: treat any timeout as conclusive
+    if (state->ack_count < SWIM_PHI_MIN_SAMPLES) return INFINITY;
+
+    double sum = 0, sum_sq = 0;
+    for (uint32_t i = 0; i < state->ack_count; i++) {
+        sum += state->ack_ms[i];
+        sum_sq += (double)state->ack_ms[i] * state->ack_ms[i];
+    }
+
+    double mean = sum / state->ack_count;
+    double variance = sum_sq / state->ack_count - mean * mean;
+    double std = variance > 0 ? sqrt(variance) : 0;
+    if (std < SWIM_PHI_MIN_STD_MS) std = SWIM_PHI_MIN_STD_MS;
+
+    double y = (elapsed_ms - mean) / std;
+    double e = exp(-y * (1.5976 + 0.070566 * y * y));
+
+    if (elapsed_ms > mean) {
+        return -log10(e / (1.0 + e));
+    }
+    return -log10(1.0 - 1.0 / (1.0 + e));
+}
@@ -0,0 +1,123 @@
+/**
+ * LSDAMM - SWIM Failure Detector Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Pluggable policy deciding how long to wait for probes and suspicions:
+ *
+ *   STATIC     Fixed probe and suspicion timeouts (original behaviour).
+ *   LIFEGUARD  Local health multiplier scales probe timing while this node
+ *              is struggling; suspicion timeouts start long and shrink as
+ *              independent confirmations arrive.
+ *   PHI        Phi-accrual over each member's observed ACK delays: a probe
+ *              is only failed once the wait is improbable for that member.
+ *
+ * Reference: Dadgar et al., "Lifeguard: Local Health Awareness for More
+ * Accurate Failure Detection" (2018); Hayashibara et al., "The phi Accrual
+ * Failure Detector" (2004).
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_DETECTOR_H
+#define SWIM_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct swim_node;
+
+#define SWIM_LIFEGUARD_MAX_HEALTH       8     // Local health multiplier cap
+#define SWIM_LIFEGUARD_CONFIRMATIONS    3     // Confirmations for the minimum suspicion timeout
+#define SWIM_LIFEGUARD_MAX_MULT         6     // Max suspicion timeout, in multiples of the minimum
+
+#define SWIM_PHI_THRESHOLD              8.0
+#define SWIM_PHI_WINDOW                 16    // ACK delay samples kept per member
+#define SWIM_PHI_MIN_SAMPLES            4     // Below this, behave like STATIC
+#define SWIM_PHI_MIN_STD_MS             100.0
+#define SWIM_PHI_MAX_WAIT_MULT          4     // Longest probe wait, in probe windows
+
+typedef enum {
+    SWIM_DETECTOR_STATIC = 0,
+    SWIM_DETECTOR_LIFEGUARD,
+    SWIM_DETECTOR_PHI
+} swim_detector_mode_t;
+
+// Per-member detector state (embedded in swim_node_t)
+typedef struct {
+    float ack_ms[SWIM_PHI_WINDOW];  // Recent PING -> ACK delays
+    uint8_t ack_count;
+    uint8_t ack_next;
+    uint8_t confirmations;          // Independent suspicions beyond the first
+    uint32_t accusers[SWIM_LIFEGUARD_CONFIRMATIONS + 1];   // Accuser ID hashes
+} swim_detector_node_t;
+
+typedef struct swim_detector swim_detector_t;
+
+// Detector policy. Any hook may be NULL to keep the STATIC behaviour.
+typedef struct {
+    const char *name;
+    // Scale protocol period and probe timeout (ms)
+    uint32_t (*scale)(const swim_detector_t *det, uint32_t base_ms);
+    // Direct ACK received after rtt_ms
+    void (*on_ack)(swim_detector_t *det, struct swim_node *node, double rtt_ms);
+    // Probe window closed without any ACK
+    void (*on_probe_failed)(swim_detector_t *det, struct swim_node *node);
+    // This node refuted a suspicion about itself
+    void (*on_refute)(swim_detector_t *det);
+    // Extra wait before failing a probe that has been outstanding elapsed_ms (0 = fail now)
+    uint32_t (*grace)(const swim_detector_t *det, const struct swim_node *node, uint32_t elapsed_ms);
+    // Suspicion timeout given cluster size and independent confirmations
+    uint32_t (*suspect_timeout)(const swim_detector_t *det, uint32_t member_count, uint32_t confirmations);
+} swim_detector_ops_t;
+
+struct swim_detector {
+    const swim_detector_ops_t *ops;
+    uint32_t probe_timeout_ms;      // Base direct-probe timeout
+    uint32_t suspect_timeout_ms;    // Base (minimum) suspicion timeout
+    uint32_t health;                // Lifeguard local health multiplier (0 = healthy)
+    double phi_threshold;
+};
+
+/**
+ * Initialize detector with a built-in policy
+ */
+void swim_detector_init(swim_detector_t *det, swim_detector_mode_t mode,
+                        uint32_t probe_timeout_ms, uint32_t suspect_timeout_ms);
+
+/**
+ * Built-in policy for a mode
+ */
+const swim_detector_ops_t* swim_detector_builtin(swim_detector_mode_t mode);
+
+/**
+ * Policy dispatch (NULL hooks fall back to STATIC)
+ */
+uint32_t swim_detector_scale(const swim_detector_t *det, uint32_t base_ms);
+void swim_detector_on_ack(swim_detector_t *det, struct swim_node *node, double rtt_ms);
+void swim_detector_on_probe_failed(swim_detector_t *det, struct swim_node *node);
+void swim_detector_on_refute(swim_detector_t *det);
+uint32_t swim_detector_grace(const swim_detector_t *det, const struct swim_node *node, uint32_t elapsed_ms);
+uint32_t swim_detector_suspect_timeout(const swim_detector_t *det, uint32_t member_count, uint32_t confirmations);
+
+/**
+ * Start tracking a new suspicion raised by accuser
+ */
+void swim_detector_suspect(swim_detector_node_t *state, uint32_t accuser_hash);
+
+/**
+ * Record another accuser of an ongoing suspicion
+ * @return true if it is a new, independent confirmation
+ */
+bool swim_detector_confirm(swim_detector_node_t *state, uint32_t accuser_hash);
+
+/**
+ * Record an ACK delay sample
+ */
+void swim_detector_record_ack(swim_detector_node_t *state, double rtt_ms);
+
+/**
+ * Suspicion level for a probe outstanding elapsed_ms (phi-accrual)
+ */
+double swim_detector_phi(const swim_detector_node_t *state, double elapsed_ms);
+
+#endif // SWIM_DETECTOR_H
@@ -0,0 +1,133 @@
+/**
+ * LSDAMM - SWIM Dissemination Queue Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_dissem.h"
+#include "swim_gossip.h"
+#include <string.h>
+
+/**
+ * Link node at the front of its transmit bucket
+ */
+static void swim_dissem_link(swim_dissem_t *dissem, swim_node_t *node) {
+    swim_node_t **head = &dissem->buckets[node->dissem.transmits];
+    node->dissem.prev = NULL;
+    node->dissem.next = *head;
+    if (*head) (*head)->dissem.prev = node;
+    *head = node;
+}
+
+/**
+ * Unlink node from its transmit bucket
+ */
+static void swim_dissem_unlink(swim_dissem_t *dissem, swim_node_t *node) {
+    if (node->dissem.prev) {
+        node->dissem.prev->dissem.next = node->dissem.next;
+    } else {
+        dissem->buckets[node->dissem.transmits] = node->dissem.next;
+    }
+    if (node->dissem.next) {
+        node->dissem.next->dissem.prev = node->dissem.prev;
+    }
+    node->dissem.prev = NULL;
+    node->dissem.next = NULL;
+}
+
+/**
+ * Initialize queue
+ */
+void swim_dissem_init(swim_dissem_t *dissem, uint32_t retransmit_mult) {
+    memset(dissem, 0, sizeof(*dissem));
+    dissem->retransmit_mult = retransmit_mult ? retransmit_mult : SWIM_RETRANSMIT_MULT;
+}
+
+/**
+ * Drop all queued updates
+ */
+void swim_dissem_clear(swim_dissem_t *dissem) {
+    for (uint32_t b = 0; b < SWIM_DISSEM_MAX_TRANSMITS; b++) {
+        swim_node_t *node = dissem->buckets[b];
+        while (node) {
+            swim_node_t *next = node->dissem.next;
+            memset(&node->dissem, 0, sizeof(node->dissem));
+            node = next;
+        }
+        dissem->buckets[b] = NULL;
+    }
+    dissem->count = 0;
+}
+
+/**
+ * Queue node state for dissemination
+ */
+void swim_dissem_enqueue(swim_dissem_t *dissem, swim_node_t *node) {
+    if (node->dissem.queued) {
+        swim_dissem_unlink(dissem, node);
+    } else {
+        node->dissem.queued = true;
+        dissem->count++;
+    }
+
+    node->dissem.transmits = 0;
+    swim_dissem_link(dissem, node);
+}
+
+/**
+ * Remove pending update
+ */
+void swim_dissem_remove(swim_dissem_t *dissem, swim_node_t *node) {
+    if (!node->dissem.queued) return;
+
+    swim_dissem_unlink(dissem, node);
+    node->dissem.queued = false;
+    node->dissem.transmits = 0;
+    dissem->count--;
+}
+
+/**
+ * Retransmit limit: lambda * ceil(log10(n + 1))
+ */
+uint32_t swim_dissem_limit(const swim_dissem_t *dissem, uint32_t member_count) {
+    uint32_t log_n = 1;
+    for (uint32_t n = member_count + 1; n > 10; n = (n + 9) / 10) {
+        log_n++;
+    }
+
+    uint32_t limit = dissem->retransmit_mult * log_n;
+    return limit < SWIM_DISSEM_MAX_TRANSMITS ? limit : SWIM_DISSEM_MAX_TRANSMITS;
+}
+
+/**
+ * Select updates for one outgoing message
+ */
+uint32_t swim_dissem_select(swim_dissem_t *dissem, uint32_t member_count,
+                            swim_node_t **out, uint32_t max) {
+    uint32_t limit = swim_dissem_limit(dissem, member_count);
+    uint32_t count = 0;
+
+    // Collect first so moving entries between buckets can't revisit them
+    for (uint32_t b = 0; b < SWIM_DISSEM_MAX_TRANSMITS && count < max; b++) {
+        for (swim_node_t *node = dissem->buckets[b]; node && count < max; node = node->dissem.next) {
+            out[count++] = node;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        swim_node_t *node = out[i];
+        swim_dissem_unlink(dissem, node);
+        node->dissem.transmits++;
+
+        if (node->dissem.transmits >= limit) {
+            node->dissem.queued = false;
+            node->dissem.transmits = 0;
+            dissem->count--;
+        } else {
+            swim_dissem_link(dissem, node);
+        }
+    }
+
+    return count;
+}
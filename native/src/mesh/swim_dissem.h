@@ -0,0 +1,74 @@
+/**
+ * LSDAMM - SWIM Dissemination Queue Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Infection-style dissemination buffer: holds only recent membership changes,
+ * hands the least-transmitted ones out for piggybacking on protocol traffic,
+ * and drops each change after lambda * log(n) transmissions.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_DISSEM_H
+#define SWIM_DISSEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct swim_node;
+
+#define SWIM_RETRANSMIT_MULT        4     // lambda
+#define SWIM_DISSEM_MAX_TRANSMITS   64    // Hard cap on per-update transmissions
+
+// Per-node queue linkage (embedded in swim_node_t, no allocation per update)
+typedef struct {
+    bool queued;
+    uint32_t transmits;
+    struct swim_node *prev;
+    struct swim_node *next;
+} swim_dissem_link_t;
+
+// Dissemination queue, bucketed by transmit count
+typedef struct {
+    struct swim_node *buckets[SWIM_DISSEM_MAX_TRANSMITS];
+    uint32_t count;
+    uint32_t retransmit_mult;
+} swim_dissem_t;
+
+/**
+ * Initialize queue
+ * @param retransmit_mult Lambda (0 for SWIM_RETRANSMIT_MULT)
+ */
+void swim_dissem_init(swim_dissem_t *dissem, uint32_t retransmit_mult);
+
+/**
+ * Drop all queued updates
+ */
+void swim_dissem_clear(swim_dissem_t *dissem);
+
+/**
+ * Queue (or re-queue) the node's current state for dissemination.
+ * Resets its transmit count so the newest state always goes out first.
+ */
+void swim_dissem_enqueue(swim_dissem_t *dissem, struct swim_node *node);
+
+/**
+ * Remove a node's pending update (e.g. before freeing the node)
+ */
+void swim_dissem_remove(swim_dissem_t *dissem, struct swim_node *node);
+
+/**
+ * Retransmit limit for a cluster of the given size
+ */
+uint32_t swim_dissem_limit(const swim_dissem_t *dissem, uint32_t member_count);
+
+/**
+ * Take up to max updates for one outgoing message, least-transmitted first.
+ * Each returned node's transmit count is incremented; updates that reach the
+ * retransmit limit leave the queue.
+ * @return Number of nodes written to out
+ */
+uint32_t swim_dissem_select(swim_dissem_t *dissem, uint32_t member_count,
+                            struct swim_node **out, uint32_t max);
+
+#endif // SWIM_DISSEM_H
@@ -0,0 +1,129 @@
+/**
+ * LSDAMM - SWIM Epoch-Based Reclamation Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_epoch.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#endif
+
+/**
+ * Initialize domain
+ */
+void swim_epoch_init(swim_epoch_t *epoch) {
+    swim_atomic_store(&epoch->global, 1);
+    for (uint32_t i = 0; i < SWIM_EPOCH_READERS; i++) {
+        swim_atomic_store(&epoch->readers[i], 0);
+    }
+    epoch->retired = NULL;
+    epoch->retired_count = 0;
+}
+
+/**
+ * Free all retired objects
+ */
+void swim_epoch_destroy(swim_epoch_t *epoch) {
+    swim_epoch_retired_t *r = epoch->retired;
+    while (r) {
+        swim_epoch_retired_t *next = r->next;
+        r->free_fn(r->ptr);
+        free(r);
+        r = next;
+    }
+    epoch->retired = NULL;
+    epoch->retired_count = 0;
+}
+
+/**
+ * Pin current epoch
+ */
+void swim_epoch_enter(swim_epoch_t *epoch, swim_epoch_guard_t *guard) {
+    // Spread threads over the slots to keep CAS contention down
+    uint32_t start = (uint32_t)(((uintptr_t)guard >> 4) % SWIM_EPOCH_READERS);
+
+    for (;;) {
+        uint64_t now = swim_atomic_load(&epoch->global);
+
+        for (uint32_t i = 0; i < SWIM_EPOCH_READERS; i++) {
+            uint32_t slot = (start + i) % SWIM_EPOCH_READERS;
+            if (swim_atomic_cas(&epoch->readers[slot], 0, now)) {
+                guard->slot = (int)slot;
+                return;
+            }
+        }
+
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+/**
+ * Unpin
+ */
+void swim_epoch_exit(swim_epoch_t *epoch, swim_epoch_guard_t *guard) {
+    if (guard->slot < 0) return;
+    swim_atomic_store(&epoch->readers[guard->slot], 0);
+    guard->slot = -1;
+}
+
+/**
+ * Retire object
+ */
+void swim_epoch_retire(swim_epoch_t *epoch, void *ptr, swim_epoch_free_fn free_fn) {
+    swim_epoch_retired_t *r = (swim_epoch_retired_t*)malloc(sizeof(swim_epoch_retired_t));
+    if (!r) {
+        // Leaking beats freeing under a reader
+        log_error("SWIM: Failed to retire object, leaking it");
+        return;
+    }
+
+    // Readers pinned at this epoch or earlier may hold ptr; later ones cannot
+    r->ptr = ptr;
+    r->free_fn = free_fn;
+    r->epoch = swim_atomic_load(&epoch->global);
+    r->next = epoch->retired;
+    epoch->retired = r;
+    epoch->retired_count++;
+
+    swim_atomic_store(&epoch->global, r->epoch + 1);
+}
+
+/**
+ * Free what no reader can see
+ */
+uint32_t swim_epoch_reclaim(swim_epoch_t *epoch) {
+    if (!epoch->retired) return 0;
+
+    // Oldest pinned epoch; with no readers everything retired so far is safe
+    uint64_t oldest = swim_atomic_load(&epoch->global);
+    for (uint32_t i = 0; i < SWIM_EPOCH_READERS; i++) {
+        uint64_t pinned = swim_atomic_load(&epoch->readers[i]);
+        if (pinned != 0 && pinned < oldest) oldest = pinned;
+    }
+
+    uint32_t freed = 0;
+    swim_epoch_retired_t **link = &epoch->retired;
+    while (*link) {
+        swim_epoch_retired_t *r = *link;
+        if (r->epoch < oldest) {
+            *link = r->next;
+            r->free_fn(r->ptr);
+            free(r);
+            freed++;
+        } else {
+            link = &r->next;
+        }
+    }
+
+    epoch->retired_count -= freed;
+    return freed;
+}
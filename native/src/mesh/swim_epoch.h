@@ -0,0 +1,126 @@
+/**
+ * LSDAMM - SWIM Epoch-Based Reclamation Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Lets reader threads use objects published by a single writer without
+ * taking a lock. Readers pin the current epoch while they hold a pointer;
+ * the writer retires replaced objects and frees them only once every
+ * reader pinned at or before the retirement has left. Readers never wait
+ * for the writer and the writer never waits for readers.
+ *
+ * Reference: Fraser, "Practical lock-freedom" (2004), section 5.2.3
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_EPOCH_H
+#define SWIM_EPOCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef volatile LONG64 swim_atomic_u64;
+#else
+#include <stdatomic.h>
+typedef _Atomic uint64_t swim_atomic_u64;
+#endif
+
+#define SWIM_EPOCH_READERS      64    // Concurrently pinned readers
+
+/*
+ * Sequentially consistent atomics (the reclamation argument relies on a
+ * single total order of reader pins and writer scans)
+ */
+#ifdef _WIN32
+static inline uint64_t swim_atomic_load(swim_atomic_u64 *v) {
+    return (uint64_t)InterlockedCompareExchange64(v, 0, 0);
+}
+
+static inline void swim_atomic_store(swim_atomic_u64 *v, uint64_t value) {
+    InterlockedExchange64(v, (LONG64)value);
+}
+
+static inline uint64_t swim_atomic_exchange(swim_atomic_u64 *v, uint64_t value) {
+    return (uint64_t)InterlockedExchange64(v, (LONG64)value);
+}
+
+static inline bool swim_atomic_cas(swim_atomic_u64 *v, uint64_t expected, uint64_t desired) {
+    return (uint64_t)InterlockedCompareExchange64(v, (LONG64)desired, (LONG64)expected) == expected;
+}
+#else
+static inline uint64_t swim_atomic_load(swim_atomic_u64 *v) {
+    return atomic_load(v);
+}
+
+static inline void swim_atomic_store(swim_atomic_u64 *v, uint64_t value) {
+    atomic_store(v, value);
+}
+
+static inline uint64_t swim_atomic_exchange(swim_atomic_u64 *v, uint64_t value) {
+    return atomic_exchange(v, value);
+}
+
+static inline bool swim_atomic_cas(swim_atomic_u64 *v, uint64_t expected, uint64_t desired) {
+    return atomic_compare_exchange_strong(v, &expected, desired);
+}
+#endif
+
+typedef void (*swim_epoch_free_fn)(void *ptr);
+
+// Object waiting for its readers to leave
+typedef struct swim_epoch_retired {
+    void *ptr;
+    swim_epoch_free_fn free_fn;
+    uint64_t epoch;
+    struct swim_epoch_retired *next;
+} swim_epoch_retired_t;
+
+// Reclamation domain: one writer (serialized by the caller), many readers
+typedef struct {
+    swim_atomic_u64 global;                         // Current epoch (starts at 1)
+    swim_atomic_u64 readers[SWIM_EPOCH_READERS];    // Pinned epoch per slot, 0 = free
+    swim_epoch_retired_t *retired;                  // Writer-only
+    uint32_t retired_count;
+} swim_epoch_t;
+
+// Reader pin, returned by swim_epoch_enter
+typedef struct {
+    int slot;
+} swim_epoch_guard_t;
+
+/**
+ * Initialize domain
+ */
+void swim_epoch_init(swim_epoch_t *epoch);
+
+/**
+ * Free everything still retired (no reader may be pinned)
+ */
+void swim_epoch_destroy(swim_epoch_t *epoch);
+
+/**
+ * Pin the current epoch. Objects loaded afterwards stay allocated until
+ * swim_epoch_exit. Yields only if all SWIM_EPOCH_READERS slots are in use.
+ */
+void swim_epoch_enter(swim_epoch_t *epoch, swim_epoch_guard_t *guard);
+
+/**
+ * Unpin
+ */
+void swim_epoch_exit(swim_epoch_t *epoch, swim_epoch_guard_t *guard);
+
+/**
+ * Writer: hand over an object that is no longer reachable for new readers
+ */
+void swim_epoch_retire(swim_epoch_t *epoch, void *ptr, swim_epoch_free_fn free_fn);
+
+/**
+ * Writer: free retired objects no pinned reader can still see
+ * @return Objects freed
+ */
+uint32_t swim_epoch_reclaim(swim_epoch_t *epoch);
+
+#endif // SWIM_EPOCH_H
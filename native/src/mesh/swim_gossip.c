@@ -10,7 +10,13 @@
  * (c) 2025 Lackadaisical Security
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "swim_gossip.h"
+#include "swim_reactor.h"
+#include "swim_bootstrap.h"
 #include "../util/logging.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,23 +33,92 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#define SWIM_HAVE_EPOLL 1
+#define SWIM_HAVE_RX_SHARDS 1   // Kernel balances SO_REUSEPORT UDP sockets
+#define SWIM_HAVE_BOOTSTRAP 1   // TCP join bootstrap (worker woken by eventfd)
+#endif
+
+// Received user message awaiting on_message
+struct swim_user_msg {
+    struct swim_user_msg *next;
+    swim_node_t *from;
+    size_t len;
+    uint8_t data[];
+};
+
+// Reliable message outcome awaiting on_reliable
+struct swim_reliable_done {
+    struct swim_reliable_done *next;
+    char node_id[SWIM_NODE_ID_SIZE];
+    uint32_t msg_id;
+    bool delivered;
+};
+
+// Message held back by the send budget
+struct swim_deferred {
+    struct swim_deferred *next;
+    struct sockaddr_in to;
+    uint32_t len;
+    uint8_t data[];
+};
+
+// Member whose channel a swim_channel callback reports on
+typedef struct {
+    swim_context_t *ctx;
+    swim_node_t *node;
+} swim_channel_link_t;
+
+#ifdef SWIM_HAVE_RX_SHARDS
+// Extra receive socket on the context's port and the worker draining it
+struct swim_rx_shard {
+    swim_context_t *ctx;
+    swim_transport_t *transport;
+    pthread_t thread;
+    int wake_fd;            // Written once to stop the worker
+    bool running;           // Worker started (owner thread only)
+    
+    // Transport counters, copied under the context lock for stats
+    uint64_t rx_calls;
+    uint64_t rx_datagrams;
+    uint64_t tx_calls;
+    uint64_t tx_datagrams;
+    uint64_t tx_bytes;
+    uint64_t tx_dropped;
+};
 #endif
 
 // Internal functions
 static void swim_lock(swim_context_t *ctx);
 static void swim_unlock(swim_context_t *ctx);
-static swim_node_t* swim_create_node(const char *id, const char *address, uint16_t port);
-static void swim_add_node(swim_context_t *ctx, swim_node_t *node);
+static swim_node_t* swim_create_node(swim_context_t *ctx, const char *id, const char *address, uint16_t port);
+static swim_node_t* swim_lookup(swim_context_t *ctx, const char *id);
+static swim_node_t* swim_add_node(swim_context_t *ctx, swim_node_t *node);
 static void swim_remove_node(swim_context_t *ctx, const char *id);
 static void swim_update_node_state(swim_context_t *ctx, swim_node_t *node, swim_node_state_t new_state);
+static void swim_start_suspicion(swim_context_t *ctx, swim_node_t *node);
 static int swim_send_ping(swim_context_t *ctx, swim_node_t *target);
 static int swim_send_ping_req(swim_context_t *ctx, swim_node_t *via, swim_node_t *target);
 static int swim_send_ack(swim_context_t *ctx, swim_node_t *target, uint32_t seq);
 static int swim_send_sync(swim_context_t *ctx, swim_node_t *target);
+static void swim_apply_update(swim_context_t *ctx, const swim_node_update_t *update);
 static void swim_handle_message(swim_context_t *ctx, const struct sockaddr_in *from, const uint8_t *data, size_t len);
 static void swim_gossip_round(swim_context_t *ctx);
-static swim_node_t* swim_select_random_node(swim_context_t *ctx);
-static void swim_check_timeouts(swim_context_t *ctx);
+static void swim_probe_insert(swim_context_t *ctx, swim_node_t *node);
+static void swim_probe_remove(swim_context_t *ctx, swim_node_t *node);
+static swim_node_t* swim_probe_next(swim_context_t *ctx);
+static void swim_channel_pump(swim_context_t *ctx, swim_node_t *node);
+static void swim_channel_close(swim_context_t *ctx, swim_node_t *node);
+static void swim_channel_send_acks(swim_context_t *ctx);
+static void swim_tree_repair(swim_context_t *ctx, swim_node_t *node);
+static void swim_on_timer(swim_timer_t *timer, void *arg);
+static void swim_tick(swim_context_t *ctx);
 
 #ifdef _WIN32
 static DWORD WINAPI swim_thread_func(LPVOID arg);
@@ -51,6 +126,34 @@ static DWORD WINAPI swim_thread_func(LPVOID arg);
 static void* swim_thread_func(void *arg);
 #endif
 
+// Timer event types
+enum {
+    SWIM_TIMER_PROBE = 0,       // Direct PING unanswered
+    SWIM_TIMER_INDIRECT,        // Indirect probe window over
+    SWIM_TIMER_SUSPECT,         // Suspicion expired
+    SWIM_TIMER_CHANNEL,         // Reliable channel fragment due for resend
+    SWIM_TIMER_GRAFT            // Announced broadcast not received (owner: swim_tree_missing_t)
+};
+
+/*
+ * Locking: public API functions take ctx->lock; static helpers below assume
+ * the caller already holds it.
+ */
+
+/**
+ * Monotonic time in microseconds, from the transport clock
+ */
+static uint64_t swim_now_us(swim_context_t *ctx) {
+    return swim_transport_now_us(ctx->transport);
+}
+
+/**
+ * Monotonic time in milliseconds, from the transport clock
+ */
+static uint64_t swim_now_ms(swim_context_t *ctx) {
+    return swim_transport_now_us(ctx->transport) / 1000;
+}
+
 /**
  * Lock context mutex
  */
@@ -73,85 +176,280 @@ static void swim_unlock(swim_context_t *ctx) {
 #endif
 }
 
+/**
+ * Record a membership change: queue it for gossip and mark the
+ * published snapshot stale
+ */
+static void swim_member_changed(swim_context_t *ctx, swim_node_t *node) {
+    if (!node->placeholder) {
+        swim_dissem_enqueue(&ctx->dissem, node);
+    }
+    ctx->membership_dirty = true;
+}
+
+/**
+ * Copy node into a member record
+ */
+static void swim_fill_member(swim_member_t *m, const swim_node_t *node) {
+    memcpy(m->id, node->id, sizeof(m->id));
+    m->id_hash = node->id_hash;
+    memcpy(m->address, node->address, sizeof(m->address));
+    m->port = node->port;
+    m->state = node->state;
+    m->incarnation = node->incarnation;
+    m->state_change_ms = node->state_change_ms;
+    m->is_local = node->is_local;
+    m->is_main_node = node->is_main_node;
+}
+
+/**
+ * Double the event ring (up to SWIM_EVENT_QUEUE), unwrapping it so the
+ * oldest event lands in slot 0
+ * @return 0 on success, -1 if at the limit or out of memory
+ */
+static int swim_grow_events(swim_context_t *ctx) {
+    uint32_t capacity = ctx->event_capacity ? ctx->event_capacity * 2 : SWIM_EVENT_BATCH;
+    if (capacity > SWIM_EVENT_QUEUE) return -1;
+    
+    swim_event_slot_t *events = (swim_event_slot_t*)calloc(capacity, sizeof(swim_event_slot_t));
+    if (!events) return -1;
+    
+    for (uint32_t i = 0; i < ctx->event_count; i++) {
+        events[i] = ctx->events[(ctx->event_head + i) % ctx->event_capacity];
+        if (events[i].pending && events[i].node) {
+            events[i].node->event_slot = (int32_t)i;
+        }
+    }
+    
+    free(ctx->events);
+    ctx->events = events;
+    ctx->event_capacity = capacity;
+    ctx->event_head = 0;
+    return 0;
+}
+
+/**
+ * Queue a membership event, merging it into the node's pending one.
+ * A change that returns to the pending event's starting state (a flap)
+ * cancels it.
+ */
+static void swim_queue_event(swim_context_t *ctx, swim_node_t *node,
+                             swim_node_state_t old_state, swim_node_state_t new_state) {
+    if (node->event_slot >= 0) {
+        swim_event_slot_t *slot = &ctx->events[node->event_slot];
+        ctx->events_coalesced++;
+        
+        if (slot->event.old_state == new_state) {
+            slot->pending = false;
+            node->event_slot = -1;
+        } else {
+            swim_fill_member(&slot->event.member, node);
+            slot->event.new_state = new_state;
+        }
+        return;
+    }
+    
+    if (ctx->event_count == ctx->event_capacity && swim_grow_events(ctx) != 0) {
+        ctx->events_dropped++;
+        ctx->event_overflow = true;
+        return;
+    }
+    
+    uint32_t index = (ctx->event_head + ctx->event_count++) % ctx->event_capacity;
+    swim_event_slot_t *slot = &ctx->events[index];
+    swim_fill_member(&slot->event.member, node);
+    slot->event.old_state = old_state;
+    slot->event.new_state = new_state;
+    slot->node = node;
+    slot->pending = true;
+    node->event_slot = (int32_t)index;
+    ctx->events_queued++;
+}
+
+/**
+ * Snapshot order: id hash, then id
+ */
+static int swim_member_compare(const void *a, const void *b) {
+    const swim_member_t *ma = (const swim_member_t*)a;
+    const swim_member_t *mb = (const swim_member_t*)b;
+    if (ma->id_hash != mb->id_hash) return ma->id_hash < mb->id_hash ? -1 : 1;
+    return strcmp(ma->id, mb->id);
+}
+
+/**
+ * Publish a new membership snapshot if anything changed, and free
+ * snapshots no reader holds any more. Called before the lock is released
+ * by every path that can change membership.
+ */
+static void swim_membership_publish(swim_context_t *ctx) {
+    if (ctx->membership_dirty) {
+        swim_membership_t *snap = (swim_membership_t*)malloc(
+            sizeof(swim_membership_t) + (size_t)ctx->node_count * sizeof(swim_member_t));
+        if (!snap) {
+            log_error("SWIM: Failed to allocate membership snapshot");
+            return;
+        }
+        
+        memset(snap->state_count, 0, sizeof(snap->state_count));
+        snap->count = 0;
+        for (swim_node_t *node = ctx->nodes; node; node = node->next) {
+            swim_fill_member(&snap->members[snap->count++], node);
+            snap->state_count[node->state]++;
+        }
+        qsort(snap->members, snap->count, sizeof(swim_member_t), swim_member_compare);
+        snap->version = ++ctx->membership_version;
+        
+        uint64_t old = swim_atomic_exchange(&ctx->membership, (uint64_t)(uintptr_t)snap);
+        if (old) {
+            swim_epoch_retire(&ctx->epoch, (void*)(uintptr_t)old, free);
+        }
+        ctx->membership_dirty = false;
+    }
+    
+    swim_epoch_reclaim(&ctx->epoch);
+}
+
 /**
  * Create a new node
  */
-static swim_node_t* swim_create_node(const char *id, const char *address, uint16_t port) {
+static swim_node_t* swim_create_node(swim_context_t *ctx, const char *id, const char *address, uint16_t port) {
     swim_node_t *node = (swim_node_t*)calloc(1, sizeof(swim_node_t));
     if (!node) return NULL;
     
     strncpy(node->id, id, SWIM_NODE_ID_SIZE - 1);
+    node->id_hash = swim_hash_id(node->id);
     strncpy(node->address, address, sizeof(node->address) - 1);
     node->port = port;
     node->state = NODE_STATE_ALIVE;
     node->incarnation = 1;
-    node->last_seen = time(NULL);
-    node->state_change_time = time(NULL);
+    node->last_seen_ms = swim_now_ms(ctx);
+    node->state_change_ms = node->last_seen_ms;
+    node->last_ack_ms = node->last_seen_ms;
+    node->event_slot = -1;
+    swim_coord_init(&node->coord);
+    swim_timer_init(&node->probe_timer, node, SWIM_TIMER_PROBE);
+    swim_timer_init(&node->suspect_timer, node, SWIM_TIMER_SUSPECT);
+    swim_timer_init(&node->channel_timer, node, SWIM_TIMER_CHANNEL);
     
     return node;
 }
 
 /**
- * Add node to the list
+ * Find node by ID
  */
-static void swim_add_node(swim_context_t *ctx, swim_node_t *node) {
-    swim_lock(ctx);
-    
+static swim_node_t* swim_lookup(swim_context_t *ctx, const char *id) {
+    return swim_index_find(&ctx->index, id, swim_hash_id(id));
+}
+
+/**
+ * Add node to the list and queue it for dissemination
+ * @return Node now in the table (existing entry if the ID was already known)
+ */
+static swim_node_t* swim_add_node(swim_context_t *ctx, swim_node_t *node) {
     // Check if node already exists
-    swim_node_t *existing = ctx->nodes;
-    while (existing) {
-        if (strcmp(existing->id, node->id) == 0) {
-            // Update existing node
-            existing->incarnation = node->incarnation;
-            existing->last_seen = node->last_seen;
-            if (existing->state != node->state) {
-                swim_update_node_state(ctx, existing, node->state);
-            }
-            swim_unlock(ctx);
-            free(node);
-            return;
+    swim_node_t *existing = swim_index_find(&ctx->index, node->id, node->id_hash);
+    if (existing) {
+        // Update existing node
+        existing->incarnation = node->incarnation;
+        existing->last_seen_ms = node->last_seen_ms;
+        ctx->membership_dirty = true;
+        if (existing->state != node->state) {
+            swim_update_node_state(ctx, existing, node->state);
         }
-        existing = existing->next;
+        free(node);
+        return existing;
+    }
+    
+    if (swim_index_insert(&ctx->index, node) != 0) {
+        log_error("SWIM: Failed to index node %s", node->id);
+        free(node);
+        return NULL;
     }
     
     // Add new node to front of list
+    node->prev = NULL;
+    if (ctx->nodes) ctx->nodes->prev = node;
     node->next = ctx->nodes;
     ctx->nodes = node;
     ctx->node_count++;
     
+    if (!node->is_local && (node->state == NODE_STATE_ALIVE || node->state == NODE_STATE_SUSPECT)) {
+        swim_probe_insert(ctx, node);
+    }
+    if (!node->is_local && node->state == NODE_STATE_SUSPECT) {
+        swim_start_suspicion(ctx, node);
+    }
+    swim_member_changed(ctx, node);
+    
     log_info("SWIM: Added node %s at %s:%d", node->id, node->address, node->port);
     
-    swim_unlock(ctx);
+    swim_queue_event(ctx, node, NODE_STATE_DEAD, node->state);
     
-    // Notify callback
-    if (ctx->on_node_event) {
-        ctx->on_node_event(node, NODE_STATE_DEAD, NODE_STATE_ALIVE, ctx->user_data);
-    }
+    return node;
 }
 
 /**
  * Remove node from the list
  */
 static void swim_remove_node(swim_context_t *ctx, const char *id) {
-    swim_lock(ctx);
-    
-    swim_node_t **pp = &ctx->nodes;
-    while (*pp) {
-        if (strcmp((*pp)->id, id) == 0) {
-            swim_node_t *node = *pp;
-            *pp = node->next;
-            ctx->node_count--;
-            
-            log_info("SWIM: Removed node %s", id);
-            
-            swim_unlock(ctx);
-            free(node);
-            return;
+    swim_node_t *node = swim_index_remove(&ctx->index, id, swim_hash_id(id));
+    if (node) {
+        swim_dissem_remove(&ctx->dissem, node);
+        swim_probe_remove(ctx, node);
+        swim_timer_cancel(&ctx->timers, &node->probe_timer);
+        swim_timer_cancel(&ctx->timers, &node->suspect_timer);
+        swim_channel_close(ctx, node);
+        swim_tree_repair(ctx, node);
+        swim_tree_forget(&ctx->tree, node);
+        for (uint32_t i = 0; i < ctx->channel_ack_count; i++) {
+            if (ctx->channel_acks[i] == node) ctx->channel_acks[i] = ctx->channel_acks[--ctx->channel_ack_count];
+        }
+        
+        // A pending event keeps its copy of the member but loses the node
+        if (node->event_slot >= 0) {
+            ctx->events[node->event_slot].node = NULL;
+        }
+        
+        // Drop indirect probe state that still points at the node
+        if (ctx->probe_by_seq[node->ping_seq % SWIM_PROBE_SEQ_SLOTS] == node) {
+            ctx->probe_by_seq[node->ping_seq % SWIM_PROBE_SEQ_SLOTS] = NULL;
+        }
+        for (uint32_t i = 0; i < SWIM_RELAY_SLOTS; i++) {
+            if (ctx->relays[i].requester == node) ctx->relays[i].requester = NULL;
         }
-        pp = &(*pp)->next;
+        for (uint32_t i = 0; i < SWIM_JOIN_SEEDS; i++) {
+            if (ctx->join_seeds[i] == node) ctx->join_seeds[i] = NULL;
+        }
+        
+        // Unlink from list
+        if (node->prev) node->prev->next = node->next;
+        else ctx->nodes = node->next;
+        if (node->next) node->next->prev = node->prev;
+        ctx->node_count--;
+        ctx->membership_dirty = true;
+        
+        log_info("SWIM: Removed node %s", node->id);
+        
+        // Callers that fetched the pointer may still be using it
+        swim_epoch_retire(&ctx->epoch, node, free);
     }
-    
-    swim_unlock(ctx);
+}
+
+/**
+ * Suspicion timeout for node given the confirmations gathered so far
+ */
+static uint32_t swim_suspect_timeout(swim_context_t *ctx, const swim_node_t *node) {
+    return swim_detector_suspect_timeout(&ctx->detector, ctx->probe_count + 1,
+                                         node->detector.confirmations);
+}
+
+/**
+ * Arm the suspicion timeout for a node that just became SUSPECT
+ */
+static void swim_start_suspicion(swim_context_t *ctx, swim_node_t *node) {
+    swim_detector_suspect(&node->detector, node->accuser[0] ? swim_hash_id(node->accuser) : 0);
+    swim_timer_schedule(&ctx->timers, &node->suspect_timer,
+                        node->state_change_ms + swim_suspect_timeout(ctx, node));
 }
 
 /**
@@ -163,341 +461,2077 @@ static void swim_update_node_state(swim_context_t *ctx, swim_node_t *node, swim_
     if (old_state == new_state) return;
     
     node->state = new_state;
-    node->state_change_time = time(NULL);
+    node->state_change_ms = swim_now_ms(ctx);
+    swim_member_changed(ctx, node);
+    
+    // A suspect tree neighbour may be gone: route broadcasts around it
+    if (new_state != NODE_STATE_ALIVE) {
+        swim_tree_repair(ctx, node);
+    }
+    
+    // Suspicion runs until refuted or expired
+    if (new_state == NODE_STATE_SUSPECT && !node->is_local) {
+        swim_start_suspicion(ctx, node);
+        ctx->suspicions++;
+    } else {
+        swim_timer_cancel(&ctx->timers, &node->suspect_timer);
+        node->accuser[0] = '\0';
+    }
+    
+    if (!node->is_local) {
+        if (old_state == NODE_STATE_SUSPECT && new_state == NODE_STATE_ALIVE) ctx->suspicions_cleared++;
+        if (new_state == NODE_STATE_DEAD) ctx->deaths++;
+    }
+    
+    // Only live members are probed
+    if (new_state == NODE_STATE_DEAD || new_state == NODE_STATE_LEFT) {
+        swim_probe_remove(ctx, node);
+        swim_timer_cancel(&ctx->timers, &node->probe_timer);
+        node->probe_pending = false;
+        swim_channel_close(ctx, node);
+    } else if (!node->is_local) {
+        swim_probe_insert(ctx, node);
+    }
     
     const char *state_names[] = {"ALIVE", "SUSPECT", "DEAD", "LEFT"};
     log_info("SWIM: Node %s state changed: %s -> %s", 
              node->id, state_names[old_state], state_names[new_state]);
     
-    if (ctx->on_node_event) {
-        ctx->on_node_event(node, old_state, new_state, ctx->user_data);
-    }
+    swim_queue_event(ctx, node, old_state, new_state);
 }
 
 /**
- * Send ping message
+ * Resolve node address
  */
-static int swim_send_ping(swim_context_t *ctx, swim_node_t *target) {
-    swim_ping_t ping = {0};
-    ping.header.version = 1;
-    ping.header.type = SWIM_MSG_PING;
-    ping.header.payload_len = 0;
-    ping.header.seq_num = ++ctx->seq_num;
-    ping.header.incarnation = ctx->incarnation;
-    strncpy(ping.header.sender_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
-    strncpy(ping.target_id, target->id, SWIM_NODE_ID_SIZE - 1);
-    
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(target->port);
-    inet_pton(AF_INET, target->address, &addr.sin_addr);
-    
-    int sent = sendto(ctx->sock, (const char*)&ping, sizeof(ping), 0,
-                      (struct sockaddr*)&addr, sizeof(addr));
-    
-    if (sent > 0) {
-        ctx->messages_sent++;
-        target->ping_seq = ping.header.seq_num;
-        return 0;
-    }
-    
-    return -1;
+static void swim_node_sockaddr(const swim_node_t *node, struct sockaddr_in *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(node->port);
+    inet_pton(AF_INET, node->address, &addr->sin_addr);
 }
 
 /**
- * Send indirect ping request
+ * Hand one datagram to the transport
  */
-static int swim_send_ping_req(swim_context_t *ctx, swim_node_t *via, swim_node_t *target) {
-    swim_ping_req_t req = {0};
-    req.header.version = 1;
-    req.header.type = SWIM_MSG_PING_REQ;
-    req.header.payload_len = 0;
-    req.header.seq_num = ++ctx->seq_num;
-    req.header.incarnation = ctx->incarnation;
-    strncpy(req.header.sender_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
-    strncpy(req.target_id, target->id, SWIM_NODE_ID_SIZE - 1);
-    strncpy(req.source_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
-    
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(via->port);
-    inet_pton(AF_INET, via->address, &addr.sin_addr);
-    
-    int sent = sendto(ctx->sock, (const char*)&req, sizeof(req), 0,
-                      (struct sockaddr*)&addr, sizeof(addr));
-    
-    if (sent > 0) {
-        ctx->messages_sent++;
-        return 0;
-    }
-    
-    return -1;
+static void swim_emit(swim_context_t *ctx, swim_transport_t *t, const struct sockaddr_in *to,
+                      const uint8_t *data, size_t len) {
+    swim_transport_send(t, to, data, len);
+    ctx->datagrams_sent++;
 }
 
 /**
- * Send ack message
+ * Move the outbox to the transport. Messages to the same peer are packed,
+ * in order, into COMPOUND datagrams of up to mtu bytes; a message with no
+ * company (or too large to share) goes out as it is.
  */
-static int swim_send_ack(swim_context_t *ctx, swim_node_t *target, uint32_t seq) {
-    swim_ack_t ack = {0};
-    ack.header.version = 1;
-    ack.header.type = SWIM_MSG_ACK;
-    ack.header.payload_len = 0;
-    ack.header.seq_num = seq;
-    ack.header.incarnation = ctx->incarnation;
-    strncpy(ack.header.sender_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
-    strncpy(ack.target_id, target->id, SWIM_NODE_ID_SIZE - 1);
-    
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(target->port);
-    inet_pton(AF_INET, target->address, &addr.sin_addr);
-    
-    int sent = sendto(ctx->sock, (const char*)&ack, sizeof(ack), 0,
-                      (struct sockaddr*)&addr, sizeof(addr));
-    
-    if (sent > 0) {
-        ctx->messages_sent++;
-        return 0;
+static void swim_outbox_drain(swim_context_t *ctx, swim_transport_t *t) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    
+    for (uint32_t i = 0; i < ctx->outbox_count; i++) {
+        swim_outbox_entry_t *first = &ctx->outbox[i];
+        if (!first->len) continue;
+        
+        swim_wire_writer_t w;
+        swim_wire_writer_init(&w, buffer, ctx->mtu);
+        swim_wire_write_compound(&w);
+        
+        uint32_t parts = 0;
+        for (uint32_t j = i; j < ctx->outbox_count; j++) {
+            swim_outbox_entry_t *e = &ctx->outbox[j];
+            if (!e->len || e->to.sin_port != first->to.sin_port ||
+                e->to.sin_addr.s_addr != first->to.sin_addr.s_addr) {
+                continue;
+            }
+            if (swim_wire_write_part(&w, ctx->outbox_data + e->offset, e->len) != 0) {
+                if (j == i) break;
+                continue;
+            }
+            if (j != i) e->len = 0;
+            parts++;
+        }
+        
+        if (parts <= 1) {
+            swim_emit(ctx, t, &first->to, ctx->outbox_data + first->offset, first->len);
+        } else {
+            swim_emit(ctx, t, &first->to, buffer, w.len);
+            ctx->compound_sent++;
+            ctx->compound_parts += parts;
+        }
+        first->len = 0;
     }
     
-    return -1;
+    ctx->outbox_count = 0;
+    ctx->outbox_used = 0;
 }
 
 /**
- * Send state sync message
+ * Send everything queued: pack the outbox, then flush the transport
  */
-static int swim_send_sync(swim_context_t *ctx, swim_node_t *target) {
-    uint8_t buffer[4096];
-    swim_sync_t *sync = (swim_sync_t*)buffer;
-    
-    sync->header.version = 1;
-    sync->header.type = SWIM_MSG_SYNC;
-    sync->header.seq_num = ++ctx->seq_num;
-    sync->header.incarnation = ctx->incarnation;
-    strncpy(sync->header.sender_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
-    
-    // Add node updates
-    swim_node_update_t *updates = (swim_node_update_t*)(buffer + sizeof(swim_sync_t));
-    uint32_t count = 0;
-    
-    swim_lock(ctx);
-    swim_node_t *node = ctx->nodes;
-    while (node && count < 50) {  // Limit to 50 nodes per sync
-        strncpy(updates[count].id, node->id, SWIM_NODE_ID_SIZE - 1);
-        strncpy(updates[count].address, node->address, sizeof(updates[count].address) - 1);
-        updates[count].port = node->port;
-        updates[count].state = (uint8_t)node->state;
-        updates[count].incarnation = node->incarnation;
-        updates[count].is_main_node = node->is_main_node ? 1 : 0;
-        count++;
-        node = node->next;
-    }
-    swim_unlock(ctx);
-    
-    sync->node_count = count;
-    sync->header.payload_len = (uint16_t)(count * sizeof(swim_node_update_t));
-    
-    size_t total_len = sizeof(swim_sync_t) + (count * sizeof(swim_node_update_t));
-    
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(target->port);
-    inet_pton(AF_INET, target->address, &addr.sin_addr);
-    
-    int sent = sendto(ctx->sock, (const char*)buffer, (int)total_len, 0,
-                      (struct sockaddr*)&addr, sizeof(addr));
-    
-    if (sent > 0) {
-        ctx->messages_sent++;
-        return 0;
-    }
-    
-    return -1;
+static void swim_flush(swim_context_t *ctx, swim_transport_t *t) {
+    swim_channel_send_acks(ctx);
+    swim_outbox_drain(ctx, t);
+    swim_transport_flush(t);
 }
 
 /**
- * Handle incoming message
+ * Append encoded message to the outbox (packed and sent on the next flush)
  */
-static void swim_handle_message(swim_context_t *ctx, const struct sockaddr_in *from, 
-                                 const uint8_t *data, size_t len) {
-    if (len < sizeof(swim_message_header_t)) return;
-    
-    const swim_message_header_t *header = (const swim_message_header_t*)data;
-    ctx->messages_received++;
-    
-    // Find or create sender node
-    char sender_addr[64];
-    inet_ntop(AF_INET, &from->sin_addr, sender_addr, sizeof(sender_addr));
-    
-    swim_node_t *sender = swim_find_node(ctx, header->sender_id);
-    if (!sender && header->type != SWIM_MSG_SYNC) {
-        // Create new node
-        sender = swim_create_node(header->sender_id, sender_addr, ntohs(from->sin_port));
-        if (sender) {
-            swim_add_node(ctx, sender);
-            sender = swim_find_node(ctx, header->sender_id);
-        }
+static void swim_outbox_add(swim_context_t *ctx, const struct sockaddr_in *to, const uint8_t *data, size_t len) {
+    if (ctx->outbox_count == SWIM_OUTBOX_MAX || SWIM_OUTBOX_BYTES - ctx->outbox_used < len) {
+        swim_outbox_drain(ctx, ctx->tx);
     }
     
-    if (sender) {
-        sender->last_seen = time(NULL);
-        if (sender->state != NODE_STATE_ALIVE) {
-            swim_update_node_state(ctx, sender, NODE_STATE_ALIVE);
-        }
-        if (header->incarnation > sender->incarnation) {
-            sender->incarnation = header->incarnation;
-        }
-    }
+    swim_outbox_entry_t *e = &ctx->outbox[ctx->outbox_count++];
+    e->to = *to;
+    e->offset = ctx->outbox_used;
+    e->len = (uint32_t)len;
+    memcpy(ctx->outbox_data + e->offset, data, len);
+    ctx->outbox_used += (uint32_t)len;
     
-    switch (header->type) {
+    ctx->messages_sent++;
+}
+
+/**
+ * Send priority of an encoded message, from its type
+ */
+static swim_priority_t swim_message_priority(const uint8_t *data, size_t len) {
+    switch (len > 1 ? data[1] : SWIM_MSG_USER) {
         case SWIM_MSG_PING:
-            log_debug("SWIM: Received PING from %s", header->sender_id);
-            if (sender) {
-                swim_send_ack(ctx, sender, header->seq_num);
-            }
-            break;
-            
-        case SWIM_MSG_PING_REQ: {
-            log_debug("SWIM: Received PING_REQ from %s", header->sender_id);
-            const swim_ping_req_t *req = (const swim_ping_req_t*)data;
-            swim_node_t *target = swim_find_node(ctx, req->target_id);
-            if (target) {
-                swim_send_ping(ctx, target);
-            }
-            break;
-        }
-        
+        case SWIM_MSG_PING_REQ:
         case SWIM_MSG_ACK:
-            log_debug("SWIM: Received ACK from %s", header->sender_id);
-            if (sender) {
-                ctx->probe_success++;
-                if (sender->state == NODE_STATE_SUSPECT) {
-                    swim_update_node_state(ctx, sender, NODE_STATE_ALIVE);
-                }
-            }
-            break;
-            
-        case SWIM_MSG_SYNC: {
-            log_debug("SWIM: Received SYNC from %s", header->sender_id);
-            const swim_sync_t *sync = (const swim_sync_t*)data;
-            const swim_node_update_t *updates = (const swim_node_update_t*)(data + sizeof(swim_sync_t));
-            
-            for (uint32_t i = 0; i < sync->node_count; i++) {
-                if (strcmp(updates[i].id, ctx->local_id) == 0) continue;
-                
-                swim_node_t *node = swim_find_node(ctx, updates[i].id);
-                if (!node) {
-                    node = swim_create_node(updates[i].id, updates[i].address, updates[i].port);
-                    if (node) {
-                        node->state = (swim_node_state_t)updates[i].state;
-                        node->incarnation = updates[i].incarnation;
-                        node->is_main_node = updates[i].is_main_node;
-                        swim_add_node(ctx, node);
-                    }
-                } else {
-                    if (updates[i].incarnation > node->incarnation) {
-                        node->incarnation = updates[i].incarnation;
-                        node->is_main_node = updates[i].is_main_node;
-                        if (node->state != (swim_node_state_t)updates[i].state) {
-                            swim_update_node_state(ctx, node, (swim_node_state_t)updates[i].state);
-                        }
-                    }
-                }
-            }
-            break;
-        }
-        
+            return SWIM_PRIORITY_PROBE;
+        case SWIM_MSG_SYNC:
+        case SWIM_MSG_DIGEST:
+        case SWIM_MSG_DIGEST_REPLY:
+        case SWIM_MSG_DATA_ACK:
+        case SWIM_MSG_IHAVE:
+        case SWIM_MSG_GRAFT:
+        case SWIM_MSG_PRUNE:
+            return SWIM_PRIORITY_MEMBERSHIP;
         default:
-            log_warn("SWIM: Unknown message type: %d", header->type);
-            break;
+            return SWIM_PRIORITY_USER;
     }
 }
 
 /**
- * Select random node for probing
+ * Whether a send budget is set
  */
-static swim_node_t* swim_select_random_node(swim_context_t *ctx) {
-    if (ctx->node_count == 0) return NULL;
-    
-    // Count alive/suspect nodes
-    uint32_t eligible = 0;
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (!node->is_local && (node->state == NODE_STATE_ALIVE || node->state == NODE_STATE_SUSPECT)) {
-            eligible++;
-        }
-        node = node->next;
+static bool swim_budget_limited(const swim_context_t *ctx) {
+    return ctx->budget_bytes || ctx->budget_packets;
+}
+
+/**
+ * Whether this round's budget has room left (the last message admitted
+ * may overshoot it, so one larger than the whole budget still goes)
+ */
+static bool swim_budget_allows(const swim_context_t *ctx) {
+    return (!ctx->budget_bytes || ctx->budget_bytes_left > 0) &&
+           (!ctx->budget_packets || ctx->budget_packets_left > 0);
+}
+
+/**
+ * Whether messages of this priority or higher are already waiting
+ */
+static bool swim_backlog_ahead(const swim_context_t *ctx, swim_priority_t priority) {
+    for (int p = 0; p <= (int)priority; p++) {
+        if (ctx->backlog_head[p]) return true;
     }
-    
-    if (eligible == 0) return NULL;
-    
-    // Select random
-    uint32_t idx = rand() % eligible;
-    node = ctx->nodes;
-    while (node) {
-        if (!node->is_local && (node->state == NODE_STATE_ALIVE || node->state == NODE_STATE_SUSPECT)) {
-            if (idx == 0) return node;
-            idx--;
+    return false;
+}
+
+/**
+ * Hold a message for a later round. A full backlog sheds its oldest
+ * lowest-priority message, or this one if everything waiting ranks higher.
+ */
+static void swim_backlog_push(swim_context_t *ctx, swim_priority_t priority, const struct sockaddr_in *to,
+                              const uint8_t *data, size_t len) {
+    while (ctx->backlog_bytes + len > SWIM_BACKLOG_BYTES) {
+        int victim = SWIM_PRIORITY_COUNT - 1;
+        while (victim >= (int)priority && !ctx->backlog_head[victim]) victim--;
+        if (victim < (int)priority) {
+            ctx->budget_dropped_bytes += len;
+            return;
         }
-        node = node->next;
+    
+        struct swim_deferred *old = ctx->backlog_head[victim];
+        ctx->backlog_head[victim] = old->next;
+        if (!old->next) ctx->backlog_tail[victim] = NULL;
+        ctx->backlog_bytes -= old->len;
+        ctx->budget_dropped_bytes += old->len;
+        free(old);
     }
     
-    return NULL;
+    struct swim_deferred *d = (struct swim_deferred*)malloc(sizeof(struct swim_deferred) + len);
+    if (!d) {
+        ctx->budget_dropped_bytes += len;
+        return;
+    }
+    d->next = NULL;
+    d->to = *to;
+    d->len = (uint32_t)len;
+    memcpy(d->data, data, len);
+    
+    if (ctx->backlog_tail[priority]) {
+        ctx->backlog_tail[priority]->next = d;
+    } else {
+        ctx->backlog_head[priority] = d;
+    }
+    ctx->backlog_tail[priority] = d;
+    ctx->backlog_bytes += (uint32_t)len;
+    ctx->budget_deferred_bytes += len;
 }
 
 /**
- * Check for timeout and update node states
+ * Start a round's budget and send what waited for it, highest priority first
  */
-static void swim_check_timeouts(swim_context_t *ctx) {
-    time_t now = time(NULL);
-    
-    swim_lock(ctx);
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (!node->is_local) {
-            double since_seen = difftime(now, node->last_seen) * 1000;
-            
-            if (node->state == NODE_STATE_ALIVE && 
-                since_seen > ctx->probe_timeout_ms) {
-                swim_update_node_state(ctx, node, NODE_STATE_SUSPECT);
-                ctx->probe_failure++;
-            } else if (node->state == NODE_STATE_SUSPECT &&
-                       since_seen > ctx->suspect_timeout_ms) {
-                swim_update_node_state(ctx, node, NODE_STATE_DEAD);
-            }
+static void swim_budget_refill(swim_context_t *ctx) {
+    ctx->budget_bytes_left = ctx->budget_bytes;
+    ctx->budget_packets_left = ctx->budget_packets;
+    
+    for (int p = 0; p < SWIM_PRIORITY_COUNT; p++) {
+        struct swim_deferred *d;
+        while ((d = ctx->backlog_head[p]) != NULL && swim_budget_allows(ctx)) {
+            ctx->backlog_head[p] = d->next;
+            if (!d->next) ctx->backlog_tail[p] = NULL;
+            ctx->backlog_bytes -= d->len;
+    
+            ctx->budget_bytes_left -= d->len;
+            ctx->budget_packets_left--;
+            swim_outbox_add(ctx, &d->to, d->data, d->len);
+            free(d);
         }
-        node = node->next;
     }
-    swim_unlock(ctx);
 }
 
 /**
- * Perform one gossip round
+ * Queue encoded message to node, subject to the send budget
  */
-static void swim_gossip_round(swim_context_t *ctx) {
-    // Check timeouts
-    swim_check_timeouts(ctx);
-    
-    // Select random node to probe
-    swim_lock(ctx);
-    swim_node_t *target = swim_select_random_node(ctx);
-    swim_unlock(ctx);
-    
-    if (target) {
-        // Send ping
-        swim_send_ping(ctx, target);
-        
-        // Also send state sync periodically
-        static int sync_counter = 0;
-        if (++sync_counter >= 5) {
-            swim_send_sync(ctx, target);
-            sync_counter = 0;
+static int swim_send_raw(swim_context_t *ctx, const swim_node_t *target, const uint8_t *data, size_t len) {
+    struct sockaddr_in to;
+    swim_node_sockaddr(target, &to);
+    
+    if (swim_budget_limited(ctx)) {
+        swim_priority_t priority = swim_message_priority(data, len);
+        if (priority == SWIM_PRIORITY_PROBE) {
+            // Failure detection keeps its timing; the overdraft shows the budget is too small
+            if (!swim_budget_allows(ctx)) ctx->budget_probe_overdraft += len;
+        } else if (!swim_budget_allows(ctx) || swim_backlog_ahead(ctx, priority)) {
+            swim_backlog_push(ctx, priority, &to, data, len);
+            return 0;
         }
+        ctx->budget_bytes_left -= (int64_t)len;
+        ctx->budget_packets_left--;
     }
+    
+    swim_outbox_add(ctx, &to, data, len);
+    return 0;
 }
 
 /**
- * Background thread function
+ * Fill common message header
+ */
+static void swim_fill_header(swim_context_t *ctx, swim_wire_header_t *header, uint8_t type, uint32_t seq) {
+    memset(header, 0, sizeof(*header));
+    header->type = type;
+    header->seq_num = seq;
+    header->incarnation = ctx->incarnation;
+    strncpy(header->sender_id, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
+    if (ctx->local) {
+        header->has_coord = 1;
+        header->coord = ctx->local->coord;
+    }
+}
+
+/**
+ * Fill a state update entry from a node
+ */
+static void swim_fill_update(swim_node_update_t *update, const swim_node_t *node) {
+    memset(update, 0, sizeof(*update));
+    strncpy(update->id, node->id, SWIM_NODE_ID_SIZE - 1);
+    strncpy(update->address, node->address, sizeof(update->address) - 1);
+    update->port = node->port;
+    update->state = (uint8_t)node->state;
+    update->incarnation = node->incarnation;
+    update->is_main_node = node->is_main_node ? 1 : 0;
+    if (node->state == NODE_STATE_SUSPECT) {
+        strncpy(update->accuser, node->accuser, SWIM_NODE_ID_SIZE - 1);
+    }
+}
+
+/**
+ * Append pending dissemination updates to an outgoing message.
+ * Only as many are taken as are guaranteed to fit, so none is lost.
+ */
+static void swim_write_piggyback(swim_context_t *ctx, swim_wire_writer_t *w) {
+    uint32_t max = (uint32_t)((w->cap - w->len) / SWIM_WIRE_UPDATE_MAX);
+    if (max > SWIM_PIGGYBACK_MAX) max = SWIM_PIGGYBACK_MAX;
+    if (max == 0 || ctx->dissem.count == 0) return;
+    
+    swim_node_t *nodes[SWIM_PIGGYBACK_MAX];
+    uint32_t count = swim_dissem_select(&ctx->dissem, ctx->node_count, nodes, max);
+    
+    for (uint32_t i = 0; i < count; i++) {
+        swim_node_update_t update;
+        swim_fill_update(&update, nodes[i]);
+        swim_wire_write_update(w, &update);
+    }
+}
+
+/**
+ * Encode a protocol message with piggybacked updates and send it
+ * @param target_id Probe target for PING/PING_REQ (NULL otherwise)
+ */
+static int swim_send_message(swim_context_t *ctx, swim_node_t *to, uint8_t type,
+                             uint32_t seq, const char *target_id) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    
+    swim_fill_header(ctx, &header, type, seq);
+    if (target_id) {
+        strncpy(header.target_id, target_id, SWIM_NODE_ID_SIZE - 1);
+    }
+    
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    swim_write_piggyback(ctx, &w);
+    
+    return swim_send_raw(ctx, to, buffer, w.len);
+}
+
+/**
+ * Send ping message
+ */
+static int swim_send_ping(swim_context_t *ctx, swim_node_t *target) {
+    uint32_t seq = ++ctx->seq_num;
+    
+    if (swim_send_message(ctx, target, SWIM_MSG_PING, seq, target->id) == 0) {
+        target->ping_seq = seq;
+        ctx->probe_by_seq[seq % SWIM_PROBE_SEQ_SLOTS] = target;
+        return 0;
+    }
+    
+    return -1;
+}
+
+/**
+ * Send indirect ping request; carries the outstanding probe's seq so the
+ * relayed ACK can be matched to it
+ */
+static int swim_send_ping_req(swim_context_t *ctx, swim_node_t *via, swim_node_t *target) {
+    return swim_send_message(ctx, via, SWIM_MSG_PING_REQ, target->ping_seq, target->id);
+}
+
+/**
+ * Send ack message
+ */
+static int swim_send_ack(swim_context_t *ctx, swim_node_t *target, uint32_t seq) {
+    return swim_send_message(ctx, target, SWIM_MSG_ACK, seq, NULL);
+}
+
+/**
+ * Send state sync message (used on join/leave). Carries the local node
+ * first, then as many other members as fit in one datagram; push-pull
+ * anti-entropy reconciles the rest.
+ */
+static int swim_send_sync(swim_context_t *ctx, swim_node_t *target) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    swim_node_update_t update;
+    
+    swim_fill_header(ctx, &header, SWIM_MSG_SYNC, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    
+    if (ctx->local) {
+        swim_fill_update(&update, ctx->local);
+        swim_wire_write_update(&w, &update);
+    }
+    
+    for (swim_node_t *node = ctx->nodes; node; node = node->next) {
+        if (node == ctx->local || node->placeholder) continue;
+        swim_fill_update(&update, node);
+        if (swim_wire_write_update(&w, &update) != 0) break;
+    }
+    
+    return swim_send_raw(ctx, target, buffer, w.len);
+}
+
+/**
+ * Hash live membership into anti-entropy buckets. Each bucket is the XOR
+ * of mixed (id, incarnation, state) of its members, so order does not
+ * matter. DEAD and LEFT members are left out: every node detects those by
+ * probing, and unknown tombstones are never adopted, so counting them
+ * would keep buckets different for good.
+ * @param count Buckets, a power of two up to SWIM_SYNC_BUCKETS
+ */
+static void swim_sync_digest(swim_context_t *ctx, uint32_t *buckets, uint32_t count) {
+    memset(buckets, 0, count * sizeof(uint32_t));
+    
+    for (swim_node_t *node = ctx->nodes; node; node = node->next) {
+        if (node->state == NODE_STATE_DEAD || node->state == NODE_STATE_LEFT || node->placeholder) continue;
+        
+        // murmur3 finalizer
+        uint32_t h = node->id_hash + node->incarnation * 0x9E3779B1u + (uint32_t)node->state * 0x27D4EB2Fu;
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        
+        buckets[node->id_hash % count] ^= h;
+    }
+}
+
+/**
+ * Send a digest of our membership (all SWIM_SYNC_BUCKETS buckets). When
+ * they don't fit the MTU the digest is halved until it does: bucket i
+ * absorbs bucket i + count/2, which gives the digest id_hash % (count/2)
+ * would, so the peer compares it at that coarser resolution.
+ */
+static int swim_send_digest(swim_context_t *ctx, swim_node_t *target, uint8_t type, const uint32_t *buckets) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    uint32_t folded[SWIM_SYNC_BUCKETS];
+    uint32_t count = SWIM_SYNC_BUCKETS;
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    
+    swim_fill_header(ctx, &header, type, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    
+    memcpy(folded, buckets, sizeof(folded));
+    while (swim_wire_write_digest(&w, folded, count) != 0) {
+        if (count == 1) return -1;
+        count /= 2;
+        for (uint32_t i = 0; i < count; i++) {
+            folded[i] ^= folded[i + count];
+        }
+    }
+    
+    ctx->sync_exchanges++;
+    return swim_send_raw(ctx, target, buffer, w.len);
+}
+
+/**
+ * Send our entries (tombstones included) from every bucket where the
+ * digests differ, packed into SYNC datagrams. At most SWIM_SYNC_MAX_PAGES
+ * go out per exchange; buckets not covered still differ next time. Each
+ * page has its own seq, or the receiver would drop all but the first as
+ * duplicates.
+ */
+static void swim_send_sync_diff(swim_context_t *ctx, swim_node_t *target,
+                                const uint32_t *local, const uint32_t *remote, uint32_t count) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    uint32_t pages = 0;
+    uint32_t entries = 0;
+    
+    swim_fill_header(ctx, &header, SWIM_MSG_SYNC, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return;
+    
+    for (swim_node_t *node = ctx->nodes; node; node = node->next) {
+        uint32_t bucket = node->id_hash % count;
+        if (local[bucket] == remote[bucket] || node->placeholder) continue;
+        
+        swim_node_update_t update;
+        swim_fill_update(&update, node);
+        
+        if (swim_wire_write_update(&w, &update) != 0) {
+            // Page full: send it and start the next one
+            swim_send_raw(ctx, target, buffer, w.len);
+            ctx->sync_pages++;
+            ctx->sync_entries += entries;
+            entries = 0;
+            if (++pages == SWIM_SYNC_MAX_PAGES) return;
+            
+            header.seq_num = ++ctx->seq_num;
+            swim_wire_writer_init(&w, buffer, ctx->mtu);
+            swim_wire_write_header(&w, &header);
+            swim_wire_write_update(&w, &update);
+        }
+        entries++;
+    }
+    
+    if (entries > 0) {
+        swim_send_raw(ctx, target, buffer, w.len);
+        ctx->sync_pages++;
+        ctx->sync_entries += entries;
+    }
+}
+
+/**
+ * Start a push-pull exchange with a random live member
+ */
+static void swim_sync_start(swim_context_t *ctx) {
+    if (ctx->probe_count == 0) return;
+    
+    uint32_t start = swim_rand_below(&ctx->rng, ctx->probe_count);
+    for (uint32_t i = 0; i < ctx->probe_count; i++) {
+        swim_node_t *peer = ctx->probe_order[(start + i) % ctx->probe_count];
+        if (peer->state != NODE_STATE_ALIVE) continue;
+        
+        uint32_t buckets[SWIM_SYNC_BUCKETS];
+        swim_sync_digest(ctx, buckets, SWIM_SYNC_BUCKETS);
+        swim_send_digest(ctx, peer, SWIM_MSG_DIGEST, buckets);
+        return;
+    }
+}
+
+/**
+ * Digest received: send the entries the peer lacks and, for DIGEST, our
+ * own digest so it can push back what we lack. A digest folded to fit the
+ * sender's MTU is compared at its own resolution.
+ */
+static void swim_handle_digest(swim_context_t *ctx, swim_node_t *sender, uint8_t type,
+                               swim_wire_reader_t *r) {
+    uint32_t remote[SWIM_SYNC_BUCKETS];
+    uint32_t local[SWIM_SYNC_BUCKETS];
+    
+    int count = swim_wire_read_digest(r, remote, SWIM_SYNC_BUCKETS);
+    if (count <= 0 || (count & (count - 1)) != 0) {
+        log_warn("SWIM: Malformed digest from %s", sender->id);
+        return;
+    }
+    
+    swim_sync_digest(ctx, local, (uint32_t)count);
+    if (memcmp(local, remote, (size_t)count * sizeof(uint32_t)) == 0) return;
+    
+    swim_send_sync_diff(ctx, sender, local, remote, (uint32_t)count);
+    if (type == SWIM_MSG_DIGEST) {
+        if (count != SWIM_SYNC_BUCKETS) {
+            swim_sync_digest(ctx, local, SWIM_SYNC_BUCKETS);
+        }
+        swim_send_digest(ctx, sender, SWIM_MSG_DIGEST_REPLY, local);
+    }
+}
+
+/**
+ * Suspect node on behalf of accuser ("" if unknown)
+ */
+static void swim_suspect_node(swim_context_t *ctx, swim_node_t *node, const char *accuser) {
+    strncpy(node->accuser, accuser, SWIM_NODE_ID_SIZE - 1);
+    swim_update_node_state(ctx, node, NODE_STATE_SUSPECT);
+}
+
+/**
+ * Count an independent accuser of a suspected node: the suspicion timeout
+ * shrinks and the accusation is gossiped on
+ * @return true if the accuser was new
+ */
+static bool swim_confirm_suspicion(swim_context_t *ctx, swim_node_t *node, const char *accuser) {
+    if (!accuser[0] || !swim_detector_confirm(&node->detector, swim_hash_id(accuser))) return false;
+    
+    strncpy(node->accuser, accuser, SWIM_NODE_ID_SIZE - 1);
+    swim_timer_schedule(&ctx->timers, &node->suspect_timer,
+                        node->state_change_ms + swim_suspect_timeout(ctx, node));
+    swim_member_changed(ctx, node);
+    return true;
+}
+
+/**
+ * Another member believes this node is SUSPECT or DEAD: outbid the rumour
+ * with a higher incarnation
+ */
+static void swim_refute(swim_context_t *ctx, const swim_node_update_t *update) {
+    swim_node_t *local = ctx->local;
+    
+    if (!local || local->state == NODE_STATE_LEFT) return;
+    if (update->state != NODE_STATE_SUSPECT && update->state != NODE_STATE_DEAD) return;
+    if (update->incarnation < ctx->incarnation) return;
+    
+    ctx->incarnation = update->incarnation + 1;
+    local->incarnation = ctx->incarnation;
+    swim_member_changed(ctx, local);
+    ctx->self_refutes++;
+    swim_detector_on_refute(&ctx->detector);
+    
+    log_info("SWIM: Refuting suspicion raised by %s (incarnation %u)",
+             update->accuser[0] ? update->accuser : "unknown", ctx->incarnation);
+}
+
+/**
+ * Merge a membership update using SWIM precedence rules
+ * (higher incarnation wins; at equal incarnation DEAD > SUSPECT > ALIVE)
+ */
+static void swim_apply_update(swim_context_t *ctx, const swim_node_update_t *update) {
+    const char *id = update->id;
+    
+    if (update->state > NODE_STATE_LEFT) return;
+    if (strcmp(id, ctx->local_id) == 0) {
+        swim_refute(ctx, update);
+        return;
+    }
+    
+    swim_node_state_t state = (swim_node_state_t)update->state;
+    swim_node_t *node = swim_lookup(ctx, id);
+    
+    if (!node) {
+        // Don't resurrect nodes we never knew only to mark them dead
+        if (state == NODE_STATE_DEAD || state == NODE_STATE_LEFT) return;
+        
+        node = swim_create_node(ctx, id, update->address, update->port);
+        if (node) {
+            node->state = state;
+            node->incarnation = update->incarnation;
+            node->is_main_node = update->is_main_node != 0;
+            if (state == NODE_STATE_SUSPECT) {
+                strncpy(node->accuser, update->accuser, SWIM_NODE_ID_SIZE - 1);
+            }
+            swim_add_node(ctx, node);
+        }
+        return;
+    }
+    
+    bool newer = update->incarnation > node->incarnation;
+    
+    switch (state) {
+        case NODE_STATE_ALIVE:
+            if (!newer) return;
+            break;
+        case NODE_STATE_SUSPECT:
+            if (update->incarnation < node->incarnation) return;
+            if (!newer && node->state == NODE_STATE_SUSPECT) {
+                swim_confirm_suspicion(ctx, node, update->accuser);
+                return;
+            }
+            if (!newer && node->state != NODE_STATE_ALIVE) return;
+            break;
+        default:
+            if (update->incarnation < node->incarnation) return;
+            if (!newer && (node->state == NODE_STATE_DEAD || node->state == NODE_STATE_LEFT)) return;
+            break;
+    }
+    
+    node->incarnation = update->incarnation;
+    node->is_main_node = update->is_main_node != 0;
+    
+    if (node->state != state) {
+        if (state == NODE_STATE_SUSPECT) {
+            swim_suspect_node(ctx, node, update->accuser);
+        } else {
+            swim_update_node_state(ctx, node, state);
+        }
+    } else {
+        // Same state, newer incarnation: still news for the rest of the cluster
+        swim_member_changed(ctx, node);
+    }
+}
+
+/**
+ * Apply the update entries following a message header
+ */
+static void swim_apply_updates(swim_context_t *ctx, swim_wire_reader_t *r, const char *sender_id) {
+    swim_node_update_t update;
+    int rc;
+    
+    while ((rc = swim_wire_read_update(r, &update)) > 0) {
+        swim_apply_update(ctx, &update);
+    }
+    
+    if (rc < 0) {
+        log_warn("SWIM: Malformed update entry from %s", sender_id);
+    }
+}
+
+/**
+ * Encode every member (tombstones included, local first) as one SYNC
+ * message for a bootstrap exchange
+ * @return malloc'd message, or NULL on allocation failure
+ */
+static uint8_t* swim_encode_state(swim_context_t *ctx, size_t *len) {
+    size_t cap = 2 * SWIM_WIRE_UPDATE_MAX + (size_t)(ctx->node_count + 1) * SWIM_WIRE_UPDATE_MAX;
+    uint8_t *buffer = (uint8_t*)malloc(cap);
+    if (!buffer) return NULL;
+    
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    swim_node_update_t update;
+    
+    swim_fill_header(ctx, &header, SWIM_MSG_SYNC, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, cap);
+    swim_wire_write_header(&w, &header);
+    
+    if (ctx->local) {
+        swim_fill_update(&update, ctx->local);
+        swim_wire_write_update(&w, &update);
+    }
+    for (swim_node_t *node = ctx->nodes; node; node = node->next) {
+        if (node == ctx->local || node->placeholder) continue;
+        swim_fill_update(&update, node);
+        swim_wire_write_update(&w, &update);
+    }
+    
+    *len = w.len;
+    return buffer;
+}
+
+/**
+ * Merge the state a bootstrap peer sent. Members advertise themselves as
+ * 127.0.0.1, so the peer's own entry takes the address the exchange used.
+ * @param sender_id Set to the peer's id (may be NULL)
+ * @return Entries merged, or -1 if malformed
+ */
+static int swim_merge_state(swim_context_t *ctx, const char *address, const uint8_t *data, size_t len,
+                            char *sender_id) {
+    swim_wire_reader_t r;
+    swim_wire_header_t header;
+    swim_node_update_t update;
+    int entries = 0;
+    int rc;
+    
+    swim_wire_reader_init(&r, data, len);
+    if (swim_wire_read_header(&r, &header) != 0 || header.type != SWIM_MSG_SYNC) return -1;
+    
+    while ((rc = swim_wire_read_update(&r, &update)) > 0) {
+        if (strcmp(update.id, header.sender_id) == 0) {
+            strncpy(update.address, address, sizeof(update.address) - 1);
+            update.address[sizeof(update.address) - 1] = '\0';
+        }
+        swim_apply_update(ctx, &update);
+        entries++;
+    }
+    if (rc < 0) {
+        log_warn("SWIM: Malformed bootstrap state from %s", header.sender_id);
+        return -1;
+    }
+    
+    ctx->bootstrap_entries += (uint64_t)entries;
+    if (sender_id) memcpy(sender_id, header.sender_id, SWIM_NODE_ID_SIZE);
+    return entries;
+}
+
+/**
+ * A message came from the address of a seed joined over UDP: the sender's
+ * real entry takes over from the placeholder
+ */
+static void swim_reconcile_seed(swim_context_t *ctx, const swim_node_t *sender, const struct sockaddr_in *from) {
+    for (uint32_t i = 0; i < SWIM_JOIN_SEEDS; i++) {
+        swim_node_t *seed = ctx->join_seeds[i];
+        if (!seed) continue;
+        
+        struct sockaddr_in addr;
+        swim_node_sockaddr(seed, &addr);
+        if (addr.sin_port != from->sin_port || addr.sin_addr.s_addr != from->sin_addr.s_addr) continue;
+        
+        log_info("SWIM: Seed %s answered as %s", seed->id, sender->id);
+        
+        // Cancels its pending join event, or reports it gone
+        swim_queue_event(ctx, seed, seed->state, NODE_STATE_DEAD);
+        swim_remove_node(ctx, seed->id);
+    }
+}
+
+/**
+ * Probe of node answered (directly or through a helper)
+ */
+static void swim_probe_acked(swim_context_t *ctx, swim_node_t *node) {
+    node->probe_pending = false;
+    node->probe_failed = false;
+    node->last_ack_ms = swim_now_ms(ctx);
+    swim_timer_cancel(&ctx->timers, &node->probe_timer);
+    ctx->probe_success++;
+}
+
+/**
+ * PING target on behalf of a PING_REQ from requester
+ */
+static void swim_relay_ping(swim_context_t *ctx, swim_node_t *requester, swim_node_t *target,
+                            uint32_t requester_seq) {
+    uint32_t seq = ++ctx->seq_num;
+    swim_relay_t *relay = &ctx->relays[seq % SWIM_RELAY_SLOTS];
+    
+    relay->seq = seq;
+    relay->requester_seq = requester_seq;
+    relay->target_hash = target->id_hash;
+    relay->requester = requester;
+    relay->expires_ms = swim_now_ms(ctx) + 2 * swim_detector_scale(&ctx->detector, ctx->probe_timeout_ms);
+    
+    // Own probe state of target is left alone: this PING has its own seq
+    swim_send_message(ctx, target, SWIM_MSG_PING, seq, target->id);
+}
+
+/**
+ * ACK for a relayed PING: pass it on to the requester
+ * @return true if seq belonged to a relay
+ */
+static bool swim_relay_ack(swim_context_t *ctx, const swim_node_t *sender, uint32_t seq) {
+    swim_relay_t *relay = &ctx->relays[seq % SWIM_RELAY_SLOTS];
+    
+    if (!relay->requester || relay->seq != seq || relay->target_hash != sender->id_hash) return false;
+    
+    if (swim_now_ms(ctx) <= relay->expires_ms) {
+        swim_send_ack(ctx, relay->requester, relay->requester_seq);
+        ctx->relayed_acks++;
+    }
+    relay->requester = NULL;
+    return true;
+}
+
+/**
+ * ACK relayed by a helper for one of our outstanding probes
+ */
+static void swim_indirect_ack(swim_context_t *ctx, const swim_node_t *helper, uint32_t seq) {
+    swim_node_t *target = ctx->probe_by_seq[seq % SWIM_PROBE_SEQ_SLOTS];
+    
+    if (!target || target == helper || helper->is_local) return;
+    if (!target->probe_pending || target->ping_seq != seq) return;
+    
+    log_debug("SWIM: %s answered through %s", target->id, helper->id);
+    swim_probe_acked(ctx, target);
+    ctx->indirect_acks++;
+    
+    if (target->state == NODE_STATE_SUSPECT) {
+        swim_update_node_state(ctx, target, NODE_STATE_ALIVE);
+    }
+}
+
+/**
+ * 64-bit FNV-1a of a member id, never 0 (which marks an unused entry)
+ */
+static uint64_t swim_user_origin(const char *origin) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const char *p = origin; *p; p++) {
+        h ^= (uint8_t)*p;
+        h *= 0x100000001B3ull;
+    }
+    return h ? h : 1;
+}
+
+/**
+ * Set of SWIM_USER_SEEN_WAYS entries a user message key lives in
+ */
+static swim_user_key_t* swim_user_set(swim_context_t *ctx, uint64_t origin, uint32_t seq) {
+    uint64_t h = (origin ^ seq) * 0x9E3779B97F4A7C15ull;
+    uint32_t set = (uint32_t)(h >> 32) & (SWIM_USER_SEEN / SWIM_USER_SEEN_WAYS - 1);
+    return &ctx->user_seen[set * SWIM_USER_SEEN_WAYS];
+}
+
+/**
+ * Entry recording the key within SWIM_USER_SEEN_MS, or NULL
+ */
+static swim_user_key_t* swim_user_find(swim_user_key_t *set, uint64_t origin, uint32_t seq, uint32_t now) {
+    for (uint32_t i = 0; i < SWIM_USER_SEEN_WAYS; i++) {
+        swim_user_key_t *key = &set[i];
+        if (key->origin == origin && key->seq == seq && now - key->seen_ms < SWIM_USER_SEEN_MS) {
+            return key;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Remember a user message key
+ * @return true if it was seen recently (a duplicate)
+ */
+static bool swim_user_seen(swim_context_t *ctx, const char *origin, uint32_t seq) {
+    uint64_t id = swim_user_origin(origin);
+    uint32_t now = (uint32_t)swim_now_ms(ctx);
+    swim_user_key_t *set = swim_user_set(ctx, id, seq);
+    
+    if (swim_user_find(set, id, seq, now)) return true;
+    
+    // An unused or expired entry, else the oldest
+    swim_user_key_t *victim = &set[0];
+    for (uint32_t i = 0; i < SWIM_USER_SEEN_WAYS; i++) {
+        swim_user_key_t *key = &set[i];
+        if (!key->origin || now - key->seen_ms >= SWIM_USER_SEEN_MS) {
+            victim = key;
+            break;
+        }
+        if (now - key->seen_ms > now - victim->seen_ms) victim = key;
+    }
+    victim->origin = id;
+    victim->seq = seq;
+    victim->seen_ms = now;
+    return false;
+}
+
+/**
+ * Whether a user message was seen recently, without recording it
+ */
+static bool swim_user_known(swim_context_t *ctx, const char *origin, uint32_t seq) {
+    uint64_t id = swim_user_origin(origin);
+    return swim_user_find(swim_user_set(ctx, id, seq), id, seq, (uint32_t)swim_now_ms(ctx)) != NULL;
+}
+
+/**
+ * Queue a user message for on_message (delivered outside the lock)
+ */
+static void swim_queue_user(swim_context_t *ctx, swim_node_t *from, const uint8_t *payload, size_t len) {
+    ctx->user_received++;
+    if (!ctx->on_message) return;
+    
+    struct swim_user_msg *msg = NULL;
+    if (ctx->user_queued < SWIM_USER_QUEUE) {
+        msg = (struct swim_user_msg*)malloc(sizeof(struct swim_user_msg) + len);
+    }
+    if (!msg) {
+        ctx->user_dropped++;
+        return;
+    }
+    
+    // A sender removed before on_message runs stays allocated until it has
+    if (!ctx->user_pinned) {
+        swim_epoch_enter(&ctx->epoch, &ctx->user_guard);
+        ctx->user_pinned = true;
+    }
+    
+    msg->next = NULL;
+    msg->from = from;
+    msg->len = len;
+    memcpy(msg->data, payload, len);
+    
+    if (ctx->user_tail) {
+        ctx->user_tail->next = msg;
+    } else {
+        ctx->user_head = msg;
+    }
+    ctx->user_tail = msg;
+    ctx->user_queued++;
+}
+
+/**
+ * Encode a user message (USER or PUSH) with piggybacked updates and send it
+ */
+static int swim_send_user(swim_context_t *ctx, swim_node_t *to, uint8_t type, const swim_wire_user_t *user) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    
+    swim_fill_header(ctx, &header, type, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    if (swim_wire_write_user(&w, user) != 0) return -1;
+    swim_write_piggyback(ctx, &w);
+    
+    return swim_send_raw(ctx, to, buffer, w.len);
+}
+
+/**
+ * Send a user message to up to fanout random live members
+ * @return Members sent to
+ */
+static uint32_t swim_user_fanout(swim_context_t *ctx, const swim_wire_user_t *user,
+                                 const swim_node_t *skip_a, const swim_node_t *skip_b, uint32_t fanout) {
+    uint32_t count = ctx->probe_count;
+    if (count == 0) return 0;
+    
+    // Walk the shuffled probe order from a random point
+    uint32_t start = swim_rand_below(&ctx->rng, count);
+    uint32_t sent = 0;
+    
+    for (uint32_t i = 0; i < count && sent < fanout; i++) {
+        swim_node_t *node = ctx->probe_order[(start + i) % count];
+        if (node == skip_a || node == skip_b || node->state != NODE_STATE_ALIVE) continue;
+        if (swim_send_user(ctx, node, SWIM_MSG_USER, user) == 0) sent++;
+    }
+    
+    return sent;
+}
+
+/**
+ * Gossip hops for a broadcast: enough for log2(members) doublings and some slack
+ */
+static uint8_t swim_broadcast_hops(swim_context_t *ctx) {
+    uint32_t hops = SWIM_BROADCAST_HOPS_EXTRA;
+    for (uint32_t n = ctx->probe_count + 1; n > 1; n >>= 1) hops++;
+    return (uint8_t)(hops > UINT8_MAX ? UINT8_MAX : hops);
+}
+
+/**
+ * User message received: deliver it once, and pass it on while it has hops left
+ */
+static void swim_handle_user(swim_context_t *ctx, swim_node_t *sender, const swim_wire_user_t *user) {
+    if (swim_user_seen(ctx, user->origin, user->origin_seq)) {
+        ctx->user_duplicates++;
+        return;
+    }
+    
+    swim_node_t *origin = swim_lookup(ctx, user->origin);
+    swim_queue_user(ctx, origin ? origin : sender, user->payload, user->len);
+    
+    if (user->hops > 0) {
+        swim_wire_user_t next = *user;
+        next.hops--;
+        uint32_t fanout = ctx->broadcast_fanout ? ctx->broadcast_fanout : SWIM_BROADCAST_FANOUT;
+        ctx->user_forwarded += swim_user_fanout(ctx, &next, sender, origin, fanout);
+    }
+}
+
+/**
+ * Random nonzero channel session id
+ */
+static uint32_t swim_channel_session(swim_context_t *ctx) {
+    uint32_t session;
+    do {
+        session = (uint32_t)swim_rand_next(&ctx->rng);
+    } while (session == 0);
+    return session;
+}
+
+/**
+ * Channel to node, created on first use
+ */
+static swim_channel_t* swim_channel_get(swim_context_t *ctx, swim_node_t *node) {
+    if (!node->channel) {
+        node->channel = swim_channel_create(swim_channel_session(ctx));
+        if (!node->channel) log_error("SWIM: Failed to allocate channel to %s", node->id);
+    }
+    return node->channel;
+}
+
+/**
+ * Message outcome: count it and queue it for on_reliable
+ */
+static void swim_channel_done(void *arg, uint32_t msg_id, bool delivered) {
+    swim_channel_link_t *link = (swim_channel_link_t*)arg;
+    swim_context_t *ctx = link->ctx;
+    
+    if (delivered) {
+        ctx->channel_acked++;
+    } else {
+        ctx->channel_failed++;
+    }
+    if (!ctx->on_reliable) return;
+    
+    struct swim_reliable_done *done = (struct swim_reliable_done*)calloc(1, sizeof(*done));
+    if (!done) return;
+    strncpy(done->node_id, link->node->id, SWIM_NODE_ID_SIZE - 1);
+    done->msg_id = msg_id;
+    done->delivered = delivered;
+    
+    if (ctx->reliable_tail) {
+        ctx->reliable_tail->next = done;
+    } else {
+        ctx->reliable_head = done;
+    }
+    ctx->reliable_tail = done;
+}
+
+/**
+ * Reassembled message: deliver it like a user message from the member
+ */
+static void swim_channel_deliver(void *arg, const uint8_t *msg, size_t len) {
+    swim_channel_link_t *link = (swim_channel_link_t*)arg;
+    
+    link->ctx->channel_received++;
+    swim_queue_user(link->ctx, link->node, msg, len);
+}
+
+/**
+ * Drop node's channel, reporting its unacknowledged messages undelivered
+ */
+static void swim_channel_close(swim_context_t *ctx, swim_node_t *node) {
+    if (!node->channel) return;
+    
+    swim_channel_link_t link = { ctx, node };
+    swim_timer_cancel(&ctx->timers, &node->channel_timer);
+    swim_channel_destroy(node->channel, swim_channel_done, &link);
+    node->channel = NULL;
+}
+
+/**
+ * Largest fragment a DATA message carries within the MTU
+ */
+static uint32_t swim_channel_frag_size(swim_context_t *ctx) {
+    return ctx->mtu - SWIM_WIRE_DATA_OVERHEAD - (uint32_t)strlen(ctx->local_id);
+}
+
+/**
+ * Encode one channel fragment and send it (no piggyback, so fragments cut
+ * for the current MTU always fit; ones cut before swim_set_mtu lowered it
+ * are not sent, and their message fails once retries run out)
+ */
+static int swim_send_data(swim_context_t *ctx, swim_node_t *to, uint32_t seq) {
+    const swim_channel_frag_t *frag = swim_channel_frag(to->channel, seq);
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    swim_wire_data_t data;
+    
+    data.session = to->channel->session;
+    data.seq = seq;
+    data.flags = frag->flags;
+    data.payload = frag->msg + frag->offset;
+    data.len = frag->len;
+    
+    swim_fill_header(ctx, &header, SWIM_MSG_DATA, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    if (swim_wire_write_data(&w, &data) != 0) return -1;
+    
+    return swim_send_raw(ctx, to, buffer, w.len);
+}
+
+/**
+ * Acknowledge what node's channel has received
+ */
+static int swim_send_data_ack(swim_context_t *ctx, swim_node_t *to) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    swim_wire_data_ack_t ack;
+    
+    ack.session = to->channel->peer_session;
+    swim_channel_ack_state(to->channel, &ack.cum, &ack.window, &ack.sack);
+    to->channel->ack_pending = false;
+    
+    swim_fill_header(ctx, &header, SWIM_MSG_DATA_ACK, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    if (swim_wire_write_data_ack(&w, &ack) != 0) return -1;
+    
+    return swim_send_raw(ctx, to, buffer, w.len);
+}
+
+/**
+ * Send the DATA_ACKs owed since the last flush, one per member for however
+ * many fragments it sent
+ */
+static void swim_channel_send_acks(swim_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->channel_ack_count; i++) {
+        swim_node_t *node = ctx->channel_acks[i];
+        node->channel_ack_queued = false;
+        if (node->channel && node->channel->ack_pending) {
+            swim_send_data_ack(ctx, node);
+        }
+    }
+    ctx->channel_ack_count = 0;
+}
+
+/**
+ * Send whatever node's channel has due, and arm its retransmission timer
+ */
+static void swim_channel_pump(swim_context_t *ctx, swim_node_t *node) {
+    swim_channel_t *ch = node->channel;
+    uint64_t rto_us = (uint64_t)swim_rtt_timeout_ms(&node->rtt, ctx->probe_timeout_ms) * 1000;
+    uint64_t now_us = swim_now_us(ctx);
+    uint32_t seq;
+    int rc;
+    
+    while ((rc = swim_channel_next(ch, now_us, rto_us, &seq)) > 0) {
+        swim_send_data(ctx, node, seq);
+        if (rc == 1) {
+            ctx->channel_fragments++;
+        } else {
+            ctx->channel_retransmits++;
+        }
+    }
+    
+    if (rc < 0) {
+        // The member stopped acknowledging; fail what is queued and start over
+        log_warn("SWIM: Reliable channel to %s unacknowledged after %d sends, resetting",
+                 node->id, SWIM_CHANNEL_MAX_RETRIES);
+        swim_channel_link_t link = { ctx, node };
+        swim_channel_reset(ch, swim_channel_session(ctx), swim_channel_done, &link);
+    }
+    
+    uint64_t deadline = swim_channel_deadline(ch, rto_us);
+    if (deadline == UINT64_MAX) {
+        swim_timer_cancel(&ctx->timers, &node->channel_timer);
+    } else {
+        swim_timer_schedule(&ctx->timers, &node->channel_timer, (deadline + 999) / 1000);
+    }
+}
+
+/**
+ * Channel fragment received: reassemble, and owe the sender an ACK
+ */
+static void swim_handle_data(swim_context_t *ctx, swim_node_t *sender, const swim_wire_data_t *data) {
+    // Unacknowledged, the fragment is resent once the queue has drained
+    if (ctx->on_message && ctx->user_queued + SWIM_CHANNEL_WINDOW > SWIM_USER_QUEUE) return;
+    
+    swim_channel_t *ch = swim_channel_get(ctx, sender);
+    if (!ch) return;
+    
+    swim_channel_link_t link = { ctx, sender };
+    swim_channel_on_data(ch, data->session, data->seq, data->flags, data->payload, data->len,
+                         swim_channel_deliver, &link);
+    
+    if (sender->channel_ack_queued) return;
+    if (ctx->channel_ack_count < SWIM_OUTBOX_MAX) {
+        ctx->channel_acks[ctx->channel_ack_count++] = sender;
+        sender->channel_ack_queued = true;
+    } else {
+        swim_send_data_ack(ctx, sender);
+    }
+}
+
+/**
+ * Channel acknowledgement received: release what it covers, send what it allows
+ */
+static void swim_handle_data_ack(swim_context_t *ctx, swim_node_t *sender, const swim_wire_data_ack_t *ack) {
+    if (!sender->channel) return;
+    
+    swim_channel_link_t link = { ctx, sender };
+    uint64_t rtt_us = swim_channel_on_ack(sender->channel, ack->session, ack->cum, ack->window, ack->sack,
+                                          swim_now_us(ctx), swim_channel_done, &link);
+    
+    // Acknowledged fragments time the path like probes do
+    if (rtt_us > 0) swim_rtt_sample(&sender->rtt, rtt_us);
+    swim_channel_pump(ctx, sender);
+}
+
+/**
+ * Forwarding fanout of a member whose broadcast mode has none
+ */
+static uint32_t swim_forward_fanout(swim_context_t *ctx) {
+    return ctx->broadcast_fanout ? ctx->broadcast_fanout : SWIM_BROADCAST_FANOUT;
+}
+
+/**
+ * Add node to, or drop it from, the broadcast tree
+ */
+static void swim_tree_set_eager(swim_context_t *ctx, swim_node_t *node, bool eager) {
+    if (node->tree_eager == eager) return;
+    node->tree_eager = eager;
+    if (eager) {
+        ctx->tree_eager_count++;
+    } else {
+        ctx->tree_eager_count--;
+    }
+}
+
+/**
+ * Send an IHAVE or GRAFT for one broadcast (GRAFT with none just adds
+ * the edge), or a PRUNE
+ */
+static int swim_send_tree(swim_context_t *ctx, swim_node_t *to, uint8_t type,
+                          const swim_wire_msgid_t *id) {
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    
+    swim_fill_header(ctx, &header, type, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0) return -1;
+    if (type != SWIM_MSG_PRUNE && swim_wire_write_ids(&w, id, id ? 1 : 0) != 0) return -1;
+    swim_write_piggyback(ctx, &w);
+    
+    switch (type) {
+        case SWIM_MSG_IHAVE: ctx->tree_ihave_sent++; break;
+        case SWIM_MSG_GRAFT: ctx->tree_graft_sent++; break;
+        case SWIM_MSG_PRUNE: ctx->tree_prune_sent++; break;
+    }
+    return swim_send_raw(ctx, to, buffer, w.len);
+}
+
+/**
+ * Random live member outside the tree, other than skip (NULL if none)
+ */
+static swim_node_t* swim_tree_pick_lazy(swim_context_t *ctx, const swim_node_t *skip) {
+    uint32_t count = ctx->probe_count;
+    if (count == 0) return NULL;
+    
+    uint32_t start = swim_rand_below(&ctx->rng, count);
+    for (uint32_t i = 0; i < count; i++) {
+        swim_node_t *node = ctx->probe_order[(start + i) % count];
+        if (node != skip && !node->tree_eager && node->state == NODE_STATE_ALIVE) return node;
+    }
+    return NULL;
+}
+
+/**
+ * Send a broadcast on: PUSH to tree neighbours, IHAVE to fanout others
+ * @return PUSHes sent
+ */
+static uint32_t swim_tree_forward(swim_context_t *ctx, const swim_wire_user_t *user, const swim_node_t *from) {
+    uint32_t fanout = swim_forward_fanout(ctx);
+    
+    // First use, or every edge failed: start from fanout random edges,
+    // which PRUNEs then thin to a tree
+    if (!ctx->tree_seeded || ctx->tree_eager_count == 0) {
+        ctx->tree_seeded = true;
+        while (ctx->tree_eager_count < fanout) {
+            swim_node_t *node = swim_tree_pick_lazy(ctx, NULL);
+            if (!node) break;
+            swim_tree_set_eager(ctx, node, true);
+        }
+    }
+    
+    uint32_t pushed = 0;
+    uint32_t announced = 0;
+    swim_wire_msgid_t id;
+    memcpy(id.origin, user->origin, SWIM_WIRE_ID_SIZE);
+    id.origin_seq = user->origin_seq;
+    
+    // Walk the shuffled probe order from a random point, so IHAVEs spread
+    uint32_t count = ctx->probe_count;
+    uint32_t start = count ? swim_rand_below(&ctx->rng, count) : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        swim_node_t *node = ctx->probe_order[(start + i) % count];
+        if (node == from || node->state != NODE_STATE_ALIVE) continue;
+        
+        if (node->tree_eager) {
+            if (swim_send_user(ctx, node, SWIM_MSG_PUSH, user) == 0) pushed++;
+        } else if (announced < fanout) {
+            if (swim_send_tree(ctx, node, SWIM_MSG_IHAVE, &id) == 0) announced++;
+        }
+    }
+    
+    return pushed;
+}
+
+/**
+ * PUSH received: deliver and pass on the first copy; a later copy means
+ * the sender's edge is redundant
+ */
+static void swim_handle_push(swim_context_t *ctx, swim_node_t *sender, const swim_wire_user_t *user) {
+    uint32_t origin_hash = swim_hash_id(user->origin);
+    
+    if (swim_user_seen(ctx, user->origin, user->origin_seq)) {
+        ctx->user_duplicates++;
+        if (sender->tree_eager) {
+            swim_tree_set_eager(ctx, sender, false);
+            swim_send_tree(ctx, sender, SWIM_MSG_PRUNE, NULL);
+        }
+        return;
+    }
+    
+    swim_tree_missing_t *missing = swim_tree_missing_find(&ctx->tree, origin_hash, user->origin_seq);
+    if (missing) {
+        swim_timer_cancel(&ctx->timers, &missing->timer);
+        swim_tree_missing_remove(missing);
+    }
+    
+    // Edges are symmetric: whoever pushes to us is pushed to
+    swim_tree_set_eager(ctx, sender, true);
+    
+    swim_node_t *origin = swim_lookup(ctx, user->origin);
+    swim_queue_user(ctx, origin ? origin : sender, user->payload, user->len);
+    swim_tree_store(&ctx->tree, user->origin, origin_hash, user->origin_seq, user->payload, user->len);
+    ctx->user_forwarded += swim_tree_forward(ctx, user, sender);
+}
+
+/**
+ * IHAVE received: await the announced messages we lack
+ */
+static void swim_handle_ihave(swim_context_t *ctx, swim_node_t *sender, const swim_wire_msgid_t *ids,
+                              uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t origin_hash = swim_hash_id(ids[i].origin);
+        if (swim_user_known(ctx, ids[i].origin, ids[i].origin_seq)) continue;
+        
+        swim_tree_missing_t *missing = swim_tree_missing_find(&ctx->tree, origin_hash, ids[i].origin_seq);
+        if (!missing) {
+            missing = swim_tree_missing_add(&ctx->tree, ids[i].origin, origin_hash, ids[i].origin_seq);
+            if (!missing) continue;
+            swim_timer_schedule(&ctx->timers, &missing->timer, swim_now_ms(ctx) + SWIM_TREE_GRAFT_TIMEOUT);
+        }
+        swim_tree_missing_announce(missing, sender);
+    }
+}
+
+/**
+ * GRAFT received: the sender joins the tree, and gets what it asked for
+ */
+static void swim_handle_graft(swim_context_t *ctx, swim_node_t *sender, const swim_wire_msgid_t *ids,
+                              uint32_t count) {
+    swim_tree_set_eager(ctx, sender, true);
+    
+    for (uint32_t i = 0; i < count; i++) {
+        const swim_tree_msg_t *msg = swim_tree_find(&ctx->tree, swim_hash_id(ids[i].origin), ids[i].origin_seq);
+        if (!msg) continue;
+        
+        swim_wire_user_t user;
+        memset(&user, 0, sizeof(user));
+        memcpy(user.origin, msg->origin, SWIM_WIRE_ID_SIZE);
+        user.origin_seq = msg->seq;
+        user.payload = msg->data;
+        user.len = msg->len;
+        swim_send_user(ctx, sender, SWIM_MSG_PUSH, &user);
+    }
+}
+
+/**
+ * An announced message did not arrive in time: GRAFT onto the next live
+ * announcer, and wait for it in turn
+ */
+static void swim_tree_graft_due(swim_context_t *ctx, swim_tree_missing_t *missing) {
+    swim_node_t *node;
+    while ((node = swim_tree_missing_next(missing)) != NULL) {
+        if (node->state != NODE_STATE_ALIVE) continue;
+        
+        swim_wire_msgid_t id;
+        memcpy(id.origin, missing->origin, SWIM_WIRE_ID_SIZE);
+        id.origin_seq = missing->seq;
+        swim_tree_set_eager(ctx, node, true);
+        swim_send_tree(ctx, node, SWIM_MSG_GRAFT, &id);
+        
+        if (missing->announcer_count > 0) {
+            swim_timer_schedule(&ctx->timers, &missing->timer, swim_now_ms(ctx) + SWIM_TREE_GRAFT_TIMEOUT / 2);
+            return;
+        }
+        break;
+    }
+    swim_tree_missing_remove(missing);
+}
+
+/**
+ * A tree neighbour is SUSPECT, DEAD or gone: replace its edge with one to
+ * a random live member
+ */
+static void swim_tree_repair(swim_context_t *ctx, swim_node_t *node) {
+    if (!node->tree_eager) return;
+    
+    swim_tree_set_eager(ctx, node, false);
+    swim_node_t *replacement = swim_tree_pick_lazy(ctx, node);
+    if (replacement) {
+        swim_tree_set_eager(ctx, replacement, true);
+        swim_send_tree(ctx, replacement, SWIM_MSG_GRAFT, NULL);
+    }
+}
+
+/**
+ * Handle incoming message
+ */
+static void swim_handle_message(swim_context_t *ctx, const struct sockaddr_in *from, 
+                                 const uint8_t *data, size_t len) {
+    swim_wire_reader_t r;
+    swim_wire_header_t header;
+    
+    swim_wire_reader_init(&r, data, len);
+    if (swim_wire_read_header(&r, &header) != 0) {
+        log_warn("SWIM: Dropping malformed message (version %d, %d bytes)",
+                 len ? data[0] : 0, (int)len);
+        return;
+    }
+    
+    if (swim_dedup_seen(&ctx->dedup, swim_hash_id(header.sender_id), header.seq_num, header.type,
+                        swim_now_ms(ctx))) {
+        ctx->duplicates_dropped++;
+        return;
+    }
+    
+    ctx->messages_received++;
+    
+    // Find or create sender node
+    char sender_addr[64];
+    inet_ntop(AF_INET, &from->sin_addr, sender_addr, sizeof(sender_addr));
+    
+    swim_node_t *sender = swim_lookup(ctx, header.sender_id);
+    if (!sender) {
+        // Create new node
+        sender = swim_create_node(ctx, header.sender_id, sender_addr, ntohs(from->sin_port));
+        if (sender) {
+            sender->incarnation = header.incarnation;
+            sender = swim_add_node(ctx, sender);
+        }
+    }
+    
+    if (sender) {
+        sender->last_seen_ms = swim_now_ms(ctx);
+        if (header.incarnation > sender->incarnation) {
+            sender->incarnation = header.incarnation;
+            swim_member_changed(ctx, sender);
+        }
+        if (sender->state != NODE_STATE_ALIVE) {
+            swim_update_node_state(ctx, sender, NODE_STATE_ALIVE);
+        }
+        if (header.has_coord && !sender->is_local && swim_coord_valid(&header.coord)) {
+            sender->coord = header.coord;
+            sender->has_coord = true;
+        }
+        if (!sender->placeholder) {
+            swim_reconcile_seed(ctx, sender, from);
+        }
+    }
+    
+    switch (header.type) {
+        case SWIM_MSG_PING:
+            log_debug("SWIM: Received PING from %s", header.sender_id);
+            if (sender) {
+                swim_send_ack(ctx, sender, header.seq_num);
+            }
+            break;
+            
+        case SWIM_MSG_PING_REQ: {
+            log_debug("SWIM: Received PING_REQ from %s", header.sender_id);
+            swim_node_t *target = swim_lookup(ctx, header.target_id);
+            if (!sender || !target) break;
+            
+            if (target == ctx->local) {
+                swim_send_ack(ctx, sender, header.seq_num);
+            } else {
+                swim_relay_ping(ctx, sender, target, header.seq_num);
+            }
+            break;
+        }
+        
+        case SWIM_MSG_ACK:
+            log_debug("SWIM: Received ACK from %s", header.sender_id);
+            if (sender) {
+                if (sender->probe_pending && header.seq_num == sender->ping_seq) {
+                    uint64_t rtt_us = swim_now_us(ctx) - sender->probe_sent_us;
+                    ctx->ack_samples++;
+                    ctx->ack_total_us += rtt_us;
+                    if (rtt_us > ctx->ack_max_us) ctx->ack_max_us = rtt_us;
+                    swim_rtt_sample(&sender->rtt, rtt_us);
+                    if (sender->has_coord && !sender->is_local &&
+                        swim_coord_update(&ctx->local->coord, &sender->coord, (double)rtt_us / 1000.0,
+                                          swim_rand_next(&ctx->rng))) {
+                        ctx->coord_updates++;
+                    }
+                    swim_detector_on_ack(&ctx->detector, sender, (double)rtt_us / 1000.0);
+                    swim_probe_acked(ctx, sender);
+                } else if (!swim_relay_ack(ctx, sender, header.seq_num)) {
+                    swim_indirect_ack(ctx, sender, header.seq_num);
+                }
+                if (sender->state == NODE_STATE_SUSPECT) {
+                    swim_update_node_state(ctx, sender, NODE_STATE_ALIVE);
+                }
+            }
+            break;
+            
+        case SWIM_MSG_SYNC:
+            log_debug("SWIM: Received SYNC from %s", header.sender_id);
+            break;
+            
+        case SWIM_MSG_USER: {
+            swim_wire_user_t user;
+            if (swim_wire_read_user(&r, &user) != 0) {
+                log_warn("SWIM: Malformed user message from %s", header.sender_id);
+                return;
+            }
+            if (sender) {
+                swim_handle_user(ctx, sender, &user);
+            }
+            break;
+        }
+        
+        case SWIM_MSG_PUSH: {
+            swim_wire_user_t user;
+            if (swim_wire_read_user(&r, &user) != 0) {
+                log_warn("SWIM: Malformed broadcast from %s", header.sender_id);
+                return;
+            }
+            if (sender && !sender->is_local) {
+                swim_handle_push(ctx, sender, &user);
+            }
+            break;
+        }
+        
+        case SWIM_MSG_IHAVE:
+        case SWIM_MSG_GRAFT: {
+            swim_wire_msgid_t ids[SWIM_TREE_IDS_MAX];
+            int count = swim_wire_read_ids(&r, ids, SWIM_TREE_IDS_MAX);
+            if (count < 0) {
+                log_warn("SWIM: Malformed broadcast ids from %s", header.sender_id);
+                return;
+            }
+            if (!sender || sender->is_local) break;
+            if (header.type == SWIM_MSG_IHAVE) {
+                swim_handle_ihave(ctx, sender, ids, (uint32_t)count);
+            } else {
+                swim_handle_graft(ctx, sender, ids, (uint32_t)count);
+            }
+            break;
+        }
+        
+        case SWIM_MSG_PRUNE:
+            if (sender) {
+                swim_tree_set_eager(ctx, sender, false);
+            }
+            break;
+        
+        case SWIM_MSG_DATA: {
+            // Channel messages carry no piggyback
+            swim_wire_data_t data;
+            if (swim_wire_read_data(&r, &data) != 0) {
+                log_warn("SWIM: Malformed channel fragment from %s", header.sender_id);
+                return;
+            }
+            if (sender && !sender->is_local) {
+                swim_handle_data(ctx, sender, &data);
+            }
+            return;
+        }
+        
+        case SWIM_MSG_DATA_ACK: {
+            swim_wire_data_ack_t ack;
+            if (swim_wire_read_data_ack(&r, &ack) != 0) {
+                log_warn("SWIM: Malformed channel acknowledgement from %s", header.sender_id);
+                return;
+            }
+            if (sender && !sender->is_local) {
+                swim_handle_data_ack(ctx, sender, &ack);
+            }
+            return;
+        }
+        
+        case SWIM_MSG_DIGEST:
+        case SWIM_MSG_DIGEST_REPLY:
+            log_debug("SWIM: Received digest from %s", header.sender_id);
+            if (sender) {
+                swim_handle_digest(ctx, sender, header.type, &r);
+            }
+            return;
+        
+        default:
+            log_warn("SWIM: Unknown message type: %d", header.type);
+            return;
+    }
+    
+    // SYNC entries and piggybacked updates share the same encoding
+    swim_apply_updates(ctx, &r, header.sender_id);
+}
+
+/**
+ * Handle incoming datagram: a single message, or a COMPOUND of them
+ */
+static void swim_handle_datagram(swim_context_t *ctx, const struct sockaddr_in *from,
+                                 const uint8_t *data, size_t len) {
+    swim_wire_reader_t r;
+    swim_wire_reader_init(&r, data, len);
+    if (swim_wire_read_compound(&r) != 0) {
+        swim_handle_message(ctx, from, data, len);
+        return;
+    }
+    
+    ctx->compound_received++;
+    
+    const uint8_t *part;
+    size_t part_len;
+    int rc;
+    while ((rc = swim_wire_read_part(&r, &part, &part_len)) > 0) {
+        swim_handle_message(ctx, from, part, part_len);
+    }
+    if (rc < 0) {
+        log_warn("SWIM: Dropping rest of malformed compound message (%d bytes)", (int)len);
+    }
+}
+
+/**
+ * Add node to the probe order at a random not-yet-probed position,
+ * so it is probed within the current pass
+ */
+static void swim_probe_insert(swim_context_t *ctx, swim_node_t *node) {
+    if (node->in_probe_list) return;
+    
+    if (ctx->probe_count == ctx->probe_capacity) {
+        uint32_t capacity = ctx->probe_capacity ? ctx->probe_capacity * 2 : 64;
+        swim_node_t **order = (swim_node_t**)realloc(ctx->probe_order, capacity * sizeof(swim_node_t*));
+        if (!order) {
+            log_error("SWIM: Failed to grow probe order");
+            return;
+        }
+        ctx->probe_order = order;
+        ctx->probe_capacity = capacity;
+    }
+    
+    uint32_t pos = ctx->probe_cursor +
+                   swim_rand_below(&ctx->rng, ctx->probe_count - ctx->probe_cursor + 1);
+    
+    // Displaced member moves to the end (still unprobed this pass)
+    if (pos < ctx->probe_count) {
+        swim_node_t *moved = ctx->probe_order[pos];
+        ctx->probe_order[ctx->probe_count] = moved;
+        moved->probe_slot = ctx->probe_count;
+    }
+    
+    ctx->probe_order[pos] = node;
+    node->probe_slot = pos;
+    node->in_probe_list = true;
+    ctx->probe_count++;
+}
+
+/**
+ * Remove node from the probe order in O(1) without disturbing the pass
+ */
+static void swim_probe_remove(swim_context_t *ctx, swim_node_t *node) {
+    if (!node->in_probe_list) return;
+    
+    uint32_t slot = node->probe_slot;
+    
+    // Slot already probed this pass: backfill it from the last probed slot
+    if (slot < ctx->probe_cursor) {
+        ctx->probe_cursor--;
+        swim_node_t *moved = ctx->probe_order[ctx->probe_cursor];
+        ctx->probe_order[slot] = moved;
+        moved->probe_slot = slot;
+        slot = ctx->probe_cursor;
+    }
+    
+    // Fill the (now unprobed) hole from the end
+    ctx->probe_count--;
+    if (slot != ctx->probe_count) {
+        swim_node_t *moved = ctx->probe_order[ctx->probe_count];
+        ctx->probe_order[slot] = moved;
+        moved->probe_slot = slot;
+    }
+    
+    node->in_probe_list = false;
+}
+
+/**
+ * Next member to probe; reshuffles (Fisher-Yates) at the end of each pass.
+ * Every live member is probed exactly once per pass.
+ */
+static swim_node_t* swim_probe_next(swim_context_t *ctx) {
+    if (ctx->probe_count == 0) return NULL;
+    
+    if (ctx->probe_cursor >= ctx->probe_count) {
+        for (uint32_t i = ctx->probe_count - 1; i > 0; i--) {
+            uint32_t j = swim_rand_below(&ctx->rng, i + 1);
+            swim_node_t *tmp = ctx->probe_order[i];
+            ctx->probe_order[i] = ctx->probe_order[j];
+            ctx->probe_order[j] = tmp;
+            ctx->probe_order[i]->probe_slot = i;
+            ctx->probe_order[j]->probe_slot = j;
+        }
+        ctx->probe_cursor = 0;
+        ctx->probe_passes++;
+    }
+    
+    return ctx->probe_order[ctx->probe_cursor++];
+}
+
+/**
+ * Direct probe deadline for node: its own RTT-derived timeout, stretched
+ * by the detector like the configured one
+ */
+static uint32_t swim_probe_timeout(swim_context_t *ctx, const swim_node_t *node) {
+    return swim_detector_scale(&ctx->detector, swim_rtt_timeout_ms(&node->rtt, ctx->probe_timeout_ms));
+}
+
+/**
+ * Probe got no ACK, directly or indirectly, within the protocol period
+ */
+static void swim_probe_failed(swim_context_t *ctx, swim_node_t *node) {
+    node->probe_pending = false;
+    ctx->probe_failure++;
+    
+    if (!node->probe_failed) {
+        // How long the failure went unnoticed before this probe
+        uint64_t delay = node->probe_sent_ms - node->last_ack_ms;
+        ctx->first_probe_samples++;
+        ctx->first_probe_total_ms += delay;
+        if (delay > ctx->first_probe_max_ms) ctx->first_probe_max_ms = delay;
+        node->probe_failed = true;
+    }
+    
+    swim_detector_on_probe_failed(&ctx->detector, node);
+    
+    if (node->state == NODE_STATE_ALIVE) {
+        swim_suspect_node(ctx, node, ctx->local_id);
+    } else if (node->state == NODE_STATE_SUSPECT) {
+        // Our own failed probe independently confirms someone else's suspicion
+        swim_confirm_suspicion(ctx, node, ctx->local_id);
+    }
+}
+
+/**
+ * Direct probe timed out: ask up to SWIM_INDIRECT_NODES other live members
+ * to probe the target, so one lossy link does not raise a suspicion
+ */
+static void swim_probe_indirect(swim_context_t *ctx, swim_node_t *target) {
+    uint32_t count = ctx->probe_count;
+    if (count < 2) return;
+    
+    // Walk the shuffled probe order from a random point
+    uint32_t start = swim_rand_below(&ctx->rng, count);
+    uint32_t sent = 0;
+    
+    for (uint32_t i = 0; i < count && sent < SWIM_INDIRECT_NODES; i++) {
+        swim_node_t *helper = ctx->probe_order[(start + i) % count];
+        if (helper == target || helper->state != NODE_STATE_ALIVE) continue;
+        if (swim_send_ping_req(ctx, helper, target) == 0) sent++;
+    }
+    
+    ctx->indirect_probes += sent;
+}
+
+/**
+ * Timer wheel callback
+ */
+static void swim_on_timer(swim_timer_t *timer, void *arg) {
+    swim_context_t *ctx = (swim_context_t*)arg;
+    swim_node_t *node = (swim_node_t*)timer->owner;
+    
+    switch (timer->kind) {
+        case SWIM_TIMER_PROBE:
+            // Direct probe timed out; a late ACK still counts until the indirect window closes
+            if (!node->probe_pending) break;
+            swim_probe_indirect(ctx, node);
+            timer->kind = SWIM_TIMER_INDIRECT;
+            swim_timer_schedule(&ctx->timers, timer,
+                                timer->expires + swim_detector_scale(&ctx->detector, ctx->probe_timeout_ms));
+            break;
+            
+        case SWIM_TIMER_INDIRECT: {
+            if (node->probe_pending) {
+                // The detector may keep waiting while the delay is plausible for this member
+                uint32_t grace = swim_detector_grace(&ctx->detector, node,
+                                                     (uint32_t)(timer->expires - node->probe_sent_ms));
+                if (grace > 0) {
+                    swim_timer_schedule(&ctx->timers, timer, timer->expires + grace);
+                    break;
+                }
+            }
+            timer->kind = SWIM_TIMER_PROBE;
+            if (node->probe_pending) {
+                swim_probe_failed(ctx, node);
+            }
+            break;
+        }
+            
+        case SWIM_TIMER_SUSPECT:
+            if (node->state == NODE_STATE_SUSPECT) {
+                swim_update_node_state(ctx, node, NODE_STATE_DEAD);
+            }
+            break;
+            
+        case SWIM_TIMER_CHANNEL:
+            if (node->channel) {
+                swim_channel_pump(ctx, node);
+            }
+            break;
+            
+        case SWIM_TIMER_GRAFT:
+            swim_tree_graft_due(ctx, (swim_tree_missing_t*)timer->owner);
+            break;
+    }
+}
+
+/**
+ * Perform one gossip round
+ */
+static void swim_gossip_round(swim_context_t *ctx) {
+    // Next member in the shuffled order; membership changes ride along on the PING
+    swim_node_t *target = swim_probe_next(ctx);
+    if (target && !target->probe_pending) {
+        target->probe_sent_ms = swim_now_ms(ctx);
+        target->probe_sent_us = swim_now_us(ctx);
+        target->probe_pending = true;
+        target->probe_timer.kind = SWIM_TIMER_PROBE;
+        swim_timer_schedule(&ctx->timers, &target->probe_timer,
+                            target->probe_sent_ms + swim_probe_timeout(ctx, target));
+        swim_send_ping(ctx, target);
+    }
+    
+    // Periodic push-pull repairs whatever piggybacking missed
+    if (++ctx->sync_rounds >= SWIM_SYNC_ROUNDS) {
+        ctx->sync_rounds = 0;
+        swim_sync_start(ctx);
+    }
+}
+
+/**
+ * Fire due timers and run the gossip round when the protocol period is up
+ */
+static void swim_tick(swim_context_t *ctx) {
+    uint64_t now = swim_now_ms(ctx);
+    
+    swim_timer_advance(&ctx->timers, now, swim_on_timer, ctx);
+    
+    if (now >= ctx->next_round_ms) {
+        // Lifeguard slows the protocol period while this node is unhealthy
+        uint32_t interval = swim_detector_scale(&ctx->detector, ctx->gossip_interval_ms);
+        
+        if (swim_budget_limited(ctx) || ctx->backlog_bytes) {
+            swim_budget_refill(ctx);
+        }
+        swim_gossip_round(ctx);
+        ctx->next_round_ms += interval;
+        if (ctx->next_round_ms <= now) {
+            ctx->next_round_ms = now + interval;
+        }
+    }
+}
+
+/**
+ * Time of the next round or timer deadline
+ */
+static uint64_t swim_next_deadline(swim_context_t *ctx) {
+    uint64_t deadline = swim_timer_next_expiry(&ctx->timers);
+    return deadline < ctx->next_round_ms ? deadline : ctx->next_round_ms;
+}
+
+/**
+ * Hand queued membership events and user messages to their callbacks,
+ * outside the lock
+ */
+static void swim_dispatch_events(swim_context_t *ctx) {
+    swim_node_event_cb callback = ctx->on_node_event;
+    swim_message_cb on_message = ctx->on_message;
+    swim_reliable_cb on_reliable = ctx->on_reliable;
+    if (!callback && !on_message && !on_reliable) return;
+    
+    // Receive shards deliver too; one drainer at a time keeps events in order
+#ifdef _WIN32
+    EnterCriticalSection(&ctx->dispatch_lock);
+#else
+    pthread_mutex_lock(&ctx->dispatch_lock);
+#endif
+    swim_event_batch_t batch;
+    while (callback && swim_poll_events(ctx, &batch) > 0) {
+        for (uint32_t i = 0; i < batch.count; i++) {
+            const swim_event_t *ev = &batch.events[i];
+            callback(&ev->member, ev->old_state, ev->new_state, ctx->node_user_data);
+        }
+    }
+    
+    if (on_message) {
+        swim_lock(ctx);
+        struct swim_user_msg *msg = ctx->user_head;
+        ctx->user_head = ctx->user_tail = NULL;
+        ctx->user_queued = 0;
+        swim_epoch_guard_t guard = ctx->user_guard;
+        bool pinned = ctx->user_pinned;
+        ctx->user_pinned = false;
+        swim_unlock(ctx);
+        
+        while (msg) {
+            struct swim_user_msg *next = msg->next;
+            on_message(msg->from, msg->data, msg->len, ctx->message_user_data);
+            free(msg);
+            msg = next;
+        }
+        if (pinned) {
+            swim_epoch_exit(&ctx->epoch, &guard);
+        }
+    }
+    
+    if (on_reliable) {
+        swim_lock(ctx);
+        struct swim_reliable_done *done = ctx->reliable_head;
+        ctx->reliable_head = ctx->reliable_tail = NULL;
+        swim_unlock(ctx);
+        
+        while (done) {
+            struct swim_reliable_done *next = done->next;
+            on_reliable(done->node_id, done->msg_id, done->delivered, ctx->reliable_user_data);
+            free(done);
+            done = next;
+        }
+    }
+#ifdef _WIN32
+    LeaveCriticalSection(&ctx->dispatch_lock);
+#else
+    pthread_mutex_unlock(&ctx->dispatch_lock);
+#endif
+}
+
+/**
+ * Fire due work and return the next deadline
+ */
+uint64_t swim_run_due(swim_context_t *ctx) {
+    swim_lock(ctx);
+    swim_tick(ctx);
+    swim_flush(ctx, ctx->transport);
+    swim_membership_publish(ctx);
+    uint64_t deadline = swim_next_deadline(ctx);
+    swim_unlock(ctx);
+    
+    swim_dispatch_events(ctx);
+    return deadline;
+}
+
+#ifndef _WIN32
+/**
+ * Close event loop descriptors (no-op when using poll())
+ */
+static void swim_loop_close(swim_context_t *ctx) {
+    if (ctx->epoll_fd >= 0) close(ctx->epoll_fd);
+    if (ctx->timer_fd >= 0) close(ctx->timer_fd);
+    if (ctx->wake_fd >= 0) close(ctx->wake_fd);
+    ctx->epoll_fd = ctx->timer_fd = ctx->wake_fd = -1;
+}
+#endif
+
+#ifdef SWIM_HAVE_EPOLL
+/**
+ * Create epoll set with the socket, a deadline timerfd and a wakeup eventfd
+ * @return 0 on success, -1 (all fds closed) to fall back to poll()
+ */
+static int swim_loop_open(swim_context_t *ctx) {
+    ctx->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ctx->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ctx->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    int fds[3] = { ctx->transport->fd, ctx->timer_fd, ctx->wake_fd };
+    bool ok = ctx->epoll_fd >= 0 && ctx->timer_fd >= 0 && ctx->wake_fd >= 0;
+    
+    for (int i = 0; ok && i < 3; i++) {
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.fd = fds[i];
+        ok = epoll_ctl(ctx->epoll_fd, EPOLL_CTL_ADD, fds[i], &ev) == 0;
+    }
+    
+    if (!ok) {
+        log_warn("SWIM: epoll setup failed (%s), using poll()", strerror(errno));
+        swim_loop_close(ctx);
+        return -1;
+    }
+    
+    return 0;
+}
+
+/**
+ * Event loop: messages are handled as soon as they arrive, protocol
+ * deadlines fire from an absolute timerfd
+ */
+static void swim_loop_epoll(swim_context_t *ctx) {
+    uint64_t armed = 0;
+    
+    while (ctx->is_running) {
+        uint64_t deadline = swim_run_due(ctx);
+        
+        if (deadline != armed) {
+            struct itimerspec its = {0};
+            its.it_value.tv_sec = (time_t)(deadline / 1000);
+            its.it_value.tv_nsec = (long)(deadline % 1000) * 1000000L;
+            timerfd_settime(ctx->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+            armed = deadline;
+        }
+        
+        struct epoll_event events[3];
+        int n = epoll_wait(ctx->epoll_fd, events, 3, -1);
+        
+        for (int i = 0; i < n; i++) {
+            uint64_t value;
+            if (events[i].data.fd == ctx->transport->fd) {
+                swim_process(ctx);
+            } else if (read(events[i].data.fd, &value, sizeof(value)) < 0) {
+                // Timer or wakeup already drained
+            }
+        }
+    }
+}
+#endif
+
+/**
+ * Portable loop: poll() the socket until the next deadline
+ */
+static void swim_loop_poll(swim_context_t *ctx) {
+    while (ctx->is_running) {
+        uint64_t deadline = swim_run_due(ctx);
+        
+        // Capped so swim_stop is noticed within one interval
+        uint64_t now = swim_now_ms(ctx);
+        uint64_t wait_ms = deadline > now ? deadline - now : 0;
+        if (wait_ms > ctx->gossip_interval_ms) wait_ms = ctx->gossip_interval_ms;
+        
+#ifdef _WIN32
+        WSAPOLLFD pfd = { ctx->transport->fd, POLLRDNORM, 0 };
+        int ready = WSAPoll(&pfd, 1, (INT)wait_ms);
+#else
+        struct pollfd pfd = { ctx->transport->fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, (int)wait_ms);
+#endif
+        if (ready > 0) {
+            swim_process(ctx);
+        }
+    }
+}
+
+/**
+ * Background thread function
  */
 #ifdef _WIN32
 static DWORD WINAPI swim_thread_func(LPVOID arg) {
@@ -506,99 +2540,408 @@ static void* swim_thread_func(void *arg) {
 #endif
     swim_context_t *ctx = (swim_context_t*)arg;
     
-    while (ctx->is_running) {
-        // Receive messages
-        swim_process(ctx);
+#ifdef SWIM_HAVE_EPOLL
+    if (ctx->epoll_fd >= 0) {
+        swim_loop_epoll(ctx);
+        return 0;
+    }
+#endif
+    swim_loop_poll(ctx);
+    
+    return 0;
+}
+
+#ifdef SWIM_HAVE_RX_SHARDS
+/**
+ * Handle everything queued on a shard socket. Replies leave from the
+ * same socket, so they keep the port and the sender's flow hash.
+ */
+static void swim_shard_drain(struct swim_rx_shard *shard) {
+    swim_context_t *ctx = shard->ctx;
+    swim_transport_t *t = shard->transport;
+    uint32_t count;
+    
+    do {
+        // Only this worker receives on the shard, so the syscall stays outside the lock
+        const swim_io_rx_t *rx;
+        count = swim_transport_recv(t, &rx);
         
-        // Perform gossip round
-        swim_gossip_round(ctx);
+        swim_lock(ctx);
+        ctx->tx = t;
+        for (uint32_t i = 0; i < count; i++) {
+            swim_handle_datagram(ctx, &rx[i].from, rx[i].data, rx[i].len);
+        }
+        swim_flush(ctx, t);
+        ctx->tx = ctx->transport;
+        swim_membership_publish(ctx);
         
-        // Sleep for gossip interval
-#ifdef _WIN32
-        Sleep(ctx->gossip_interval_ms);
+        shard->rx_calls = t->rx_calls;
+        shard->rx_datagrams = t->rx_datagrams;
+        shard->tx_calls = t->tx_calls;
+        shard->tx_datagrams = t->tx_datagrams;
+        shard->tx_bytes = t->tx_bytes;
+        shard->tx_dropped = t->tx_dropped;
+        swim_unlock(ctx);
+    } while (count == SWIM_IO_BATCH);
+    
+    swim_dispatch_events(ctx);
+}
+
+/**
+ * Shard worker: wait on the shard socket until the wake fd signals stop
+ */
+static void* swim_shard_func(void *arg) {
+    struct swim_rx_shard *shard = (struct swim_rx_shard*)arg;
+    struct pollfd pfds[2] = {
+        { shard->transport->fd, POLLIN, 0 },
+        { shard->wake_fd, POLLIN, 0 }
+    };
+    
+    for (;;) {
+        if (poll(pfds, 2, -1) <= 0) continue;
+        if (pfds[1].revents & POLLIN) break;
+        if (pfds[0].revents & POLLIN) {
+            swim_shard_drain(shard);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Stop shard workers (no-op when none run)
+ */
+static void swim_shards_stop(swim_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->shard_count; i++) {
+        struct swim_rx_shard *shard = &ctx->shards[i];
+        if (!shard->running) continue;
+        
+        shard->running = false;
+        uint64_t one = 1;
+        if (write(shard->wake_fd, &one, sizeof(one)) < 0) {
+            log_warn("SWIM: Failed to wake receive shard %u", i);
+        }
+        pthread_join(shard->thread, NULL);
+        close(shard->wake_fd);
+        shard->wake_fd = -1;
+    }
+}
+
+/**
+ * Start a worker per shard socket
+ * @return 0 on success, -1 (none left running) on failure
+ */
+static int swim_shards_start(swim_context_t *ctx) {
+    for (uint32_t i = 0; i < ctx->shard_count; i++) {
+        struct swim_rx_shard *shard = &ctx->shards[i];
+        shard->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (shard->wake_fd < 0) {
+            swim_shards_stop(ctx);
+            return -1;
+        }
+        
+        shard->running = true;
+        if (pthread_create(&shard->thread, NULL, swim_shard_func, shard) != 0) {
+            shard->running = false;
+            close(shard->wake_fd);
+            shard->wake_fd = -1;
+            swim_shards_stop(ctx);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+#else
+static void swim_shards_stop(swim_context_t *ctx) { (void)ctx; }
+static int swim_shards_start(swim_context_t *ctx) { (void)ctx; return 0; }
+#endif
+
+/**
+ * Answer a joining node: send it our full state and merge the state it pushed
+ */
+static int swim_bootstrap_answer(void *arg, const struct sockaddr_in *from, const uint8_t *request, size_t len,
+                                 uint8_t **response, size_t *response_len) {
+    swim_context_t *ctx = (swim_context_t*)arg;
+    char address[64];
+    inet_ntop(AF_INET, &from->sin_addr, address, sizeof(address));
+    
+    swim_lock(ctx);
+    *response = swim_encode_state(ctx, response_len);
+    int merged = swim_merge_state(ctx, address, request, len, NULL);
+    if (*response && merged >= 0) ctx->bootstrap_served++;
+    swim_flush(ctx, ctx->transport);
+    swim_membership_publish(ctx);
+    swim_unlock(ctx);
+    
+    swim_dispatch_events(ctx);
+    return *response && merged >= 0 ? 0 : -1;
+}
+
+/**
+ * Exchange full state with a seed over TCP
+ * @return 0 if the seed's state was merged, -1 to fall back to UDP
+ */
+static int swim_bootstrap_join(swim_context_t *ctx, const char *address, uint16_t port) {
+    if (ctx->bootstrap_fd == SWIM_TRANSPORT_NO_FD) return -1;
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    if (inet_pton(AF_INET, address, &to.sin_addr) != 1) return -1;
+    
+    size_t request_len = 0;
+    swim_lock(ctx);
+    uint8_t *request = swim_encode_state(ctx, &request_len);
+    swim_unlock(ctx);
+    if (!request) return -1;
+    
+    // Blocks for up to a few timeouts; the protocol keeps running meanwhile
+    uint8_t *response = NULL;
+    size_t response_len = 0;
+    int rc = swim_bootstrap_exchange(&to, request, request_len, &response, &response_len);
+    free(request);
+    
+    char seed_id[SWIM_NODE_ID_SIZE];
+    swim_lock(ctx);
+    int merged = rc == 0 ? swim_merge_state(ctx, address, response, response_len, seed_id) : -1;
+    if (merged >= 0) {
+        ctx->bootstrap_joins++;
+        log_info("SWIM: Joined through %s (%s:%d), %d members received", seed_id, address, port, merged);
+    } else {
+        ctx->bootstrap_failures++;
+        log_warn("SWIM: No bootstrap from %s:%d, joining over UDP", address, port);
+    }
+    swim_flush(ctx, ctx->transport);
+    swim_membership_publish(ctx);
+    swim_unlock(ctx);
+    free(response);
+    
+    swim_dispatch_events(ctx);
+    return merged >= 0 ? 0 : -1;
+}
+
+/**
+ * Listen for joining nodes on the context's port
+ * @return 0 if listening, -1 if not
+ */
+static int swim_bootstrap_open(swim_context_t *ctx) {
+#ifdef SWIM_HAVE_BOOTSTRAP
+    if (ctx->bootstrap_fd == SWIM_TRANSPORT_NO_FD) {
+        ctx->bootstrap_fd = swim_bootstrap_listen(ctx->port);
+    }
+    return ctx->bootstrap_fd == SWIM_TRANSPORT_NO_FD ? -1 : 0;
 #else
-        usleep(ctx->gossip_interval_ms * 1000);
+    (void)ctx;
+    return -1;
 #endif
+}
+
+#ifdef SWIM_HAVE_BOOTSTRAP
+/**
+ * Largest state a joiner may push: a table twice the size of ours (at
+ * least SWIM_MAX_NODES), as it may know members we have not heard of yet
+ */
+static size_t swim_bootstrap_max_request(swim_context_t *ctx) {
+    swim_lock(ctx);
+    size_t nodes = ctx->node_count > SWIM_MAX_NODES ? ctx->node_count : SWIM_MAX_NODES;
+    swim_unlock(ctx);
+    return (2 * nodes + 2) * SWIM_WIRE_UPDATE_MAX;
+}
+
+/**
+ * Bootstrap worker: answer joining nodes until the wake fd signals stop
+ */
+static void* swim_bootstrap_func(void *arg) {
+    swim_context_t *ctx = (swim_context_t*)arg;
+    struct pollfd pfds[2] = {
+        { ctx->bootstrap_fd, POLLIN, 0 },
+        { ctx->bootstrap_wake_fd, POLLIN, 0 }
+    };
+    
+    for (;;) {
+        if (poll(pfds, 2, -1) <= 0) continue;
+        if (pfds[1].revents & POLLIN) break;
+        if (pfds[0].revents & POLLIN) {
+            swim_bootstrap_serve(ctx->bootstrap_fd, swim_bootstrap_max_request(ctx), swim_bootstrap_answer, ctx);
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Stop the bootstrap worker (no-op when none runs)
+ */
+static void swim_bootstrap_stop(swim_context_t *ctx) {
+    if (!ctx->bootstrap_running) return;
+    
+    ctx->bootstrap_running = false;
+    uint64_t one = 1;
+    if (write(ctx->bootstrap_wake_fd, &one, sizeof(one)) < 0) {
+        log_warn("SWIM: Failed to wake bootstrap worker");
+    }
+    pthread_join(ctx->bootstrap_thread, NULL);
+    close(ctx->bootstrap_wake_fd);
+    ctx->bootstrap_wake_fd = -1;
+}
+
+/**
+ * Start the bootstrap worker if the context listens
+ * @return 0 on success or nothing to do, -1 on failure
+ */
+static int swim_bootstrap_start(swim_context_t *ctx) {
+    if (ctx->bootstrap_fd == SWIM_TRANSPORT_NO_FD) return 0;
+    
+    ctx->bootstrap_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ctx->bootstrap_wake_fd < 0) return -1;
+    
+    ctx->bootstrap_running = true;
+    if (pthread_create(&ctx->bootstrap_thread, NULL, swim_bootstrap_func, ctx) != 0) {
+        ctx->bootstrap_running = false;
+        close(ctx->bootstrap_wake_fd);
+        ctx->bootstrap_wake_fd = -1;
+        return -1;
     }
     
     return 0;
 }
+#else
+static void swim_bootstrap_stop(swim_context_t *ctx) { (void)ctx; }
+static int swim_bootstrap_start(swim_context_t *ctx) { (void)ctx; return 0; }
+#endif
+
+/**
+ * Initialize SWIM context
+ */
+swim_context_t* swim_init(const char *local_id, uint16_t port, uint32_t gossip_interval_ms) {
+    if (!port) port = SWIM_DEFAULT_PORT;
+    
+    swim_transport_t *transport = swim_transport_udp(port);
+    if (!transport) return NULL;
+    
+    swim_context_t *ctx = swim_init_transport(local_id, port, gossip_interval_ms, transport);
+    if (ctx) swim_bootstrap_open(ctx);
+    return ctx;
+}
+
+/**
+ * Initialize SWIM context with SO_REUSEPORT receive shards
+ */
+swim_context_t* swim_init_sharded(const char *local_id, uint16_t port, uint32_t gossip_interval_ms,
+                                  uint32_t rx_shards) {
+    if (!port) port = SWIM_DEFAULT_PORT;
+    if (rx_shards > SWIM_RX_SHARDS_MAX) rx_shards = SWIM_RX_SHARDS_MAX;
+    
+#ifdef SWIM_HAVE_RX_SHARDS
+    swim_transport_t *transport = rx_shards > 1 ? swim_transport_udp_shared(port) : NULL;
+    if (transport) {
+        swim_context_t *ctx = swim_init_transport(local_id, port, gossip_interval_ms, transport);
+        if (!ctx) return NULL;
+        swim_bootstrap_open(ctx);
+        
+        ctx->shards = (struct swim_rx_shard*)calloc(rx_shards - 1, sizeof(struct swim_rx_shard));
+        for (uint32_t i = 0; ctx->shards && i < rx_shards - 1; i++) {
+            struct swim_rx_shard *shard = &ctx->shards[ctx->shard_count];
+            shard->transport = swim_transport_udp_shared(port);
+            if (!shard->transport) break;
+            shard->ctx = ctx;
+            shard->wake_fd = -1;
+            ctx->shard_count++;
+        }
+        
+        if (ctx->shard_count < rx_shards - 1) {
+            log_warn("SWIM: Only %u of %u receive shards opened on port %d",
+                     ctx->shard_count + 1, rx_shards, port);
+        }
+        return ctx;
+    }
+#endif
+    
+    return swim_init(local_id, port, gossip_interval_ms);
+}
 
 /**
- * Initialize SWIM context
+ * Initialize SWIM context over a transport
  */
-swim_context_t* swim_init(const char *local_id, uint16_t port, uint32_t gossip_interval_ms) {
+swim_context_t* swim_init_transport(const char *local_id, uint16_t port, uint32_t gossip_interval_ms,
+                                    swim_transport_t *transport) {
+    if (!transport) return NULL;
+    
     swim_context_t *ctx = (swim_context_t*)calloc(1, sizeof(swim_context_t));
-    if (!ctx) return NULL;
+    if (!ctx) {
+        swim_transport_close(transport);
+        return NULL;
+    }
     
     strncpy(ctx->local_id, local_id, SWIM_NODE_ID_SIZE - 1);
+    ctx->transport = transport;
+    ctx->tx = transport;
+    ctx->mtu = SWIM_MAX_DATAGRAM;
     ctx->port = port ? port : SWIM_DEFAULT_PORT;
     ctx->gossip_interval_ms = gossip_interval_ms ? gossip_interval_ms : SWIM_DEFAULT_INTERVAL;
     ctx->probe_timeout_ms = SWIM_PROBE_TIMEOUT;
     ctx->suspect_timeout_ms = SWIM_SUSPECT_TIMEOUT;
     ctx->incarnation = 1;
-    
-    // Initialize lock
-#ifdef _WIN32
-    InitializeCriticalSection(&ctx->lock);
-#else
-    pthread_mutex_init(&ctx->lock, NULL);
-#endif
-    
-    // Create UDP socket
-#ifdef _WIN32
-    ctx->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (ctx->sock == INVALID_SOCKET) {
-#else
-    ctx->sock = socket(AF_INET, SOCK_DGRAM, 0);
-    if (ctx->sock < 0) {
+    swim_detector_init(&ctx->detector, SWIM_DETECTOR_LIFEGUARD,
+                       ctx->probe_timeout_ms, ctx->suspect_timeout_ms);
+    ctx->bootstrap_fd = SWIM_TRANSPORT_NO_FD;
+#ifndef _WIN32
+    ctx->epoll_fd = ctx->timer_fd = ctx->wake_fd = ctx->bootstrap_wake_fd = -1;
 #endif
-        log_error("SWIM: Failed to create socket");
+    swim_dissem_init(&ctx->dissem, SWIM_RETRANSMIT_MULT);
+    swim_tree_init(&ctx->tree, SWIM_TIMER_GRAFT);
+    swim_epoch_init(&ctx->epoch);
+    swim_rand_seed(&ctx->rng, swim_now_us(ctx) ^ ((uint64_t)swim_hash_id(ctx->local_id) << 16) ^ ctx->port);
+    swim_timer_wheel_init(&ctx->timers, swim_now_ms(ctx));
+    swim_dedup_init(&ctx->dedup, swim_now_ms(ctx));
+    
+    // A restarted node must not reuse the keys peers remember from before
+    ctx->seq_num = (uint32_t)swim_rand_next(&ctx->rng);
+    ctx->user_seq = (uint32_t)swim_rand_next(&ctx->rng);
+    
+    if (swim_index_init(&ctx->index, SWIM_MAX_NODES) != 0) {
+        log_error("SWIM: Failed to allocate node index");
+        swim_transport_close(transport);
         free(ctx);
         return NULL;
     }
     
-    // Set non-blocking
-#ifdef _WIN32
-    u_long mode = 1;
-    ioctlsocket(ctx->sock, FIONBIO, &mode);
-#else
-    int flags = fcntl(ctx->sock, F_GETFL, 0);
-    fcntl(ctx->sock, F_SETFL, flags | O_NONBLOCK);
-#endif
-    
-    // Bind socket
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(ctx->port);
-    addr.sin_addr.s_addr = INADDR_ANY;
-    
-    if (bind(ctx->sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
-        log_error("SWIM: Failed to bind socket to port %d", ctx->port);
+    // Initialize locks
 #ifdef _WIN32
-        closesocket(ctx->sock);
+    InitializeCriticalSection(&ctx->lock);
+    InitializeCriticalSection(&ctx->dispatch_lock);
 #else
-        close(ctx->sock);
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_mutex_init(&ctx->dispatch_lock, NULL);
 #endif
-        free(ctx);
-        return NULL;
-    }
     
     // Get local address
     gethostname(ctx->local_address, sizeof(ctx->local_address));
     
     // Create local node entry
-    swim_node_t *local = swim_create_node(local_id, "127.0.0.1", ctx->port);
+    swim_node_t *local = swim_create_node(ctx, local_id, "127.0.0.1", ctx->port);
     if (local) {
         local->is_local = true;
-        swim_add_node(ctx, local);
+        swim_lock(ctx);
+        ctx->local = swim_add_node(ctx, local);
+        swim_membership_publish(ctx);
+        swim_unlock(ctx);
     }
     
-    log_info("SWIM: Initialized on port %d", ctx->port);
+    log_info("SWIM: Initialized on port %d (%s transport)", ctx->port, transport->ops->name);
     
     return ctx;
 }
 
+/**
+ * Accept join bootstraps on the context's port
+ */
+int swim_listen_bootstrap(swim_context_t *ctx) {
+    return swim_bootstrap_open(ctx);
+}
+
 /**
  * Destroy SWIM context
  */
@@ -606,26 +2949,74 @@ void swim_destroy(swim_context_t *ctx) {
     if (!ctx) return;
     
     swim_stop(ctx);
+    swim_reactor_detach(ctx);
     
-    // Free nodes
+    // Free nodes (queue links point into them, so unlink those first)
     swim_lock(ctx);
+    swim_dissem_clear(&ctx->dissem);
     swim_node_t *node = ctx->nodes;
     while (node) {
         swim_node_t *next = node->next;
+        swim_channel_destroy(node->channel, NULL, NULL);
         free(node);
         node = next;
     }
     ctx->nodes = NULL;
     ctx->node_count = 0;
+    ctx->local = NULL;
+    free(ctx->probe_order);
+    ctx->probe_order = NULL;
+    ctx->probe_count = 0;
+    swim_index_destroy(&ctx->index);
+    free((void*)(uintptr_t)swim_atomic_exchange(&ctx->membership, 0));
+    free(ctx->events);
+    ctx->events = NULL;
+    ctx->event_count = 0;
+    while (ctx->user_head) {
+        struct swim_user_msg *next = ctx->user_head->next;
+        free(ctx->user_head);
+        ctx->user_head = next;
+    }
+    ctx->user_tail = NULL;
+    ctx->user_queued = 0;
+    if (ctx->user_pinned) {
+        swim_epoch_exit(&ctx->epoch, &ctx->user_guard);
+        ctx->user_pinned = false;
+    }
+    while (ctx->reliable_head) {
+        struct swim_reliable_done *next = ctx->reliable_head->next;
+        free(ctx->reliable_head);
+        ctx->reliable_head = next;
+    }
+    ctx->reliable_tail = NULL;
+    swim_tree_destroy(&ctx->tree);
+    for (int p = 0; p < SWIM_PRIORITY_COUNT; p++) {
+        while (ctx->backlog_head[p]) {
+            struct swim_deferred *next = ctx->backlog_head[p]->next;
+            free(ctx->backlog_head[p]);
+            ctx->backlog_head[p] = next;
+        }
+        ctx->backlog_tail[p] = NULL;
+    }
+    ctx->backlog_bytes = 0;
+    swim_epoch_destroy(&ctx->epoch);
     swim_unlock(ctx);
     
-    // Close socket
+    // Close transport, receive shards and bootstrap listener
+    swim_transport_close(ctx->transport);
+    swim_bootstrap_close(ctx->bootstrap_fd);
+#ifdef SWIM_HAVE_RX_SHARDS
+    for (uint32_t i = 0; i < ctx->shard_count; i++) {
+        swim_transport_close(ctx->shards[i].transport);
+    }
+#endif
+    free(ctx->shards);
 #ifdef _WIN32
-    closesocket(ctx->sock);
     DeleteCriticalSection(&ctx->lock);
+    DeleteCriticalSection(&ctx->dispatch_lock);
 #else
-    close(ctx->sock);
     pthread_mutex_destroy(&ctx->lock);
+    pthread_mutex_destroy(&ctx->dispatch_lock);
 #endif
     
     free(ctx);
@@ -638,6 +3029,28 @@ int swim_start(swim_context_t *ctx) {
     if (ctx->is_running) return 0;
     
     ctx->is_running = true;
+    ctx->next_round_ms = swim_now_ms(ctx);
+    
+    if (ctx->reactor) {
+        swim_reactor_add(ctx);
+        if (swim_shards_start(ctx) != 0) {
+            log_warn("SWIM: Receive shards not started, main socket only");
+        }
+        if (swim_bootstrap_start(ctx) != 0) {
+            log_warn("SWIM: Bootstrap worker not started, joiners fall back to UDP");
+        }
+        log_info("SWIM: Protocol started (reactor)");
+        return 0;
+    }
+    
+    // Nothing to wait on: the transport's owner drives the context
+    if (ctx->transport->fd == SWIM_TRANSPORT_NO_FD) {
+        return 0;
+    }
+    
+#ifdef SWIM_HAVE_EPOLL
+    swim_loop_open(ctx);
+#endif
     
 #ifdef _WIN32
     ctx->thread = CreateThread(NULL, 0, swim_thread_func, ctx, 0, NULL);
@@ -648,9 +3061,18 @@ int swim_start(swim_context_t *ctx) {
 #else
     if (pthread_create(&ctx->thread, NULL, swim_thread_func, ctx) != 0) {
         ctx->is_running = false;
+        swim_loop_close(ctx);
         return -1;
     }
 #endif
+    ctx->has_thread = true;
+    
+    if (swim_shards_start(ctx) != 0) {
+        log_warn("SWIM: Receive shards not started, main socket only");
+    }
+    if (swim_bootstrap_start(ctx) != 0) {
+        log_warn("SWIM: Bootstrap worker not started, joiners fall back to UDP");
+    }
     
     log_info("SWIM: Protocol started");
     return 0;
@@ -663,6 +3085,15 @@ void swim_stop(swim_context_t *ctx) {
     if (!ctx->is_running) return;
     
     ctx->is_running = false;
+    swim_shards_stop(ctx);
+    swim_bootstrap_stop(ctx);
+    if (ctx->reactor) {
+        swim_reactor_remove(ctx);
+        log_info("SWIM: Protocol stopped");
+        return;
+    }
+    if (!ctx->has_thread) return;
+    ctx->has_thread = false;
     
 #ifdef _WIN32
     if (ctx->thread) {
@@ -671,7 +3102,14 @@ void swim_stop(swim_context_t *ctx) {
         ctx->thread = NULL;
     }
 #else
+    if (ctx->wake_fd >= 0) {
+        uint64_t one = 1;
+        if (write(ctx->wake_fd, &one, sizeof(one)) < 0) {
+            log_warn("SWIM: Failed to wake protocol thread");
+        }
+    }
     pthread_join(ctx->thread, NULL);
+    swim_loop_close(ctx);
 #endif
     
     log_info("SWIM: Protocol stopped");
@@ -681,55 +3119,82 @@ void swim_stop(swim_context_t *ctx) {
  * Process incoming messages
  */
 void swim_process(swim_context_t *ctx) {
-    uint8_t buffer[4096];
-    struct sockaddr_in from;
-    socklen_t from_len = sizeof(from);
-    
-    while (1) {
-        int received = recvfrom(ctx->sock, (char*)buffer, sizeof(buffer), 0,
-                                (struct sockaddr*)&from, &from_len);
-        
-        if (received <= 0) break;
+    uint32_t count;
+    
+    do {
+        // Receive buffers belong to the transport, so the whole batch runs under the lock
+        const swim_io_rx_t *rx;
+        swim_lock(ctx);
+        count = swim_transport_recv(ctx->transport, &rx);
+        for (uint32_t i = 0; i < count; i++) {
+            swim_handle_datagram(ctx, &rx[i].from, rx[i].data, rx[i].len);
+        }
         
-        swim_handle_message(ctx, &from, buffer, received);
-    }
+        // ACKs for the whole batch go out together
+        swim_flush(ctx, ctx->transport);
+        swim_membership_publish(ctx);
+        swim_unlock(ctx);
+    } while (count == SWIM_IO_BATCH);
+    
+    swim_dispatch_events(ctx);
 }
 
 /**
  * Join mesh by connecting to seed node
  */
 int swim_join(swim_context_t *ctx, const char *address, uint16_t port) {
-    // Create seed node
+    if (swim_bootstrap_join(ctx, address, port) == 0) return 0;
+    
+    // Placeholder for the seed until it answers under its real id
     char seed_id[SWIM_NODE_ID_SIZE];
     snprintf(seed_id, sizeof(seed_id), "seed-%s:%d", address, port);
     
-    swim_node_t *seed = swim_create_node(seed_id, address, port);
-    if (!seed) return -1;
+    swim_lock(ctx);
     
-    swim_add_node(ctx, seed);
+    swim_node_t *seed = swim_lookup(ctx, seed_id);
+    if (!seed) {
+        seed = swim_create_node(ctx, seed_id, address, port);
+        if (seed) {
+            seed->placeholder = true;
+            seed = swim_add_node(ctx, seed);
+        }
+        for (uint32_t i = 0; seed && i < SWIM_JOIN_SEEDS; i++) {
+            if (!ctx->join_seeds[i]) {
+                ctx->join_seeds[i] = seed;
+                break;
+            }
+        }
+    }
     
     // Send initial ping to seed
-    seed = swim_find_node(ctx, seed_id);
     if (seed) {
+        uint32_t buckets[SWIM_SYNC_BUCKETS];
+        swim_sync_digest(ctx, buckets, SWIM_SYNC_BUCKETS);
+        
         swim_send_ping(ctx, seed);
         swim_send_sync(ctx, seed);
+        swim_send_digest(ctx, seed, SWIM_MSG_DIGEST, buckets);
+        swim_flush(ctx, ctx->transport);
     }
+    swim_membership_publish(ctx);
     
-    return 0;
+    swim_unlock(ctx);
+    
+    return seed ? 0 : -1;
 }
 
 /**
  * Leave mesh gracefully
  */
 void swim_leave(swim_context_t *ctx) {
+    swim_lock(ctx);
+    
     // Update local node state to LEFT
-    swim_node_t *local = swim_get_local_node(ctx);
-    if (local) {
-        swim_update_node_state(ctx, local, NODE_STATE_LEFT);
+    if (ctx->local) {
+        swim_update_node_state(ctx, ctx->local, NODE_STATE_LEFT);
     }
     
     // Broadcast leave to all nodes
-    swim_lock(ctx);
     swim_node_t *node = ctx->nodes;
     while (node) {
         if (!node->is_local && node->state == NODE_STATE_ALIVE) {
@@ -737,6 +3202,8 @@ void swim_leave(swim_context_t *ctx) {
         }
         node = node->next;
     }
+    swim_flush(ctx, ctx->transport);
+    swim_membership_publish(ctx);
     swim_unlock(ctx);
 }
 
@@ -757,59 +3224,201 @@ uint32_t swim_get_nodes(swim_context_t *ctx, swim_node_t **nodes, uint32_t max_n
     return count;
 }
 
+/**
+ * Pin current membership snapshot
+ */
+const swim_membership_t* swim_membership_acquire(swim_context_t *ctx, swim_epoch_guard_t *guard) {
+    swim_epoch_enter(&ctx->epoch, guard);
+    return (const swim_membership_t*)(uintptr_t)swim_atomic_load(&ctx->membership);
+}
+
+/**
+ * Unpin membership snapshot
+ */
+void swim_membership_release(swim_context_t *ctx, swim_epoch_guard_t *guard) {
+    swim_epoch_exit(&ctx->epoch, guard);
+}
+
+/**
+ * Find member in snapshot
+ */
+const swim_member_t* swim_membership_find(const swim_membership_t *membership, const char *id) {
+    if (!membership) return NULL;
+    
+    swim_member_t key;
+    key.id_hash = swim_hash_id(id);
+    strncpy(key.id, id, SWIM_NODE_ID_SIZE - 1);
+    key.id[SWIM_NODE_ID_SIZE - 1] = '\0';
+    
+    return (const swim_member_t*)bsearch(&key, membership->members, membership->count,
+                                         sizeof(swim_member_t), swim_member_compare);
+}
+
 /**
  * Get count of nodes by state
  */
 uint32_t swim_get_node_count(swim_context_t *ctx, swim_node_state_t state) {
+    if ((unsigned)state > NODE_STATE_LEFT) return 0;
+    
+    swim_epoch_guard_t guard;
+    const swim_membership_t *membership = swim_membership_acquire(ctx, &guard);
+    uint32_t count = membership ? membership->state_count[state] : 0;
+    swim_membership_release(ctx, &guard);
+    
+    return count;
+}
+
+/**
+ * Get local node
+ */
+swim_node_t* swim_get_local_node(swim_context_t *ctx) {
+    swim_lock(ctx);
+    swim_node_t *node = ctx->local;
+    swim_unlock(ctx);
+    return node;
+}
+
+/**
+ * Find node by ID
+ */
+swim_node_t* swim_find_node(swim_context_t *ctx, const char *id) {
+    swim_lock(ctx);
+    swim_node_t *node = swim_lookup(ctx, id);
+    swim_unlock(ctx);
+    return node;
+}
+
+/**
+ * Fill RTT statistics for node
+ */
+static void swim_fill_rtt_stats(swim_context_t *ctx, const swim_node_t *node, swim_rtt_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    memcpy(stats->id, node->id, sizeof(stats->id));
+    stats->samples = node->rtt.samples;
+    stats->srtt_ms = node->rtt.srtt_us / 1000.0;
+    stats->rttvar_ms = node->rtt.rttvar_us / 1000.0;
+    stats->p50_ms = swim_rtt_percentile_us(&node->rtt, 50) / 1000.0;
+    stats->p90_ms = swim_rtt_percentile_us(&node->rtt, 90) / 1000.0;
+    stats->p99_ms = swim_rtt_percentile_us(&node->rtt, 99) / 1000.0;
+    stats->max_ms = swim_rtt_percentile_us(&node->rtt, 100) / 1000.0;
+    stats->probe_timeout_ms = swim_probe_timeout(ctx, node);
+}
+
+/**
+ * Get RTT statistics for one member
+ */
+int swim_get_node_rtt(swim_context_t *ctx, const char *id, swim_rtt_stats_t *stats) {
+    if (!ctx || !id || !stats) return -1;
+    
     swim_lock(ctx);
+    swim_node_t *node = swim_lookup(ctx, id);
+    if (node) {
+        swim_fill_rtt_stats(ctx, node, stats);
+    }
+    swim_unlock(ctx);
+    
+    return node ? 0 : -1;
+}
+
+/**
+ * Get RTT statistics for all measured members
+ */
+uint32_t swim_get_rtt_stats(swim_context_t *ctx, swim_rtt_stats_t *stats, uint32_t max_stats) {
+    if (!ctx || !stats) return 0;
     
+    swim_lock(ctx);
     uint32_t count = 0;
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (node->state == state) count++;
-        node = node->next;
+    for (swim_node_t *node = ctx->nodes; node && count < max_stats; node = node->next) {
+        if (node->is_local || node->rtt.samples == 0) continue;
+        swim_fill_rtt_stats(ctx, node, &stats[count++]);
     }
-    
     swim_unlock(ctx);
+    
     return count;
 }
 
 /**
- * Get local node
+ * Member whose coordinate can be used for predictions
  */
-swim_node_t* swim_get_local_node(swim_context_t *ctx) {
+static swim_node_t* swim_coord_node(swim_context_t *ctx, const char *id) {
+    swim_node_t *node = swim_lookup(ctx, id);
+    return node && (node->is_local || node->has_coord) ? node : NULL;
+}
+
+/**
+ * Predict RTT between two members
+ */
+double swim_estimate_rtt(swim_context_t *ctx, const char *id_a, const char *id_b) {
+    if (!ctx || !id_a || !id_b) return -1;
+    
     swim_lock(ctx);
+    swim_node_t *a = swim_coord_node(ctx, id_a);
+    swim_node_t *b = swim_coord_node(ctx, id_b);
+    double rtt = a && b ? swim_coord_distance_ms(&a->coord, &b->coord) : -1;
+    swim_unlock(ctx);
     
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (node->is_local) {
-            swim_unlock(ctx);
-            return node;
+    return rtt;
+}
+
+/**
+ * k nearest alive members by predicted RTT
+ */
+uint32_t swim_nearest_nodes(swim_context_t *ctx, const char *from, uint32_t k, swim_neighbor_t *out) {
+    if (!ctx || !out || k == 0) return 0;
+    
+    swim_lock(ctx);
+    
+    swim_node_t *origin = from ? swim_coord_node(ctx, from) : ctx->local;
+    uint32_t count = 0;
+    
+    for (swim_node_t *node = origin ? ctx->nodes : NULL; node; node = node->next) {
+        if (node == origin || node->state != NODE_STATE_ALIVE) continue;
+        if (!node->is_local && !node->has_coord) continue;
+        
+        double rtt = swim_coord_distance_ms(&origin->coord, &node->coord);
+        if (count == k && rtt >= out[k - 1].rtt_ms) continue;
+        
+        // Insertion into the sorted top-k
+        uint32_t pos = count < k ? count++ : k - 1;
+        while (pos > 0 && out[pos - 1].rtt_ms > rtt) {
+            out[pos] = out[pos - 1];
+            pos--;
         }
-        node = node->next;
+        swim_fill_member(&out[pos].member, node);
+        out[pos].rtt_ms = rtt;
     }
     
     swim_unlock(ctx);
-    return NULL;
+    return count;
 }
 
 /**
- * Find node by ID
+ * Drain membership events
  */
-swim_node_t* swim_find_node(swim_context_t *ctx, const char *id) {
+uint32_t swim_poll_events(swim_context_t *ctx, swim_event_batch_t *batch) {
     swim_lock(ctx);
     
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (strcmp(node->id, id) == 0) {
-            swim_unlock(ctx);
-            return node;
-        }
-        node = node->next;
+    // Snapshot first, so batch->version covers every event in the batch
+    swim_membership_publish(ctx);
+    
+    batch->count = 0;
+    batch->overflow = ctx->event_overflow;
+    ctx->event_overflow = false;
+    
+    while (ctx->event_count > 0 && batch->count < SWIM_EVENT_BATCH) {
+        swim_event_slot_t *slot = &ctx->events[ctx->event_head];
+        ctx->event_head = (ctx->event_head + 1) % ctx->event_capacity;
+        ctx->event_count--;
+        
+        if (!slot->pending) continue;
+        if (slot->node) slot->node->event_slot = -1;
+        batch->events[batch->count++] = slot->event;
     }
     
+    batch->version = ctx->membership_version;
     swim_unlock(ctx);
-    return NULL;
+    
+    return batch->count;
 }
 
 /**
@@ -817,7 +3426,7 @@ swim_node_t* swim_find_node(swim_context_t *ctx, const char *id) {
  */
 void swim_set_node_callback(swim_context_t *ctx, swim_node_event_cb callback, void *user_data) {
     ctx->on_node_event = callback;
-    ctx->user_data = user_data;
+    ctx->node_user_data = user_data;
 }
 
 /**
@@ -825,32 +3434,72 @@ void swim_set_node_callback(swim_context_t *ctx, swim_node_event_cb callback, vo
  */
 void swim_set_message_callback(swim_context_t *ctx, swim_message_cb callback, void *user_data) {
     ctx->on_message = callback;
-    ctx->user_data = user_data;
+    ctx->message_user_data = user_data;
 }
 
 /**
  * Broadcast message to all nodes
  */
 int swim_broadcast(swim_context_t *ctx, const uint8_t *payload, size_t len) {
-    int sent = 0;
-    
     swim_lock(ctx);
-    swim_node_t *node = ctx->nodes;
-    while (node) {
-        if (!node->is_local && node->state == NODE_STATE_ALIVE) {
-            struct sockaddr_in addr = {0};
-            addr.sin_family = AF_INET;
-            addr.sin_port = htons(node->port);
-            inet_pton(AF_INET, node->address, &addr.sin_addr);
-            
-            int result = sendto(ctx->sock, (const char*)payload, (int)len, 0,
-                               (struct sockaddr*)&addr, sizeof(addr));
-            if (result > 0) sent++;
+    
+    swim_wire_user_t user;
+    memset(&user, 0, sizeof(user));
+    strncpy(user.origin, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
+    user.origin_seq = ++ctx->user_seq;
+    user.payload = payload;
+    user.len = (uint32_t)len;
+    user.hops = ctx->broadcast_fanout && !ctx->broadcast_tree ? swim_broadcast_hops(ctx) : 0;
+    
+    // Encoded once up front: checks it fits, and the unicast fan-out shares it
+    uint8_t buffer[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header;
+    swim_fill_header(ctx, &header, SWIM_MSG_USER, ++ctx->seq_num);
+    swim_wire_writer_init(&w, buffer, ctx->mtu);
+    if (swim_wire_write_header(&w, &header) != 0 || swim_wire_write_user(&w, &user) != 0) {
+        swim_unlock(ctx);
+        log_warn("SWIM: Broadcast of %d bytes does not fit MTU %u", (int)len, ctx->mtu);
+        return -1;
+    }
+    
+    // Our own message coming back is a duplicate
+    swim_user_seen(ctx, ctx->local_id, user.origin_seq);
+    ctx->user_sent++;
+    
+    int sent;
+    if (ctx->broadcast_tree) {
+        // Kept for GRAFTs like any message passing through
+        swim_tree_store(&ctx->tree, user.origin, swim_hash_id(user.origin), user.origin_seq, payload, user.len);
+        sent = (int)swim_tree_forward(ctx, &user, NULL);
+        swim_flush(ctx, ctx->transport);
+    } else if (ctx->broadcast_fanout > 0) {
+        sent = (int)swim_user_fanout(ctx, &user, NULL, NULL, ctx->broadcast_fanout);
+        swim_flush(ctx, ctx->transport);
+    } else {
+        // Anything already queued goes out first; the fan-out then shares buffer
+        swim_flush(ctx, ctx->transport);
+        uint64_t before = ctx->transport->tx_datagrams;
+        
+        swim_node_t *node = ctx->nodes;
+        while (node) {
+            if (!node->is_local && node->state == NODE_STATE_ALIVE) {
+                if (swim_budget_limited(ctx)) {
+                    // Copied, so the scheduler can hold it back
+                    swim_send_raw(ctx, node, buffer, w.len);
+                } else {
+                    struct sockaddr_in addr;
+                    swim_node_sockaddr(node, &addr);
+                    swim_transport_send_ref(ctx->transport, &addr, buffer, w.len);
+                }
+            }
+            node = node->next;
         }
-        node = node->next;
+        swim_flush(ctx, ctx->transport);
+        sent = (int)(ctx->transport->tx_datagrams - before);
     }
-    swim_unlock(ctx);
     
+    swim_unlock(ctx);
     return sent;
 }
 
@@ -858,31 +3507,149 @@ int swim_broadcast(swim_context_t *ctx, const uint8_t *payload, size_t len) {
  * Send to specific node
  */
 int swim_send_to(swim_context_t *ctx, const char *node_id, const uint8_t *payload, size_t len) {
-    swim_node_t *node = swim_find_node(ctx, node_id);
-    if (!node) return -1;
+    swim_lock(ctx);
+    
+    swim_node_t *node = swim_lookup(ctx, node_id);
+    if (!node) {
+        swim_unlock(ctx);
+        return -1;
+    }
+    
+    swim_wire_user_t user;
+    memset(&user, 0, sizeof(user));
+    strncpy(user.origin, ctx->local_id, SWIM_NODE_ID_SIZE - 1);
+    user.origin_seq = ++ctx->user_seq;
+    user.payload = payload;
+    user.len = (uint32_t)len;
+    
+    uint64_t dropped = ctx->transport->tx_dropped;
+    int result = swim_send_user(ctx, node, SWIM_MSG_USER, &user);
+    swim_flush(ctx, ctx->transport);
+    if (ctx->transport->tx_dropped != dropped) result = -1;
+    if (result == 0) ctx->user_sent++;
+    
+    swim_unlock(ctx);
+    return result;
+}
+
+/**
+ * Send message reliably to specific node
+ */
+int swim_send_reliable(swim_context_t *ctx, const char *node_id, const uint8_t *payload, size_t len,
+                       uint32_t *msg_id) {
+    swim_lock(ctx);
+    
+    swim_node_t *node = swim_lookup(ctx, node_id);
+    if (!node || node->is_local || node->state == NODE_STATE_DEAD || node->state == NODE_STATE_LEFT) {
+        swim_unlock(ctx);
+        return -1;
+    }
     
-    struct sockaddr_in addr = {0};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(node->port);
-    inet_pton(AF_INET, node->address, &addr.sin_addr);
+    swim_channel_t *ch = swim_channel_get(ctx, node);
+    if (!ch || swim_channel_enqueue(ch, payload, len, swim_channel_frag_size(ctx), msg_id) != 0) {
+        swim_unlock(ctx);
+        log_warn("SWIM: Reliable message of %d bytes to %s rejected", (int)len, node_id);
+        return -1;
+    }
+    ctx->channel_sent++;
     
-    int result = sendto(ctx->sock, (const char*)payload, (int)len, 0,
-                       (struct sockaddr*)&addr, sizeof(addr));
+    swim_channel_pump(ctx, node);
+    swim_flush(ctx, ctx->transport);
     
-    return result > 0 ? 0 : -1;
+    swim_unlock(ctx);
+    return 0;
+}
+
+/**
+ * Set reliable message outcome callback
+ */
+void swim_set_reliable_callback(swim_context_t *ctx, swim_reliable_cb callback, void *user_data) {
+    ctx->on_reliable = callback;
+    ctx->reliable_user_data = user_data;
+}
+
+/**
+ * Select broadcast mode
+ */
+void swim_set_broadcast_fanout(swim_context_t *ctx, uint32_t fanout) {
+    swim_lock(ctx);
+    ctx->broadcast_fanout = fanout;
+    swim_unlock(ctx);
+}
+
+/**
+ * Select broadcast tree mode
+ */
+void swim_set_broadcast_tree(swim_context_t *ctx, bool enable) {
+    swim_lock(ctx);
+    ctx->broadcast_tree = enable;
+    swim_unlock(ctx);
 }
 
 /**
  * Set this node as main coordinator
  */
 void swim_set_main_node(swim_context_t *ctx, bool is_main) {
+    swim_lock(ctx);
+    
     ctx->is_main_node = is_main;
     
-    swim_node_t *local = swim_get_local_node(ctx);
+    swim_node_t *local = ctx->local;
     if (local) {
         local->is_main_node = is_main;
         ctx->incarnation++;  // Force update propagation
+        local->incarnation = ctx->incarnation;
+        swim_member_changed(ctx, local);
     }
+    
+    swim_membership_publish(ctx);
+    swim_unlock(ctx);
+}
+
+/**
+ * Set datagram budget
+ */
+void swim_set_mtu(swim_context_t *ctx, uint32_t mtu) {
+    if (mtu < SWIM_MTU_MIN) mtu = SWIM_MTU_MIN;
+    if (mtu > SWIM_MAX_DATAGRAM) mtu = SWIM_MAX_DATAGRAM;
+    
+    swim_lock(ctx);
+    ctx->mtu = mtu;
+    swim_unlock(ctx);
+}
+
+/**
+ * Set send budget per round
+ */
+void swim_set_bandwidth_budget(swim_context_t *ctx, uint32_t bytes_per_round, uint32_t packets_per_round) {
+    swim_lock(ctx);
+    ctx->budget_bytes = bytes_per_round;
+    ctx->budget_packets = packets_per_round;
+    ctx->budget_bytes_left = bytes_per_round;
+    ctx->budget_packets_left = packets_per_round;
+    swim_unlock(ctx);
+}
+
+/**
+ * Select built-in failure detector
+ */
+void swim_set_detector(swim_context_t *ctx, swim_detector_mode_t mode) {
+    swim_lock(ctx);
+    ctx->detector.ops = swim_detector_builtin(mode);
+    ctx->detector.health = 0;
+    swim_unlock(ctx);
+    
+    log_info("SWIM: Using %s failure detector", ctx->detector.ops->name);
+}
+
+/**
+ * Install custom failure detector
+ */
+void swim_set_detector_ops(swim_context_t *ctx, const swim_detector_ops_t *ops) {
+    swim_lock(ctx);
+    ctx->detector.ops = ops ? ops : swim_detector_builtin(SWIM_DETECTOR_STATIC);
+    ctx->detector.health = 0;
+    swim_unlock(ctx);
 }
 
 /**
@@ -895,3 +3662,97 @@ void swim_get_stats(swim_context_t *ctx, uint64_t *sent, uint64_t *received,
     if (probe_success) *probe_success = ctx->probe_success;
     if (probe_failure) *probe_failure = ctx->probe_failure;
 }
+
+/**
+ * Get detailed statistics
+ */
+void swim_get_detailed_stats(swim_context_t *ctx, swim_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    
+    swim_lock(ctx);
+    stats->messages_sent = ctx->messages_sent;
+    stats->messages_received = ctx->messages_received;
+    stats->duplicates_dropped = ctx->duplicates_dropped;
+    if (ctx->messages_received + ctx->duplicates_dropped > 0) {
+        stats->duplicate_rate = (double)ctx->duplicates_dropped /
+                                (double)(ctx->messages_received + ctx->duplicates_dropped);
+    }
+    stats->probe_success = ctx->probe_success;
+    stats->probe_failure = ctx->probe_failure;
+    stats->probe_passes = ctx->probe_passes;
+    stats->probe_members = ctx->probe_count;
+    stats->first_probe_samples = ctx->first_probe_samples;
+    stats->first_probe_max_ms = ctx->first_probe_max_ms;
+    if (ctx->first_probe_samples > 0) {
+        stats->first_probe_avg_ms = (double)ctx->first_probe_total_ms / (double)ctx->first_probe_samples;
+    }
+    stats->ack_samples = ctx->ack_samples;
+    stats->ack_rtt_max_us = ctx->ack_max_us;
+    if (ctx->ack_samples > 0) {
+        stats->ack_rtt_avg_us = (double)ctx->ack_total_us / (double)ctx->ack_samples;
+    }
+    stats->suspicions = ctx->suspicions;
+    stats->suspicions_cleared = ctx->suspicions_cleared;
+    stats->deaths = ctx->deaths;
+    stats->self_refutes = ctx->self_refutes;
+    stats->local_health = ctx->detector.health;
+    stats->coord_updates = ctx->coord_updates;
+    stats->coord_error = ctx->local ? ctx->local->coord.error : SWIM_COORD_ERROR_MAX;
+    stats->indirect_probes = ctx->indirect_probes;
+    stats->indirect_acks = ctx->indirect_acks;
+    stats->relayed_acks = ctx->relayed_acks;
+    stats->sync_exchanges = ctx->sync_exchanges;
+    stats->sync_pages = ctx->sync_pages;
+    stats->sync_entries = ctx->sync_entries;
+    stats->bootstrap_joins = ctx->bootstrap_joins;
+    stats->bootstrap_served = ctx->bootstrap_served;
+    stats->bootstrap_entries = ctx->bootstrap_entries;
+    stats->bootstrap_failures = ctx->bootstrap_failures;
+    stats->events_queued = ctx->events_queued;
+    stats->events_coalesced = ctx->events_coalesced;
+    stats->events_dropped = ctx->events_dropped;
+    stats->io_rx_syscalls = ctx->transport->rx_calls;
+    stats->io_rx_datagrams = ctx->transport->rx_datagrams;
+    stats->io_tx_syscalls = ctx->transport->tx_calls;
+    stats->io_tx_datagrams = ctx->transport->tx_datagrams;
+    stats->io_tx_bytes = ctx->transport->tx_bytes;
+    stats->io_tx_dropped = ctx->transport->tx_dropped;
+    stats->mtu = ctx->mtu;
+    stats->datagrams_sent = ctx->datagrams_sent;
+    stats->compound_sent = ctx->compound_sent;
+    stats->compound_parts = ctx->compound_parts;
+    stats->compound_received = ctx->compound_received;
+    stats->user_sent = ctx->user_sent;
+    stats->user_received = ctx->user_received;
+    stats->user_duplicates = ctx->user_duplicates;
+    stats->user_forwarded = ctx->user_forwarded;
+    stats->user_dropped = ctx->user_dropped;
+    stats->channel_sent = ctx->channel_sent;
+    stats->channel_acked = ctx->channel_acked;
+    stats->channel_failed = ctx->channel_failed;
+    stats->channel_received = ctx->channel_received;
+    stats->channel_fragments = ctx->channel_fragments;
+    stats->channel_retransmits = ctx->channel_retransmits;
+    stats->tree_eager_peers = ctx->tree_eager_count;
+    stats->tree_ihave_sent = ctx->tree_ihave_sent;
+    stats->tree_graft_sent = ctx->tree_graft_sent;
+    stats->tree_prune_sent = ctx->tree_prune_sent;
+    stats->budget_deferred_bytes = ctx->budget_deferred_bytes;
+    stats->budget_dropped_bytes = ctx->budget_dropped_bytes;
+    stats->budget_probe_overdraft = ctx->budget_probe_overdraft;
+    stats->backlog_bytes = ctx->backlog_bytes;
+    stats->rx_shards = 1 + ctx->shard_count;
+#ifdef SWIM_HAVE_RX_SHARDS
+    for (uint32_t i = 0; i < ctx->shard_count; i++) {
+        const struct swim_rx_shard *shard = &ctx->shards[i];
+        stats->shard_rx_datagrams += shard->rx_datagrams;
+        stats->io_rx_syscalls += shard->rx_calls;
+        stats->io_rx_datagrams += shard->rx_datagrams;
+        stats->io_tx_syscalls += shard->tx_calls;
+        stats->io_tx_datagrams += shard->tx_datagrams;
+        stats->io_tx_bytes += shard->tx_bytes;
+        stats->io_tx_dropped += shard->tx_dropped;
+    }
+#endif
+    swim_unlock(ctx);
+}
@@ -14,6 +14,20 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <time.h>
+#include "swim_index.h"
+#include "swim_dissem.h"
+#include "swim_rand.h"
+#include "swim_timer.h"
+#include "swim_wire.h"
+#include "swim_io.h"
+#include "swim_transport.h"
+#include "swim_detector.h"
+#include "swim_epoch.h"
+#include "swim_rtt.h"
+#include "swim_coord.h"
+#include "swim_channel.h"
+#include "swim_tree.h"
+#include "swim_dedup.h"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -22,17 +36,41 @@
 #else
 #include <pthread.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
 #endif
 
 // SWIM Protocol Constants
-#define SWIM_MAX_NODES          256
+#define SWIM_MAX_NODES          256   // Initial node table capacity (grows on demand)
 #define SWIM_NODE_ID_SIZE       64
 #define SWIM_MAX_PAYLOAD        1024
+#define SWIM_MAX_DATAGRAM       1400  // Keep datagrams under a typical path MTU
+#define SWIM_PIGGYBACK_MAX      8     // Max membership updates per PING/ACK
 #define SWIM_DEFAULT_PORT       7946
 #define SWIM_DEFAULT_INTERVAL   1000  // ms
 #define SWIM_PROBE_TIMEOUT      500   // ms
 #define SWIM_SUSPECT_TIMEOUT    5000  // ms
 #define SWIM_INDIRECT_NODES     3     // Number of nodes for indirect probe
+#define SWIM_PROBE_SEQ_SLOTS    64    // Own probes awaiting a relayed ACK, by PING seq
+#define SWIM_RELAY_SLOTS        64    // PINGs sent on behalf of PING_REQs, by our seq
+#define SWIM_SYNC_BUCKETS       256   // Anti-entropy digest buckets (1 KB digest, folded to fit the MTU)
+#define SWIM_SYNC_ROUNDS        20    // Gossip rounds between push-pull exchanges
+#define SWIM_SYNC_MAX_PAGES     16    // SYNC datagrams sent per exchange
+#define SWIM_EVENT_QUEUE        1024  // Pending membership events (coalesced per member)
+#define SWIM_EVENT_BATCH        64    // Events handed out per drain
+#define SWIM_RX_SHARDS_MAX      16    // SO_REUSEPORT receive sockets per context
+#define SWIM_MTU_MIN            512   // Smallest datagram budget swim_set_mtu accepts
+#define SWIM_OUTBOX_MAX         64    // Messages held for packing between flushes
+#define SWIM_OUTBOX_BYTES       (16 * SWIM_MAX_DATAGRAM)
+#define SWIM_USER_QUEUE         1024  // Received user messages awaiting on_message
+#define SWIM_USER_SEEN          4096  // Recent (origin, seq) pairs remembered for dedup
+#define SWIM_USER_SEEN_WAYS     4     // Entries per set; the oldest is replaced
+#define SWIM_USER_SEEN_MS       60000 // How long a delivered message is remembered
+#define SWIM_BROADCAST_FANOUT   4     // Forwarding fanout of members that broadcast by unicast
+#define SWIM_BROADCAST_HOPS_EXTRA   2 // Gossip hops beyond log2(members)
+#define SWIM_TREE_GRAFT_TIMEOUT 100   // ms an IHAVE waits for the eager copy before a GRAFT
+#define SWIM_TREE_IDS_MAX       16    // Broadcast ids accepted per IHAVE / GRAFT
+#define SWIM_BACKLOG_BYTES      (64 * SWIM_MAX_DATAGRAM)  // Messages held back by the send budget
+#define SWIM_JOIN_SEEDS         4     // UDP joins awaiting the seed's real id
 
 // Node states
 typedef enum {
@@ -48,77 +86,158 @@ typedef enum {
     SWIM_MSG_PING_REQ,
     SWIM_MSG_ACK,
     SWIM_MSG_SYNC,
-    SWIM_MSG_COMPOUND
+    SWIM_MSG_COMPOUND,
+    SWIM_MSG_DIGEST,            // Anti-entropy: bucket hashes, answered with differences
+    SWIM_MSG_DIGEST_REPLY,      // Responder's hashes, so the initiator can push back
+    SWIM_MSG_USER,              // Application payload for on_message, optionally gossiped on
+    SWIM_MSG_DATA,              // Reliable channel fragment
+    SWIM_MSG_DATA_ACK,          // Reliable channel cumulative + selective acknowledgement
+    SWIM_MSG_PUSH,              // Broadcast tree: eager copy of a user message
+    SWIM_MSG_IHAVE,             // Broadcast tree: lazy announcement of message ids
+    SWIM_MSG_GRAFT,             // Broadcast tree: join the sender's eager set (and resend ids)
+    SWIM_MSG_PRUNE              // Broadcast tree: leave the sender's eager set
 } swim_message_type_t;
 
+// Send priority under a bandwidth budget (lower goes first)
+typedef enum {
+    SWIM_PRIORITY_PROBE = 0,    // PING, PING_REQ, ACK: never held back
+    SWIM_PRIORITY_MEMBERSHIP,   // DIGEST, DIGEST_REPLY, SYNC, DATA_ACK, tree control
+    SWIM_PRIORITY_USER,         // USER, PUSH, DATA
+    SWIM_PRIORITY_COUNT
+} swim_priority_t;
+
 // Node information
 typedef struct swim_node {
     char id[SWIM_NODE_ID_SIZE];
+    uint32_t id_hash;
     char address[64];
     uint16_t port;
     swim_node_state_t state;
     uint32_t incarnation;
-    time_t last_seen;
-    time_t state_change_time;
+    uint64_t last_seen_ms;      // Monotonic ms of last message from node
+    uint64_t state_change_ms;   // Monotonic ms of last state transition
     uint32_t ping_seq;
+    uint64_t probe_sent_ms;     // When the outstanding probe was sent
+    uint64_t probe_sent_us;     // Same, in us, for ACK round-trip stats
+    uint64_t last_ack_ms;       // Last direct ACK (monotonic ms)
+    bool probe_pending;
+    bool probe_failed;          // A probe has failed since the last ACK
+    bool in_probe_list;
+    uint32_t probe_slot;        // Position in ctx->probe_order
+    swim_timer_t probe_timer;   // Direct, then indirect, probe deadline
+    swim_timer_t suspect_timer; // Suspicion expiry
+    swim_channel_t *channel;    // Reliable stream to and from this member, created on use
+    swim_timer_t channel_timer; // Earliest fragment retransmission
+    bool channel_ack_queued;    // In ctx->channel_acks
+    bool tree_eager;            // Broadcast tree edge: PUSH to it, else IHAVE
+    swim_detector_node_t detector;  // ACK delay history and suspicion accusers
+    swim_rtt_t rtt;             // Direct PING -> ACK (and DATA -> DATA_ACK) round trips
+    swim_coord_t coord;         // Vivaldi coordinate (last advertised, or our own)
+    bool has_coord;             // coord came from the member itself
+    char accuser[SWIM_NODE_ID_SIZE];    // Member that raised the current suspicion
     bool is_local;
     bool is_main_node;
+    bool placeholder;           // Seed of a UDP join, until it answers under its real id (never gossiped)
+    int32_t event_slot;         // Pending event in ctx->events, -1 if none
+    swim_dissem_link_t dissem;  // Pending piggyback update
+    struct swim_node *prev;
     struct swim_node *next;
 } swim_node_t;
 
-// SWIM message header
+// PING sent for another member's PING_REQ, awaiting the target's ACK
 typedef struct {
-    uint8_t version;
-    uint8_t type;
-    uint16_t payload_len;
-    uint32_t seq_num;
-    char sender_id[SWIM_NODE_ID_SIZE];
+    uint32_t seq;               // Our PING to the target
+    uint32_t requester_seq;     // Requester's probe seq, echoed in the relayed ACK
+    uint32_t target_hash;
+    swim_node_t *requester;     // NULL when the slot is free
+    uint64_t expires_ms;
+} swim_relay_t;
+
+// Member record in a membership snapshot (a copy; never changes)
+typedef struct {
+    char id[SWIM_NODE_ID_SIZE];
+    uint32_t id_hash;
+    char address[64];
+    uint16_t port;
+    swim_node_state_t state;
     uint32_t incarnation;
-} swim_message_header_t;
+    uint64_t state_change_ms;
+    bool is_local;
+    bool is_main_node;
+} swim_member_t;
 
-// SWIM ping message
+// Immutable, versioned view of the membership, sorted by (id_hash, id)
 typedef struct {
-    swim_message_header_t header;
-    char target_id[SWIM_NODE_ID_SIZE];
-} swim_ping_t;
+    uint64_t version;               // Increases with every published change
+    uint32_t count;
+    uint32_t state_count[NODE_STATE_LEFT + 1];
+    swim_member_t members[];
+} swim_membership_t;
 
-// SWIM ping-req message (indirect probe)
+// Membership change; consecutive changes of one member are merged
 typedef struct {
-    swim_message_header_t header;
-    char target_id[SWIM_NODE_ID_SIZE];
-    char source_id[SWIM_NODE_ID_SIZE];
-} swim_ping_req_t;
+    swim_member_t member;           // Member as of the last merged change
+    swim_node_state_t old_state;    // Before the first merged change (DEAD for new members)
+    swim_node_state_t new_state;
+} swim_event_t;
 
-// SWIM ack message
+// Batch of events drained together
 typedef struct {
-    swim_message_header_t header;
-    char target_id[SWIM_NODE_ID_SIZE];
-    uint8_t payload[SWIM_MAX_PAYLOAD];
-    uint16_t payload_len;
-} swim_ack_t;
+    uint64_t version;               // Membership snapshot version that includes these events
+    bool overflow;                  // Events were dropped: resync from a snapshot
+    uint32_t count;
+    swim_event_t events[SWIM_EVENT_BATCH];
+} swim_event_batch_t;
 
-// SWIM state sync message (gossip)
+// Queue slot (internal)
 typedef struct {
-    swim_message_header_t header;
-    uint32_t node_count;
-    // Followed by array of node state updates
-} swim_sync_t;
+    swim_event_t event;
+    swim_node_t *node;              // Cleared if the node is removed first
+    bool pending;                   // False once a flap cancelled it
+} swim_event_slot_t;
 
-// Node state update (part of sync message)
+// Round-trip statistics for one member
 typedef struct {
     char id[SWIM_NODE_ID_SIZE];
-    char address[64];
-    uint16_t port;
-    uint8_t state;
-    uint32_t incarnation;
-    uint8_t is_main_node;
-} swim_node_update_t;
+    uint32_t samples;               // Round trips measured so far
+    double srtt_ms;                 // Smoothed RTT
+    double rttvar_ms;               // Smoothed mean deviation
+    double p50_ms;                  // Percentiles over the last SWIM_RTT_WINDOW samples
+    double p90_ms;
+    double p99_ms;
+    double max_ms;
+    uint32_t probe_timeout_ms;      // Direct probe deadline currently used for the member
+} swim_rtt_stats_t;
+
+// Member with its predicted round trip, from swim_nearest_nodes
+typedef struct {
+    swim_member_t member;
+    double rtt_ms;
+} swim_neighbor_t;
+
+// Node state update (decoded form of a piggybacked or SYNC entry)
+typedef swim_wire_update_t swim_node_update_t;
 
 // Callback types
-typedef void (*swim_node_event_cb)(swim_node_t *node, swim_node_state_t old_state, swim_node_state_t new_state, void *user_data);
+typedef void (*swim_node_event_cb)(const swim_member_t *member, swim_node_state_t old_state, swim_node_state_t new_state, void *user_data);
 typedef void (*swim_message_cb)(swim_node_t *from, const uint8_t *payload, size_t len, void *user_data);
+typedef void (*swim_reliable_cb)(const char *node_id, uint32_t msg_id, bool delivered, void *user_data);
 
 // SWIM context
+// Encoded message waiting in the outbox
+typedef struct {
+    struct sockaddr_in to;
+    uint32_t offset;            // Into outbox_data
+    uint32_t len;               // 0 once packed
+} swim_outbox_entry_t;
+
+// Recently delivered user message, by origin and origin seq
+typedef struct {
+    uint64_t origin;            // 64-bit hash of the full origin id, 0 when unused
+    uint32_t seq;
+    uint32_t seen_ms;           // Low 32 bits of the clock when recorded
+} swim_user_key_t;
+
 typedef struct swim_context {
     char local_id[SWIM_NODE_ID_SIZE];
     char local_address[64];
@@ -128,6 +247,48 @@ typedef struct swim_context {
     
     swim_node_t *nodes;
     uint32_t node_count;
+    swim_index_t index;     // ID -> node lookup over the list above
+    swim_node_t *local;
+    swim_dissem_t dissem;   // Recent state changes awaiting piggyback
+    
+    // Probe scheduler: shuffled round-robin over live remote members
+    swim_node_t **probe_order;
+    uint32_t probe_count;
+    uint32_t probe_capacity;
+    uint32_t probe_cursor;
+    swim_rand_t rng;
+    
+    // Protocol deadlines
+    swim_timer_wheel_t timers;
+    uint64_t next_round_ms;
+    swim_detector_t detector;   // Probe and suspicion timeout policy
+    
+    // Indirect probing: direct-mapped by seq, entries verified on lookup
+    swim_node_t *probe_by_seq[SWIM_PROBE_SEQ_SLOTS];
+    swim_relay_t relays[SWIM_RELAY_SLOTS];
+    
+    // Push-pull anti-entropy
+    uint32_t sync_rounds;       // Gossip rounds since the last exchange
+    
+    // Join bootstrap: TCP listener for full-state exchanges (swim_init or
+    // swim_listen_bootstrap, else SWIM_TRANSPORT_NO_FD), and seeds joined
+    // over UDP instead
+    swim_socket_t bootstrap_fd;
+    swim_node_t *join_seeds[SWIM_JOIN_SEEDS];
+    
+    // Lock-free membership snapshots: rebuilt by the writer after changes,
+    // old versions freed once no reader is pinned to them
+    swim_epoch_t epoch;
+    swim_atomic_u64 membership;     // Current swim_membership_t*
+    uint64_t membership_version;
+    bool membership_dirty;
+    
+    // Membership event queue (ring, grows to SWIM_EVENT_QUEUE), drained outside the lock
+    swim_event_slot_t *events;
+    uint32_t event_capacity;
+    uint32_t event_head;
+    uint32_t event_count;
+    bool event_overflow;
     
     bool is_running;
     bool is_main_node;
@@ -136,29 +297,225 @@ typedef struct swim_context {
     uint32_t probe_timeout_ms;
     uint32_t suspect_timeout_ms;
     
-    // Socket
+    // Datagram transport and clock (owned)
+    swim_transport_t *transport;
+    swim_transport_t *tx;   // Where sends are queued: transport, or a shard handling a batch
+    
+    // Messages sent since the last flush; those to the same peer are packed
+    // into COMPOUND datagrams of up to mtu bytes when the batch is flushed
+    swim_outbox_entry_t outbox[SWIM_OUTBOX_MAX];
+    uint8_t outbox_data[SWIM_OUTBOX_BYTES];
+    uint32_t outbox_count;
+    uint32_t outbox_used;
+    uint32_t mtu;
+    
+    // Keys of recently received messages; exact copies are dropped
+    swim_dedup_t dedup;
+    
+    // User messages: received ones wait for on_message outside the lock;
+    // (origin, seq) keys of recent ones, set-associative and forgotten
+    // after SWIM_USER_SEEN_MS, drop duplicates
+    struct swim_user_msg *user_head;
+    struct swim_user_msg *user_tail;
+    uint32_t user_queued;
+    swim_epoch_guard_t user_guard;  // Pinned while queued messages point at their senders
+    bool user_pinned;
+    swim_user_key_t user_seen[SWIM_USER_SEEN];
+    uint32_t user_seq;
+    uint32_t broadcast_fanout;  // 0: swim_broadcast unicasts to every member
+    bool broadcast_tree;        // swim_broadcast uses the Plumtree broadcast tree
+    
+    // Plumtree: eager peers form the tree, lazy ones get IHAVEs to repair it
+    swim_tree_t tree;
+    uint32_t tree_eager_count;
+    bool tree_seeded;           // Initial random edges chosen
+    
+    // Send budget per gossip round (0: unlimited). Messages over it wait,
+    // by priority, for the next round; probes only draw it down.
+    uint32_t budget_bytes;
+    uint32_t budget_packets;
+    int64_t budget_bytes_left;
+    int64_t budget_packets_left;
+    struct swim_deferred *backlog_head[SWIM_PRIORITY_COUNT];
+    struct swim_deferred *backlog_tail[SWIM_PRIORITY_COUNT];
+    uint32_t backlog_bytes;
+    
+    // Reliable channels: receivers owing a DATA_ACK (sent at the next flush),
+    // and message outcomes awaiting on_reliable outside the lock
+    swim_node_t *channel_acks[SWIM_OUTBOX_MAX];
+    uint32_t channel_ack_count;
+    struct swim_reliable_done *reliable_head;
+    struct swim_reliable_done *reliable_tail;
+    bool has_thread;        // Protocol thread running (transport has a descriptor)
+    struct swim_reactor_loop *reactor;  // Shared loop driving this context instead, or NULL
+    
+    // Extra SO_REUSEPORT sockets on the same port, each drained by a worker thread
+    struct swim_rx_shard *shards;
+    uint32_t shard_count;
 #ifdef _WIN32
-    SOCKET sock;
     HANDLE thread;
     CRITICAL_SECTION lock;
+    CRITICAL_SECTION dispatch_lock;
 #else
-    int sock;
     pthread_t thread;
     pthread_mutex_t lock;
+    pthread_mutex_t dispatch_lock;  // Keeps callbacks in order across delivering threads
+    int epoll_fd;           // Event loop (Linux), -1 when using poll()
+    int timer_fd;           // Armed to the next protocol deadline
+    int wake_fd;            // Interrupts the loop on stop
+    pthread_t bootstrap_thread; // Answers bootstrap connections
+    int bootstrap_wake_fd;
+    bool bootstrap_running;
 #endif
     
     // Callbacks
     swim_node_event_cb on_node_event;
     swim_message_cb on_message;
-    void *user_data;
+    swim_reliable_cb on_reliable;
+    void *node_user_data;       // Each callback gets what its setter was given
+    void *message_user_data;
+    void *reliable_user_data;
     
     // Statistics
     uint64_t messages_sent;
     uint64_t messages_received;
+    uint64_t duplicates_dropped;
     uint64_t probe_success;
     uint64_t probe_failure;
+    uint64_t probe_passes;
+    uint64_t first_probe_samples;
+    uint64_t first_probe_total_ms;
+    uint64_t first_probe_max_ms;
+    uint64_t ack_samples;
+    uint64_t ack_total_us;
+    uint64_t ack_max_us;
+    uint64_t suspicions;
+    uint64_t suspicions_cleared;
+    uint64_t deaths;
+    uint64_t self_refutes;
+    uint64_t indirect_probes;
+    uint64_t indirect_acks;
+    uint64_t relayed_acks;
+    uint64_t sync_exchanges;
+    uint64_t sync_pages;
+    uint64_t sync_entries;
+    uint64_t bootstrap_joins;
+    uint64_t bootstrap_served;
+    uint64_t bootstrap_entries;
+    uint64_t bootstrap_failures;
+    uint64_t events_queued;
+    uint64_t events_coalesced;
+    uint64_t events_dropped;
+    uint64_t coord_updates;
+    uint64_t datagrams_sent;
+    uint64_t compound_sent;
+    uint64_t compound_parts;
+    uint64_t compound_received;
+    uint64_t user_sent;
+    uint64_t user_received;
+    uint64_t user_duplicates;
+    uint64_t user_forwarded;
+    uint64_t user_dropped;
+    uint64_t channel_sent;
+    uint64_t channel_acked;
+    uint64_t channel_failed;
+    uint64_t channel_received;
+    uint64_t channel_fragments;
+    uint64_t channel_retransmits;
+    uint64_t tree_ihave_sent;
+    uint64_t tree_graft_sent;
+    uint64_t tree_prune_sent;
+    uint64_t budget_deferred_bytes;
+    uint64_t budget_dropped_bytes;
+    uint64_t budget_probe_overdraft;
 } swim_context_t;
 
+// Detailed statistics
+typedef struct {
+    uint64_t messages_sent;
+    uint64_t messages_received;     // Handled, not counting duplicates_dropped
+    // Exact copies of a recent (sender, seq, type) dropped after the header
+    uint64_t duplicates_dropped;
+    double duplicate_rate;          // Share of parsed messages that were copies
+    uint64_t probe_success;
+    uint64_t probe_failure;
+    uint64_t probe_passes;          // Completed passes over the probe order
+    uint32_t probe_members;         // Members currently in the probe order
+    // Time from a failed node's last ACK to the probe that caught it
+    uint64_t first_probe_samples;
+    double first_probe_avg_ms;
+    uint64_t first_probe_max_ms;
+    // PING -> ACK round trip of direct probes
+    uint64_t ack_samples;
+    double ack_rtt_avg_us;
+    uint64_t ack_rtt_max_us;
+    // Failure detector: cleared suspicions are the false positives
+    uint64_t suspicions;            // Members moved to SUSPECT
+    uint64_t suspicions_cleared;    // SUSPECT members seen ALIVE again
+    uint64_t deaths;                // Members declared DEAD
+    uint64_t self_refutes;          // Suspicions of this node refuted
+    uint32_t local_health;          // Lifeguard health multiplier (0 = healthy)
+    // Indirect probing
+    uint64_t indirect_probes;       // PING_REQs sent after direct probe timeouts
+    uint64_t indirect_acks;         // Probes answered only through a helper
+    uint64_t relayed_acks;          // ACKs relayed for other members' PING_REQs
+    // Push-pull anti-entropy
+    uint64_t sync_exchanges;        // Digests sent (initiated or answered)
+    uint64_t sync_pages;            // SYNC datagrams carrying differing buckets
+    uint64_t sync_entries;          // Member entries in those datagrams
+    // Join bootstrap over TCP
+    uint64_t bootstrap_joins;       // swim_join calls that fetched the seed's state
+    uint64_t bootstrap_served;      // Exchanges answered for joining nodes
+    uint64_t bootstrap_entries;     // Member entries received in either role
+    uint64_t bootstrap_failures;    // Joins that fell back to UDP
+    // Membership events
+    uint64_t events_queued;
+    uint64_t events_coalesced;      // Merged into a pending event (or cancelled by a flap)
+    uint64_t events_dropped;        // Lost to a full queue
+    // Network coordinates
+    uint64_t coord_updates;         // RTT samples applied to the local coordinate
+    double coord_error;             // Local coordinate's relative error (1.5 = untrained)
+    // Socket I/O: datagrams per syscall shows the batching gain
+    uint64_t io_rx_syscalls;
+    uint64_t io_rx_datagrams;
+    uint64_t io_tx_syscalls;
+    uint64_t io_tx_datagrams;
+    uint64_t io_tx_bytes;
+    uint64_t io_tx_dropped;
+    // Compound packing: messages_sent counts messages, datagrams_sent what carried them
+    uint32_t mtu;
+    uint64_t datagrams_sent;
+    uint64_t compound_sent;         // COMPOUND datagrams sent
+    uint64_t compound_parts;        // Messages packed into them
+    uint64_t compound_received;
+    // User messages
+    uint64_t user_sent;             // Originated by swim_broadcast / swim_send_to
+    uint64_t user_received;         // Delivered (or queued) for on_message
+    uint64_t user_duplicates;       // Seen before and dropped
+    uint64_t user_forwarded;        // Gossip copies sent on for other origins
+    uint64_t user_dropped;          // Lost to a full delivery queue
+    // Reliable channels
+    uint64_t channel_sent;          // Messages accepted by swim_send_reliable
+    uint64_t channel_acked;         // Confirmed delivered
+    uint64_t channel_failed;        // Reported undelivered (retries exhausted, member gone)
+    uint64_t channel_received;      // Reassembled and delivered to on_message
+    uint64_t channel_fragments;     // DATA fragments sent, first transmissions
+    uint64_t channel_retransmits;   // DATA fragments sent again
+    // Broadcast tree (user_duplicates above are its redundant PUSHes)
+    uint32_t tree_eager_peers;      // Current tree edges
+    uint64_t tree_ihave_sent;
+    uint64_t tree_graft_sent;       // Missing messages requested, plus edges repaired
+    uint64_t tree_prune_sent;       // Redundant edges cut
+    // Send budget
+    uint64_t budget_deferred_bytes; // Held back to a later round
+    uint64_t budget_dropped_bytes;  // Discarded from a full backlog
+    uint64_t budget_probe_overdraft;    // Probe bytes sent with the budget spent
+    uint32_t backlog_bytes;         // Waiting now
+    // Receive shards (io_* above include them)
+    uint32_t rx_shards;             // Sockets on the port, including the main one
+    uint64_t shard_rx_datagrams;    // Received by shard workers
+} swim_stats_t;
+
 // API Functions
 
 /**
@@ -170,13 +527,44 @@ typedef struct swim_context {
  */
 swim_context_t* swim_init(const char *local_id, uint16_t port, uint32_t gossip_interval_ms);
 
+/**
+ * Initialize SWIM context whose port is served by rx_shards SO_REUSEPORT
+ * sockets: the main one plus rx_shards - 1 each drained by its own worker
+ * thread (for seed and main nodes with high fan-in). Membership changes
+ * from every worker go through the same lock, snapshots and event queue.
+ * Falls back to swim_init where the kernel does not balance SO_REUSEPORT.
+ * @param rx_shards Receive sockets (1 to SWIM_RX_SHARDS_MAX)
+ */
+swim_context_t* swim_init_sharded(const char *local_id, uint16_t port, uint32_t gossip_interval_ms,
+                                  uint32_t rx_shards);
+
+/**
+ * Initialize SWIM context over a caller-supplied transport
+ * @param port Port this node advertises (the transport's address)
+ * @param transport Owned by the context from here on, also on failure
+ * @return SWIM context or NULL on failure
+ */
+swim_context_t* swim_init_transport(const char *local_id, uint16_t port, uint32_t gossip_interval_ms,
+                                    swim_transport_t *transport);
+
+/**
+ * Accept join bootstraps over TCP on the context's port, as swim_init
+ * does. For swim_init_transport contexts whose transport owns that UDP
+ * port (swim_transport_shm, say); without it their joins and joiners use
+ * the UDP path. Call before swim_start.
+ * @return 0 if listening, -1 if the TCP port could not be opened
+ */
+int swim_listen_bootstrap(swim_context_t *ctx);
+
 /**
  * Destroy SWIM context and free resources
  */
 void swim_destroy(swim_context_t *ctx);
 
 /**
- * Start SWIM protocol (begins gossip thread)
+ * Start SWIM protocol (begins gossip thread; a context attached to a
+ * swim_reactor is driven by its loop instead, and one without a transport
+ * descriptor is only marked running for the owner to drive)
  */
 int swim_start(swim_context_t *ctx);
 
@@ -191,7 +579,20 @@ void swim_stop(swim_context_t *ctx);
 void swim_process(swim_context_t *ctx);
 
 /**
- * Join an existing mesh by connecting to a seed node
+ * Fire due timers and run the gossip round if the protocol period is up
+ * (what the protocol thread does between receives)
+ * @return Next deadline, in ms on the transport clock
+ */
+uint64_t swim_run_due(swim_context_t *ctx);
+
+/**
+ * Join an existing mesh by connecting to a seed node. A context that
+ * listens for bootstraps (swim_init, swim_listen_bootstrap) first exchanges
+ * full state with the seed over TCP (same port), so every member,
+ * incarnation and flag is known when it returns.
+ * Otherwise, or if the seed does not answer, the seed gets a placeholder
+ * entry that is PINGed and SYNCed over UDP and replaced by the seed's
+ * real entry once it replies.
  * @param ctx SWIM context
  * @param address Seed node address
  * @param port Seed node port
@@ -204,8 +605,27 @@ int swim_join(swim_context_t *ctx, const char *address, uint16_t port);
  */
 void swim_leave(swim_context_t *ctx);
 
+/**
+ * Pin the current membership snapshot without taking the context lock.
+ * It stays valid and unchanged until swim_membership_release(); the
+ * protocol thread keeps running and publishes newer versions meanwhile.
+ */
+const swim_membership_t* swim_membership_acquire(swim_context_t *ctx, swim_epoch_guard_t *guard);
+
+/**
+ * Unpin a snapshot from swim_membership_acquire
+ */
+void swim_membership_release(swim_context_t *ctx, swim_epoch_guard_t *guard);
+
+/**
+ * Find a member in a snapshot (binary search)
+ */
+const swim_member_t* swim_membership_find(const swim_membership_t *membership, const char *id);
+
 /**
  * Get all known nodes
+ * Returned pointers are live protocol state; prefer swim_membership_acquire,
+ * which cannot race with node removal.
  * @param ctx SWIM context
  * @param nodes Output array (caller allocates)
  * @param max_nodes Maximum nodes to return
@@ -214,7 +634,7 @@ void swim_leave(swim_context_t *ctx);
 uint32_t swim_get_nodes(swim_context_t *ctx, swim_node_t **nodes, uint32_t max_nodes);
 
 /**
- * Get count of nodes by state
+ * Get count of nodes by state (lock-free, from the current snapshot)
  */
 uint32_t swim_get_node_count(swim_context_t *ctx, swim_node_state_t state);
 
@@ -225,38 +645,163 @@ swim_node_t* swim_get_local_node(swim_context_t *ctx);
 
 /**
  * Find node by ID
+ * Returns live protocol state; prefer swim_membership_find on a snapshot.
  */
 swim_node_t* swim_find_node(swim_context_t *ctx, const char *id);
 
 /**
- * Set node event callback
+ * Get round-trip statistics for one member
+ * @return 0 on success, -1 if the member is unknown
+ */
+int swim_get_node_rtt(swim_context_t *ctx, const char *id, swim_rtt_stats_t *stats);
+
+/**
+ * Get round-trip statistics for every remote member with at least one sample
+ * @return Number of entries written
+ */
+uint32_t swim_get_rtt_stats(swim_context_t *ctx, swim_rtt_stats_t *stats, uint32_t max_stats);
+
+/**
+ * Predict the round trip between two members from their network
+ * coordinates (either may be this node), without probing
+ * @return ms, or -1 if a member is unknown or has not advertised a coordinate
+ */
+double swim_estimate_rtt(swim_context_t *ctx, const char *id_a, const char *id_b);
+
+/**
+ * Find the alive members predicted closest to a member
+ * @param from Member ID, or NULL for this node (which is then excluded)
+ * @param out Nearest first
+ * @return Number of entries written (at most k)
+ */
+uint32_t swim_nearest_nodes(swim_context_t *ctx, const char *from, uint32_t k, swim_neighbor_t *out);
+
+/**
+ * Drain up to SWIM_EVENT_BATCH membership events without blocking the
+ * protocol thread. Use from a consumer thread when no node callback is set.
+ * @return Number of events in batch (0 when the queue is empty)
+ */
+uint32_t swim_poll_events(swim_context_t *ctx, swim_event_batch_t *batch);
+
+/**
+ * Set node event callback. Events are delivered in batches by the protocol
+ * thread after it releases the context lock, so the callback may call back
+ * into the API.
  */
 void swim_set_node_callback(swim_context_t *ctx, swim_node_event_cb callback, void *user_data);
 
 /**
- * Set message callback for custom payloads
+ * Set message callback for custom payloads. Each message sent with
+ * swim_broadcast or swim_send_to is delivered once per member while the
+ * member remembers it (the last SWIM_USER_SEEN messages, for up to
+ * SWIM_USER_SEEN_MS). A copy arriving after that, such as a late gossip
+ * or GRAFT reply under heavy broadcast load, is delivered again, so
+ * callers must tolerate rare duplicates. Delivery happens
+ * on the delivering thread after it releases the context lock; from is
+ * the originating member (or the neighbour that relayed it, if the origin
+ * is not yet known). It stays allocated until the callback returns, even
+ * if the member is removed in the meantime.
  */
 void swim_set_message_callback(swim_context_t *ctx, swim_message_cb callback, void *user_data);
 
 /**
- * Broadcast a custom message to all nodes
+ * Broadcast a custom message to all nodes. With fanout 0 (the default) it
+ * is unicast to every live member; otherwise it goes to fanout random
+ * members, and each forwards it once to fanout more until it has gone
+ * log2(members) + SWIM_BROADCAST_HOPS_EXTRA hops, so the origin's cost is
+ * independent of cluster size. In tree mode it follows the broadcast tree
+ * instead (see swim_set_broadcast_tree).
+ * @return Members sent to directly, or -1 if the payload does not fit the MTU
  */
 int swim_broadcast(swim_context_t *ctx, const uint8_t *payload, size_t len);
 
 /**
  * Send message to specific node
+ * @return 0 on success, -1 if the node is unknown or the payload does not fit the MTU
  */
 int swim_send_to(swim_context_t *ctx, const char *node_id, const uint8_t *payload, size_t len);
 
+/**
+ * Send a message of up to SWIM_CHANNEL_MAX_MESSAGE bytes reliably and in
+ * order. It is cut into MTU-sized fragments, retransmitted until the member
+ * acknowledges them, and handed to the member's on_message whole. The
+ * outcome is reported to the reliable callback: delivered, or not after
+ * SWIM_CHANNEL_MAX_RETRIES sends of a fragment or once the member is DEAD
+ * or LEFT (the member may still have received it).
+ * @param msg_id Set to the id passed to the reliable callback (may be NULL)
+ * @return 0 on success, -1 if the node is unknown, the message too large,
+ *         or the member's queue full
+ */
+int swim_send_reliable(swim_context_t *ctx, const char *node_id, const uint8_t *payload, size_t len,
+                       uint32_t *msg_id);
+
+/**
+ * Set the callback told whether each swim_send_reliable message was
+ * delivered, on the delivering thread after it releases the context lock.
+ */
+void swim_set_reliable_callback(swim_context_t *ctx, swim_reliable_cb callback, void *user_data);
+
+/**
+ * Select swim_broadcast's mode: 0 unicasts to every member, otherwise gossip
+ * with this fanout. A member misses a gossiped message with probability
+ * about e^-fanout, so ln(members) + 3 suits most clusters.
+ */
+void swim_set_broadcast_fanout(swim_context_t *ctx, uint32_t fanout);
+
+/**
+ * Broadcast along a Plumtree epidemic broadcast tree. Each member pushes
+ * messages eagerly to its tree neighbours and announces their ids (IHAVE)
+ * to fanout other members (SWIM_BROADCAST_FANOUT if fanout is 0). The tree
+ * starts as fanout random edges per member; an edge that delivers a
+ * duplicate is PRUNEd, and a member missing an announced message GRAFTs
+ * onto the announcer, so it settles into a spanning tree where each
+ * message arrives about once per member. An edge to a member that turns
+ * SUSPECT or DEAD is replaced by one to a random live member.
+ */
+void swim_set_broadcast_tree(swim_context_t *ctx, bool enable);
+
 /**
  * Set this node as main coordinator
  */
 void swim_set_main_node(swim_context_t *ctx, bool is_main);
 
+/**
+ * Set the datagram budget for packed and piggybacked messages
+ * (SWIM_MTU_MIN to SWIM_MAX_DATAGRAM, default SWIM_MAX_DATAGRAM)
+ */
+void swim_set_mtu(swim_context_t *ctx, uint32_t mtu);
+
+/**
+ * Limit what this node sends per gossip round (0 for either: no limit).
+ * Each round's allowance goes to probes and ACKs first, which are never
+ * held back, then membership sync and small control messages, then user
+ * payloads; messages that do not fit wait for a later round in priority
+ * order. Once SWIM_BACKLOG_BYTES are waiting, the oldest lowest-priority
+ * messages are dropped. Packets are counted per message, before COMPOUND
+ * packing.
+ */
+void swim_set_bandwidth_budget(swim_context_t *ctx, uint32_t bytes_per_round, uint32_t packets_per_round);
+
+/**
+ * Select a built-in failure detector (default SWIM_DETECTOR_LIFEGUARD)
+ */
+void swim_set_detector(swim_context_t *ctx, swim_detector_mode_t mode);
+
+/**
+ * Install a custom failure detector policy (NULL restores STATIC).
+ * ops must stay valid for the lifetime of the context.
+ */
+void swim_set_detector_ops(swim_context_t *ctx, const swim_detector_ops_t *ops);
+
 /**
  * Get statistics
  */
 void swim_get_stats(swim_context_t *ctx, uint64_t *sent, uint64_t *received, 
                     uint64_t *probe_success, uint64_t *probe_failure);
 
+/**
+ * Get detailed statistics
+ */
+void swim_get_detailed_stats(swim_context_t *ctx, swim_stats_t *stats);
+
 #endif // SWIM_GOSSIP_H
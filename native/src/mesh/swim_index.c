@@ -0,0 +1,168 @@
+/**
+ * LSDAMM - SWIM Membership Index Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_index.h"
+#include "swim_gossip.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Marker for deleted slots (keeps probe chains intact)
+#define SWIM_INDEX_TOMBSTONE ((struct swim_node*)(uintptr_t)1)
+
+/**
+ * Hash a node ID
+ */
+uint32_t swim_hash_id(const char *id) {
+    uint32_t hash = 2166136261u;
+    while (*id) {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Round up to next power of two
+ */
+static uint32_t swim_index_round_capacity(uint32_t n) {
+    uint32_t cap = SWIM_INDEX_MIN_CAPACITY;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+/**
+ * Place node into the first free slot of its probe chain
+ */
+static void swim_index_place(swim_index_slot_t *slots, uint32_t capacity, uint32_t hash, struct swim_node *node) {
+    uint32_t mask = capacity - 1;
+    uint32_t i = hash & mask;
+    while (slots[i].node && slots[i].node != SWIM_INDEX_TOMBSTONE) {
+        i = (i + 1) & mask;
+    }
+    slots[i].hash = hash;
+    slots[i].node = node;
+}
+
+/**
+ * Rehash into a table of the given capacity (drops tombstones)
+ */
+static int swim_index_resize(swim_index_t *index, uint32_t capacity) {
+    swim_index_slot_t *slots = (swim_index_slot_t*)calloc(capacity, sizeof(swim_index_slot_t));
+    if (!slots) return -1;
+
+    for (uint32_t i = 0; i < index->capacity; i++) {
+        struct swim_node *node = index->slots[i].node;
+        if (node && node != SWIM_INDEX_TOMBSTONE) {
+            swim_index_place(slots, capacity, index->slots[i].hash, node);
+        }
+    }
+
+    free(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    index->tombstones = 0;
+    return 0;
+}
+
+/**
+ * Initialize index
+ */
+int swim_index_init(swim_index_t *index, uint32_t capacity_hint) {
+    memset(index, 0, sizeof(*index));
+
+    // Keep load factor under 0.7 for the expected size
+    index->capacity = swim_index_round_capacity(capacity_hint + capacity_hint / 2);
+    index->slots = (swim_index_slot_t*)calloc(index->capacity, sizeof(swim_index_slot_t));
+    if (!index->slots) {
+        index->capacity = 0;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Destroy index
+ */
+void swim_index_destroy(swim_index_t *index) {
+    free(index->slots);
+    memset(index, 0, sizeof(*index));
+}
+
+/**
+ * Find node by ID
+ */
+struct swim_node* swim_index_find(const swim_index_t *index, const char *id, uint32_t hash) {
+    if (!index->slots) return NULL;
+
+    uint32_t mask = index->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (index->slots[i].node) {
+        struct swim_node *node = index->slots[i].node;
+        if (node != SWIM_INDEX_TOMBSTONE && index->slots[i].hash == hash &&
+            strcmp(node->id, id) == 0) {
+            return node;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * Insert node
+ */
+int swim_index_insert(swim_index_t *index, struct swim_node *node) {
+    // Grow (or purge tombstones) before load exceeds 0.7
+    if ((index->count + index->tombstones + 1) * 10 > index->capacity * 7) {
+        uint32_t capacity = index->capacity;
+        if ((index->count + 1) * 10 > capacity * 5) {
+            capacity <<= 1;
+        }
+        if (swim_index_resize(index, capacity) != 0) return -1;
+    }
+
+    uint32_t mask = index->capacity - 1;
+    uint32_t i = node->id_hash & mask;
+    while (index->slots[i].node && index->slots[i].node != SWIM_INDEX_TOMBSTONE) {
+        i = (i + 1) & mask;
+    }
+
+    if (index->slots[i].node == SWIM_INDEX_TOMBSTONE) {
+        index->tombstones--;
+    }
+    index->slots[i].hash = node->id_hash;
+    index->slots[i].node = node;
+    index->count++;
+
+    return 0;
+}
+
+/**
+ * Remove node by ID
+ */
+struct swim_node* swim_index_remove(swim_index_t *index, const char *id, uint32_t hash) {
+    if (!index->slots) return NULL;
+
+    uint32_t mask = index->capacity - 1;
+    uint32_t i = hash & mask;
+
+    while (index->slots[i].node) {
+        struct swim_node *node = index->slots[i].node;
+        if (node != SWIM_INDEX_TOMBSTONE && index->slots[i].hash == hash &&
+            strcmp(node->id, id) == 0) {
+            index->slots[i].node = SWIM_INDEX_TOMBSTONE;
+            index->count--;
+            index->tombstones++;
+            return node;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,71 @@
+/**
+ * LSDAMM - SWIM Membership Index Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Open-addressing hash index over the SWIM node list, keyed on node ID.
+ * Gives O(1) expected lookup, insert and removal independent of cluster size.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_INDEX_H
+#define SWIM_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct swim_node;
+
+#define SWIM_INDEX_MIN_CAPACITY 16
+
+// Index slot (hash cached so probes rarely touch the node itself)
+typedef struct {
+    uint32_t hash;
+    struct swim_node *node;     // NULL = empty, SWIM_INDEX_TOMBSTONE = deleted
+} swim_index_slot_t;
+
+// Node index (linear probing, power-of-two capacity)
+typedef struct {
+    swim_index_slot_t *slots;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t tombstones;
+} swim_index_t;
+
+/**
+ * Hash a node ID (FNV-1a, 32-bit)
+ */
+uint32_t swim_hash_id(const char *id);
+
+/**
+ * Initialize index
+ * @param index Index to initialize
+ * @param capacity_hint Expected number of nodes (0 for default)
+ * @return 0 on success, -1 on allocation failure
+ */
+int swim_index_init(swim_index_t *index, uint32_t capacity_hint);
+
+/**
+ * Free index storage (does not free nodes)
+ */
+void swim_index_destroy(swim_index_t *index);
+
+/**
+ * Find node by ID
+ * @param hash Precomputed swim_hash_id(id)
+ */
+struct swim_node* swim_index_find(const swim_index_t *index, const char *id, uint32_t hash);
+
+/**
+ * Insert node (node->id_hash must be set, ID must not already be present)
+ * @return 0 on success, -1 on allocation failure
+ */
+int swim_index_insert(swim_index_t *index, struct swim_node *node);
+
+/**
+ * Remove node by ID
+ * @return Removed node or NULL if not present
+ */
+struct swim_node* swim_index_remove(swim_index_t *index, const char *id, uint32_t hash);
+
+#endif // SWIM_INDEX_H
@@ -0,0 +1,317 @@
+/**
+ * LSDAMM - SWIM Batched Datagram I/O Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "swim_io.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+#include <netinet/udp.h>
+#define SWIM_IO_HAVE_MMSG 1
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#define SWIM_IO_GSO_MAX_SEGS    64      // Kernel limit per GSO send
+#define SWIM_IO_GSO_MAX_BYTES   65000   // Stay under the 64 KB UDP payload limit
+#endif
+
+/**
+ * Initialize batched I/O
+ */
+int swim_io_init(swim_io_t *io, swim_socket_t sock) {
+    memset(io, 0, sizeof(*io));
+    io->sock = sock;
+
+    io->rx_storage = (uint8_t*)malloc((size_t)SWIM_IO_BATCH * SWIM_IO_RX_SIZE);
+    io->tx_storage = (uint8_t*)malloc((size_t)SWIM_IO_BATCH * SWIM_IO_TX_SIZE);
+    if (!io->rx_storage || !io->tx_storage) {
+        swim_io_destroy(io);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < SWIM_IO_BATCH; i++) {
+        io->rx[i].data = io->rx_storage + (size_t)i * SWIM_IO_RX_SIZE;
+    }
+
+#ifdef SWIM_IO_HAVE_MMSG
+    io->use_mmsg = true;
+
+    // UDP_SEGMENT is readable on kernels that support GSO (4.18+)
+    int gso_size = 0;
+    socklen_t opt_len = sizeof(gso_size);
+    io->use_gso = getsockopt(sock, SOL_UDP, UDP_SEGMENT, &gso_size, &opt_len) == 0;
+#endif
+
+    return 0;
+}
+
+/**
+ * Free buffers
+ */
+void swim_io_destroy(swim_io_t *io) {
+    free(io->rx_storage);
+    free(io->tx_storage);
+    io->rx_storage = NULL;
+    io->tx_storage = NULL;
+    io->tx_count = 0;
+}
+
+/**
+ * Send one datagram directly
+ */
+static bool swim_io_sendto(swim_io_t *io, const struct sockaddr_in *addr, const uint8_t *data, size_t len) {
+    int sent = sendto(io->sock, (const char*)data, (int)len, 0,
+                      (const struct sockaddr*)addr, sizeof(*addr));
+    io->tx_syscalls++;
+
+    if (sent < 0) {
+        io->tx_dropped++;
+        return false;
+    }
+    io->tx_datagrams++;
+    return true;
+}
+
+/**
+ * Receive a batch of datagrams
+ */
+uint32_t swim_io_recv(swim_io_t *io) {
+#ifdef SWIM_IO_HAVE_MMSG
+    if (io->use_mmsg) {
+        struct mmsghdr msgs[SWIM_IO_BATCH];
+        struct iovec iov[SWIM_IO_BATCH];
+        memset(msgs, 0, sizeof(msgs));
+
+        for (uint32_t i = 0; i < SWIM_IO_BATCH; i++) {
+            iov[i].iov_base = io->rx[i].data;
+            iov[i].iov_len = SWIM_IO_RX_SIZE;
+            msgs[i].msg_hdr.msg_name = &io->rx[i].from;
+            msgs[i].msg_hdr.msg_namelen = sizeof(io->rx[i].from);
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int received = recvmmsg(io->sock, msgs, SWIM_IO_BATCH, MSG_DONTWAIT, NULL);
+        io->rx_syscalls++;
+
+        if (received > 0) {
+            for (int i = 0; i < received; i++) {
+                io->rx[i].len = msgs[i].msg_len;
+            }
+            io->rx_datagrams += (uint64_t)received;
+            return (uint32_t)received;
+        }
+
+        if (errno != ENOSYS) return 0;
+
+        log_warn("SWIM: recvmmsg unavailable, using per-datagram I/O");
+        io->use_mmsg = false;
+    }
+#endif
+
+    uint32_t count = 0;
+    while (count < SWIM_IO_BATCH) {
+        socklen_t from_len = sizeof(io->rx[count].from);
+        int received = recvfrom(io->sock, (char*)io->rx[count].data, SWIM_IO_RX_SIZE, 0,
+                                (struct sockaddr*)&io->rx[count].from, &from_len);
+        io->rx_syscalls++;
+
+        if (received <= 0) break;
+        io->rx[count++].len = (size_t)received;
+    }
+
+    io->rx_datagrams += count;
+    return count;
+}
+
+/**
+ * Queue datagram by reference
+ */
+void swim_io_queue_ref(swim_io_t *io, const struct sockaddr_in *addr, const uint8_t *data, size_t len) {
+    if (io->tx_count == SWIM_IO_BATCH) {
+        swim_io_flush(io);
+    }
+
+    swim_io_tx_t *tx = &io->tx[io->tx_count++];
+    tx->addr = *addr;
+    tx->data = data;
+    tx->len = (uint32_t)len;
+}
+
+/**
+ * Queue copy of datagram
+ */
+void swim_io_queue(swim_io_t *io, const struct sockaddr_in *addr, const uint8_t *data, size_t len) {
+    if (len > SWIM_IO_TX_SIZE) {
+        // Keep ordering: anything queued goes out first
+        swim_io_flush(io);
+        swim_io_sendto(io, addr, data, len);
+        return;
+    }
+
+    if (io->tx_count == SWIM_IO_BATCH) {
+        swim_io_flush(io);
+    }
+
+    uint8_t *slot = io->tx_storage + (size_t)io->tx_count * SWIM_IO_TX_SIZE;
+    memcpy(slot, data, len);
+    swim_io_queue_ref(io, addr, slot, len);
+}
+
+#ifdef SWIM_IO_HAVE_MMSG
+/**
+ * Same destination address and port
+ */
+static bool swim_io_same_peer(const swim_io_tx_t *a, const swim_io_tx_t *b) {
+    return a->addr.sin_addr.s_addr == b->addr.sin_addr.s_addr &&
+           a->addr.sin_port == b->addr.sin_port;
+}
+
+/**
+ * Send the queue with sendmmsg. Runs of equal-sized datagrams to one peer
+ * (the last may be shorter) become a single UDP_SEGMENT message.
+ * @return Datagrams sent
+ */
+static uint32_t swim_io_flush_mmsg(swim_io_t *io) {
+    struct mmsghdr msgs[SWIM_IO_BATCH];
+    struct iovec iov[SWIM_IO_BATCH];
+    uint32_t first[SWIM_IO_BATCH];      // First queued datagram of each message
+    uint32_t segs[SWIM_IO_BATCH];       // Datagrams carried by each message
+    union {
+        char buf[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr align;
+    } ctrl[SWIM_IO_BATCH];
+
+    uint32_t count = io->tx_count;
+    uint32_t n_msgs = 0;
+    memset(msgs, 0, sizeof(msgs));
+
+    for (uint32_t i = 0; i < count; ) {
+        const swim_io_tx_t *head = &io->tx[i];
+        uint32_t j = i + 1;
+
+        if (io->use_gso) {
+            size_t bytes = head->len;
+            while (j < count && j - i < SWIM_IO_GSO_MAX_SEGS &&
+                   swim_io_same_peer(head, &io->tx[j]) && io->tx[j].len <= head->len &&
+                   bytes + io->tx[j].len <= SWIM_IO_GSO_MAX_BYTES) {
+                bytes += io->tx[j].len;
+                if (io->tx[j++].len < head->len) break;   // Short segment ends the run
+            }
+        }
+
+        for (uint32_t k = i; k < j; k++) {
+            iov[k].iov_base = (void*)io->tx[k].data;
+            iov[k].iov_len = io->tx[k].len;
+        }
+
+        struct msghdr *hdr = &msgs[n_msgs].msg_hdr;
+        hdr->msg_name = (void*)&head->addr;
+        hdr->msg_namelen = sizeof(head->addr);
+        hdr->msg_iov = &iov[i];
+        hdr->msg_iovlen = j - i;
+
+        if (j - i > 1) {
+            uint16_t seg_size = (uint16_t)head->len;
+            hdr->msg_control = ctrl[n_msgs].buf;
+            hdr->msg_controllen = sizeof(ctrl[n_msgs].buf);
+            struct cmsghdr *cm = CMSG_FIRSTHDR(hdr);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type = UDP_SEGMENT;
+            cm->cmsg_len = CMSG_LEN(sizeof(seg_size));
+            memcpy(CMSG_DATA(cm), &seg_size, sizeof(seg_size));
+        }
+
+        first[n_msgs] = i;
+        segs[n_msgs] = j - i;
+        n_msgs++;
+        i = j;
+    }
+
+    uint32_t sent = 0;
+    uint32_t m = 0;
+
+    while (m < n_msgs) {
+        int result = sendmmsg(io->sock, msgs + m, n_msgs - m, MSG_DONTWAIT);
+        io->tx_syscalls++;
+
+        if (result > 0) {
+            for (int k = 0; k < result; k++) {
+                sent += segs[m + k];
+            }
+            m += (uint32_t)result;
+            continue;
+        }
+
+        if (errno == EINTR) continue;
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            // Socket buffer full: the rest of the batch would fail too
+            for (; m < n_msgs; m++) io->tx_dropped += segs[m];
+            break;
+        }
+
+        if (segs[m] > 1 && (errno == EIO || errno == EINVAL)) {
+            // GSO rejected (e.g. no checksum offload): resend the rest unsegmented
+            log_warn("SWIM: UDP_SEGMENT rejected, disabling GSO");
+            io->use_gso = false;
+
+            uint32_t rest = first[m];
+            memmove(io->tx, io->tx + rest, (count - rest) * sizeof(io->tx[0]));
+            io->tx_count = count - rest;
+            return sent + swim_io_flush_mmsg(io);
+        }
+
+        // Per-destination failure (e.g. ICMP unreachable): skip that message
+        io->tx_dropped += segs[m];
+        m++;
+    }
+
+    return sent;
+}
+#endif
+
+/**
+ * Send queued datagrams
+ */
+uint32_t swim_io_flush(swim_io_t *io) {
+    if (io->tx_count == 0) return 0;
+
+    uint32_t sent = 0;
+
+#ifdef SWIM_IO_HAVE_MMSG
+    if (io->use_mmsg) {
+        sent = swim_io_flush_mmsg(io);
+        io->tx_datagrams += sent;
+    } else
+#endif
+    {
+        for (uint32_t i = 0; i < io->tx_count; i++) {
+            const swim_io_tx_t *tx = &io->tx[i];
+            if (swim_io_sendto(io, &tx->addr, tx->data, tx->len)) sent++;
+        }
+    }
+
+    io->tx_count = 0;
+    return sent;
+}
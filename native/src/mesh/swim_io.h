@@ -0,0 +1,102 @@
+/**
+ * LSDAMM - SWIM Batched Datagram I/O Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Receive and send datagrams in batches. On Linux a batch costs one
+ * recvmmsg/sendmmsg call; consecutive equal-sized datagrams to the same peer
+ * are further coalesced into one UDP_SEGMENT (GSO) send. Other platforms
+ * fall back to one recvfrom/sendto per datagram behind the same interface.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_IO_H
+#define SWIM_IO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+typedef SOCKET swim_socket_t;
+#else
+#include <netinet/in.h>
+typedef int swim_socket_t;
+#endif
+
+#define SWIM_IO_BATCH       32      // Datagrams per recv/send batch
+#define SWIM_IO_RX_SIZE     4096    // Receive buffer per datagram
+#define SWIM_IO_TX_SIZE     1400    // Copied send buffer per datagram
+
+// Received datagram
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    struct sockaddr_in from;
+} swim_io_rx_t;
+
+// Queued outgoing datagram
+typedef struct {
+    struct sockaddr_in addr;
+    const uint8_t *data;
+    uint32_t len;
+} swim_io_tx_t;
+
+// Batched I/O state (buffers preallocated once per socket)
+typedef struct {
+    swim_socket_t sock;
+    bool use_mmsg;              // recvmmsg/sendmmsg available and enabled
+    bool use_gso;               // UDP_SEGMENT available and enabled
+
+    swim_io_rx_t rx[SWIM_IO_BATCH];
+    uint8_t *rx_storage;
+
+    swim_io_tx_t tx[SWIM_IO_BATCH];
+    uint32_t tx_count;
+    uint8_t *tx_storage;
+
+    // Counters
+    uint64_t rx_syscalls;
+    uint64_t rx_datagrams;
+    uint64_t tx_syscalls;
+    uint64_t tx_datagrams;
+    uint64_t tx_dropped;
+} swim_io_t;
+
+/**
+ * Allocate buffers and detect batched I/O support for sock (non-blocking)
+ * @return 0 on success, -1 on allocation failure
+ */
+int swim_io_init(swim_io_t *io, swim_socket_t sock);
+
+/**
+ * Free buffers (queued datagrams are discarded)
+ */
+void swim_io_destroy(swim_io_t *io);
+
+/**
+ * Receive up to SWIM_IO_BATCH pending datagrams without blocking.
+ * Results are in io->rx[0..n) and stay valid until the next call.
+ * @return Number of datagrams received (0 when the socket is drained)
+ */
+uint32_t swim_io_recv(swim_io_t *io);
+
+/**
+ * Queue a copy of a datagram; flushes first if the batch is full.
+ * Datagrams larger than SWIM_IO_TX_SIZE are sent immediately.
+ */
+void swim_io_queue(swim_io_t *io, const struct sockaddr_in *addr, const uint8_t *data, size_t len);
+
+/**
+ * Queue a datagram without copying; data must stay valid until the next flush
+ */
+void swim_io_queue_ref(swim_io_t *io, const struct sockaddr_in *addr, const uint8_t *data, size_t len);
+
+/**
+ * Send all queued datagrams
+ * @return Number of datagrams handed to the kernel
+ */
+uint32_t swim_io_flush(swim_io_t *io);
+
+#endif // SWIM_IO_H
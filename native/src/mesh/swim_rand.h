@@ -0,0 +1,63 @@
+/**
+ * LSDAMM - SWIM Random Number Generator
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * xoshiro256** PRNG, one instance per context so protocol threads never
+ * share (or lock) libc's rand() state.
+ *
+ * Reference: https://prng.di.unimi.it/
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_RAND_H
+#define SWIM_RAND_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} swim_rand_t;
+
+static inline uint64_t swim_rand_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Seed generator (state expanded with splitmix64)
+ */
+static inline void swim_rand_seed(swim_rand_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * Next 64-bit value
+ */
+static inline uint64_t swim_rand_next(swim_rand_t *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = swim_rand_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = swim_rand_rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * Uniform value in [0, bound) (multiply-shift, bias negligible for protocol use)
+ */
+static inline uint32_t swim_rand_below(swim_rand_t *rng, uint32_t bound) {
+    return (uint32_t)(((swim_rand_next(rng) >> 32) * (uint64_t)bound) >> 32);
+}
+
+#endif // SWIM_RAND_H
@@ -0,0 +1,563 @@
+/**
+ * LSDAMM - SWIM Reactor Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "swim_reactor.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#define SWIM_HAVE_EPOLL 1
+#endif
+
+#define SWIM_REACTOR_EVENTS         64    // epoll events per wait
+#define SWIM_REACTOR_POLL_CAP_MS    100   // poll() loop: attach/stop noticed within this
+
+// One loop thread and the contexts it drives
+struct swim_reactor_loop {
+    swim_reactor_t *reactor;
+    uint32_t index;
+    volatile bool running;
+    uint32_t assigned;          // Attached contexts, running or not
+
+    // Running contexts and their next deadline (ms, 0 = run now)
+    swim_context_t *contexts[SWIM_REACTOR_MAX_CONTEXTS];
+    uint64_t deadlines[SWIM_REACTOR_MAX_CONTEXTS];
+    uint32_t count;
+
+    // Counters
+    uint64_t wakeups;
+    uint64_t io_wakeups;
+    uint64_t timer_wakeups;
+    uint64_t deadlines_run;
+
+#ifdef _WIN32
+    HANDLE thread;
+    DWORD thread_id;
+    CRITICAL_SECTION lock;
+#else
+    pthread_t thread;
+    pthread_mutex_t lock;       // Held by the loop except while it waits
+    int epoll_fd;               // -1 when using poll()
+    int timer_fd;
+    int wake_fd;
+#endif
+};
+
+struct swim_reactor {
+    uint32_t count;
+    bool pin;
+    struct swim_reactor_loop loops[];
+};
+
+static void swim_reactor_lock(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    EnterCriticalSection(&loop->lock);
+#else
+    pthread_mutex_lock(&loop->lock);
+#endif
+}
+
+static void swim_reactor_unlock(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    LeaveCriticalSection(&loop->lock);
+#else
+    pthread_mutex_unlock(&loop->lock);
+#endif
+}
+
+/**
+ * Whether the caller is the loop thread (a callback), which already holds the lock
+ */
+static bool swim_reactor_on_loop(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    return GetCurrentThreadId() == loop->thread_id;
+#else
+    return pthread_equal(pthread_self(), loop->thread);
+#endif
+}
+
+/**
+ * Interrupt the loop's wait
+ */
+static void swim_reactor_wake(struct swim_reactor_loop *loop) {
+#ifdef SWIM_HAVE_EPOLL
+    if (loop->wake_fd >= 0) {
+        uint64_t one = 1;
+        if (write(loop->wake_fd, &one, sizeof(one)) < 0) {
+            // Counter saturated: already readable
+        }
+    }
+#else
+    (void)loop;
+#endif
+}
+
+/**
+ * Slot of a running context, or -1 (it may have stopped since the wait)
+ */
+static int swim_reactor_find(struct swim_reactor_loop *loop, const swim_context_t *ctx) {
+    for (uint32_t i = 0; i < loop->count; i++) {
+        if (loop->contexts[i] == ctx) return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * Run every context whose deadline has passed
+ * @return Wakeup time (earliest deadline plus slack), 0 if nothing is pending
+ */
+static uint64_t swim_reactor_run_due(struct swim_reactor_loop *loop) {
+    uint64_t now = swim_transport_system_us() / 1000;
+    uint64_t earliest = UINT64_MAX;
+
+    for (uint32_t i = 0; i < loop->count; i++) {
+        swim_context_t *ctx = loop->contexts[i];
+        if (loop->deadlines[i] <= now) {
+            uint64_t deadline = swim_run_due(ctx);
+            loop->deadlines_run++;
+            // A callback may have stopped contexts; revisit this slot if so
+            if (i >= loop->count || loop->contexts[i] != ctx) {
+                i--;
+                continue;
+            }
+            loop->deadlines[i] = deadline;
+        }
+        if (loop->deadlines[i] < earliest) earliest = loop->deadlines[i];
+    }
+
+    return earliest == UINT64_MAX ? 0 : earliest + SWIM_REACTOR_SLACK_MS;
+}
+
+/**
+ * Receive on a context that reported readable, if it is still running here
+ */
+static void swim_reactor_process(struct swim_reactor_loop *loop, swim_context_t *ctx) {
+    int slot = swim_reactor_find(loop, ctx);
+    if (slot < 0) return;
+
+    swim_process(ctx);
+
+    // Handled messages may have scheduled timers; recompute its deadline
+    slot = swim_reactor_find(loop, ctx);
+    if (slot >= 0) loop->deadlines[slot] = 0;
+}
+
+#ifdef SWIM_HAVE_EPOLL
+/**
+ * Loop: one epoll set over every context's socket, one timerfd for the
+ * earliest deadline
+ */
+static void swim_reactor_run_epoll(struct swim_reactor_loop *loop) {
+    struct epoll_event events[SWIM_REACTOR_EVENTS];
+    uint64_t armed = 0;
+
+    swim_reactor_lock(loop);
+    while (loop->running) {
+        uint64_t wake_ms = swim_reactor_run_due(loop);
+
+        if (wake_ms != armed) {
+            struct itimerspec its = {0};
+            its.it_value.tv_sec = (time_t)(wake_ms / 1000);
+            its.it_value.tv_nsec = (long)(wake_ms % 1000) * 1000000L;
+            timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+            armed = wake_ms;
+        }
+
+        swim_reactor_unlock(loop);
+        int n = epoll_wait(loop->epoll_fd, events, SWIM_REACTOR_EVENTS, -1);
+        swim_reactor_lock(loop);
+
+        loop->wakeups++;
+        bool io = false;
+        for (int i = 0; i < n; i++) {
+            void *ptr = events[i].data.ptr;
+            uint64_t value;
+            if (ptr == NULL || ptr == loop) {
+                // Timer or wakeup
+                if (read(ptr ? loop->wake_fd : loop->timer_fd, &value, sizeof(value)) < 0) {
+                    // Already drained
+                }
+            } else {
+                swim_reactor_process(loop, (swim_context_t*)ptr);
+                io = true;
+            }
+        }
+        if (io) {
+            loop->io_wakeups++;
+        } else {
+            loop->timer_wakeups++;
+        }
+    }
+    swim_reactor_unlock(loop);
+}
+#endif
+
+/**
+ * Portable loop: poll() every context's socket until the earliest deadline
+ */
+static void swim_reactor_run_poll(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    WSAPOLLFD pfds[SWIM_REACTOR_MAX_CONTEXTS];
+#else
+    struct pollfd pfds[SWIM_REACTOR_MAX_CONTEXTS];
+#endif
+    swim_context_t *polled[SWIM_REACTOR_MAX_CONTEXTS];
+
+    swim_reactor_lock(loop);
+    while (loop->running) {
+        uint64_t wake_ms = swim_reactor_run_due(loop);
+
+        uint32_t count = loop->count;
+        for (uint32_t i = 0; i < count; i++) {
+            polled[i] = loop->contexts[i];
+            pfds[i].fd = polled[i]->transport->fd;
+#ifdef _WIN32
+            pfds[i].events = POLLRDNORM;
+#else
+            pfds[i].events = POLLIN;
+#endif
+            pfds[i].revents = 0;
+        }
+
+        uint64_t now = swim_transport_system_us() / 1000;
+        uint64_t wait_ms = wake_ms > now ? wake_ms - now : (wake_ms ? 0 : SWIM_REACTOR_POLL_CAP_MS);
+        if (wait_ms > SWIM_REACTOR_POLL_CAP_MS) wait_ms = SWIM_REACTOR_POLL_CAP_MS;
+
+        swim_reactor_unlock(loop);
+#ifdef _WIN32
+        int ready = 0;
+        if (count) {
+            ready = WSAPoll(pfds, count, (INT)wait_ms);
+        } else {
+            Sleep((DWORD)wait_ms);
+        }
+#else
+        int ready = poll(pfds, count, (int)wait_ms);
+#endif
+        swim_reactor_lock(loop);
+
+        loop->wakeups++;
+        if (ready > 0) {
+            loop->io_wakeups++;
+            for (uint32_t i = 0; i < count; i++) {
+                if (pfds[i].revents) swim_reactor_process(loop, polled[i]);
+            }
+        } else {
+            loop->timer_wakeups++;
+        }
+    }
+    swim_reactor_unlock(loop);
+}
+
+/**
+ * Loop thread function
+ */
+#ifdef _WIN32
+static DWORD WINAPI swim_reactor_thread(LPVOID arg) {
+#else
+static void* swim_reactor_thread(void *arg) {
+#endif
+    struct swim_reactor_loop *loop = (struct swim_reactor_loop*)arg;
+
+#ifdef SWIM_HAVE_EPOLL
+    if (loop->epoll_fd >= 0) {
+        swim_reactor_run_epoll(loop);
+        return 0;
+    }
+#endif
+    swim_reactor_run_poll(loop);
+
+    return 0;
+}
+
+#ifdef SWIM_HAVE_EPOLL
+/**
+ * Create the loop's epoll set, deadline timerfd and wakeup eventfd
+ * @return 0 on success, -1 (all closed) to fall back to poll()
+ */
+static int swim_reactor_open(struct swim_reactor_loop *loop) {
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    bool ok = loop->epoll_fd >= 0 && loop->timer_fd >= 0 && loop->wake_fd >= 0;
+    int fds[2] = { loop->timer_fd, loop->wake_fd };
+    void *tags[2] = { NULL, loop };
+
+    for (int i = 0; ok && i < 2; i++) {
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.ptr = tags[i];
+        ok = epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fds[i], &ev) == 0;
+    }
+
+    if (!ok) {
+        log_warn("SWIM: Reactor epoll setup failed (%s), using poll()", strerror(errno));
+        if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+        if (loop->timer_fd >= 0) close(loop->timer_fd);
+        if (loop->wake_fd >= 0) close(loop->wake_fd);
+        loop->epoll_fd = loop->timer_fd = loop->wake_fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+/**
+ * Pin a loop thread to one CPU
+ */
+static void swim_reactor_pin(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    DWORD cpus = info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+    SetThreadAffinityMask(loop->thread, (DWORD_PTR)1 << (loop->index % cpus % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(loop->index % (uint32_t)(cpus > 0 ? cpus : 1)), &set);
+    if (pthread_setaffinity_np(loop->thread, sizeof(set), &set) != 0) {
+        log_warn("SWIM: Failed to pin reactor loop %u", loop->index);
+    }
+#else
+    (void)loop;
+#endif
+}
+
+/**
+ * Stop a loop thread and release its descriptors
+ */
+static void swim_reactor_stop_loop(struct swim_reactor_loop *loop) {
+    loop->running = false;
+    swim_reactor_wake(loop);
+#ifdef _WIN32
+    WaitForSingleObject(loop->thread, INFINITE);
+    CloseHandle(loop->thread);
+#else
+    pthread_join(loop->thread, NULL);
+#endif
+}
+
+/**
+ * Free loop resources (thread already stopped or never started)
+ */
+static void swim_reactor_close_loop(struct swim_reactor_loop *loop) {
+#ifdef _WIN32
+    DeleteCriticalSection(&loop->lock);
+#else
+    if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+    if (loop->timer_fd >= 0) close(loop->timer_fd);
+    if (loop->wake_fd >= 0) close(loop->wake_fd);
+    pthread_mutex_destroy(&loop->lock);
+#endif
+}
+
+/**
+ * Create reactor
+ */
+swim_reactor_t* swim_reactor_create(uint32_t threads, bool pin) {
+    if (threads == 0) threads = 1;
+    if (threads > SWIM_REACTOR_MAX_THREADS) threads = SWIM_REACTOR_MAX_THREADS;
+
+    swim_reactor_t *reactor = (swim_reactor_t*)calloc(1, sizeof(swim_reactor_t) +
+                                                      threads * sizeof(struct swim_reactor_loop));
+    if (!reactor) return NULL;
+    reactor->pin = pin;
+
+    for (uint32_t i = 0; i < threads; i++) {
+        struct swim_reactor_loop *loop = &reactor->loops[i];
+        loop->reactor = reactor;
+        loop->index = i;
+        loop->running = true;
+#ifdef _WIN32
+        InitializeCriticalSection(&loop->lock);
+        loop->thread = CreateThread(NULL, 0, swim_reactor_thread, loop, 0, &loop->thread_id);
+        bool started = loop->thread != NULL;
+#else
+        pthread_mutex_init(&loop->lock, NULL);
+        loop->epoll_fd = loop->timer_fd = loop->wake_fd = -1;
+#ifdef SWIM_HAVE_EPOLL
+        swim_reactor_open(loop);
+#endif
+        bool started = pthread_create(&loop->thread, NULL, swim_reactor_thread, loop) == 0;
+#endif
+        if (!started) {
+            log_error("SWIM: Failed to start reactor loop %u", i);
+            swim_reactor_close_loop(loop);
+            reactor->count = i;
+            swim_reactor_destroy(reactor);
+            return NULL;
+        }
+        reactor->count = i + 1;
+        if (pin) swim_reactor_pin(loop);
+    }
+
+    log_info("SWIM: Reactor started with %u loop%s%s", threads, threads == 1 ? "" : "s",
+             pin ? " (pinned)" : "");
+    return reactor;
+}
+
+/**
+ * Destroy reactor
+ */
+void swim_reactor_destroy(swim_reactor_t *reactor) {
+    if (!reactor) return;
+
+    for (uint32_t i = 0; i < reactor->count; i++) {
+        struct swim_reactor_loop *loop = &reactor->loops[i];
+        if (loop->assigned) {
+            log_error("SWIM: Destroying reactor loop %u with %u attached contexts", i, loop->assigned);
+        }
+        swim_reactor_stop_loop(loop);
+        swim_reactor_close_loop(loop);
+    }
+
+    free(reactor);
+}
+
+/**
+ * Attach context to the least loaded loop
+ */
+int swim_reactor_attach(swim_reactor_t *reactor, swim_context_t *ctx) {
+    if (!reactor || !ctx || ctx->reactor) return -1;
+    if (ctx->has_thread || ctx->transport->fd == SWIM_TRANSPORT_NO_FD) {
+        log_error("SWIM: Attach %s to a reactor before swim_start (and with a socket)", ctx->local_id);
+        return -1;
+    }
+
+    struct swim_reactor_loop *loop = &reactor->loops[0];
+    for (uint32_t i = 1; i < reactor->count; i++) {
+        if (reactor->loops[i].assigned < loop->assigned) loop = &reactor->loops[i];
+    }
+
+    swim_reactor_lock(loop);
+    loop->assigned++;
+    ctx->reactor = loop;
+    swim_reactor_unlock(loop);
+
+    // Owner-driven until now; the loop takes over
+    if (ctx->is_running) swim_reactor_add(ctx);
+    return 0;
+}
+
+/**
+ * Detach context
+ */
+void swim_reactor_detach(swim_context_t *ctx) {
+    struct swim_reactor_loop *loop = ctx->reactor;
+    if (!loop) return;
+
+    swim_reactor_remove(ctx);
+
+    bool on_loop = swim_reactor_on_loop(loop);
+    if (!on_loop) swim_reactor_lock(loop);
+    loop->assigned--;
+    ctx->reactor = NULL;
+    if (!on_loop) swim_reactor_unlock(loop);
+}
+
+/**
+ * Start driving an attached context
+ */
+void swim_reactor_add(swim_context_t *ctx) {
+    struct swim_reactor_loop *loop = ctx->reactor;
+    if (!loop) return;
+
+    bool on_loop = swim_reactor_on_loop(loop);
+    if (!on_loop) swim_reactor_lock(loop);
+
+    if (swim_reactor_find(loop, ctx) < 0) {
+        if (loop->count == SWIM_REACTOR_MAX_CONTEXTS) {
+            log_error("SWIM: Reactor loop %u full, %s not driven", loop->index, ctx->local_id);
+        } else {
+#ifdef SWIM_HAVE_EPOLL
+            if (loop->epoll_fd >= 0) {
+                struct epoll_event ev = {0};
+                ev.events = EPOLLIN;
+                ev.data.ptr = ctx;
+                if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, ctx->transport->fd, &ev) != 0) {
+                    log_error("SWIM: Failed to watch %s (%s)", ctx->local_id, strerror(errno));
+                }
+            }
+#endif
+            loop->contexts[loop->count] = ctx;
+            loop->deadlines[loop->count] = 0;
+            loop->count++;
+        }
+    }
+
+    if (!on_loop) {
+        swim_reactor_unlock(loop);
+        swim_reactor_wake(loop);
+    }
+}
+
+/**
+ * Stop driving an attached context
+ */
+void swim_reactor_remove(swim_context_t *ctx) {
+    struct swim_reactor_loop *loop = ctx->reactor;
+    if (!loop) return;
+
+    // Taking the lock waits out any pass that is using the context
+    bool on_loop = swim_reactor_on_loop(loop);
+    if (!on_loop) swim_reactor_lock(loop);
+
+    int slot = swim_reactor_find(loop, ctx);
+    if (slot >= 0) {
+#ifdef SWIM_HAVE_EPOLL
+        if (loop->epoll_fd >= 0) {
+            epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, ctx->transport->fd, NULL);
+        }
+#endif
+        loop->count--;
+        loop->contexts[slot] = loop->contexts[loop->count];
+        loop->deadlines[slot] = loop->deadlines[loop->count];
+    }
+
+    if (!on_loop) swim_reactor_unlock(loop);
+}
+
+/**
+ * Get counters
+ */
+void swim_reactor_get_stats(swim_reactor_t *reactor, swim_reactor_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = reactor->count;
+
+    for (uint32_t i = 0; i < reactor->count; i++) {
+        struct swim_reactor_loop *loop = &reactor->loops[i];
+        swim_reactor_lock(loop);
+        stats->contexts += loop->assigned;
+        stats->wakeups += loop->wakeups;
+        stats->io_wakeups += loop->io_wakeups;
+        stats->timer_wakeups += loop->timer_wakeups;
+        stats->deadlines_run += loop->deadlines_run;
+        swim_reactor_unlock(loop);
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * LSDAMM - SWIM Reactor Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Shared event loops for many SWIM contexts in one process. Instead of a
+ * protocol thread per context, a reactor runs a fixed number of loop
+ * threads (optionally pinned to cores); each attached context is assigned
+ * to exactly one loop, which owns its socket and its protocol deadlines.
+ *
+ * Deadlines of a loop's contexts that fall within SWIM_REACTOR_SLACK_MS of
+ * each other share one timer wakeup. Contexts with the same protocol period
+ * then stay in step, so an idle loop wakes about once per period rather
+ * than once per context per period.
+ *
+ * Attach a context before swim_start; swim_start and swim_stop then add it
+ * to and remove it from its loop, and swim_destroy detaches it. Node and
+ * message callbacks run on the loop thread.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_REACTOR_H
+#define SWIM_REACTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swim_gossip.h"
+
+#define SWIM_REACTOR_MAX_THREADS    64
+#define SWIM_REACTOR_MAX_CONTEXTS   256   // Running contexts per loop
+#define SWIM_REACTOR_SLACK_MS       4     // Deadlines this close share one wakeup
+
+typedef struct swim_reactor swim_reactor_t;
+
+// Reactor counters (all loops)
+typedef struct {
+    uint32_t threads;
+    uint32_t contexts;          // Attached
+    uint64_t wakeups;           // Returns from epoll_wait / poll
+    uint64_t io_wakeups;        // ... with datagrams to process
+    uint64_t timer_wakeups;     // ... for protocol deadlines only
+    uint64_t deadlines_run;     // swim_run_due calls
+} swim_reactor_stats_t;
+
+/**
+ * Start loop threads
+ * @param threads Number of loops (0 for one)
+ * @param pin Pin loop i to CPU i (modulo the CPU count)
+ * @return Reactor, or NULL on failure
+ */
+swim_reactor_t* swim_reactor_create(uint32_t threads, bool pin);
+
+/**
+ * Stop loop threads; every context must already be detached
+ */
+void swim_reactor_destroy(swim_reactor_t *reactor);
+
+/**
+ * Assign a context to the least loaded loop
+ * @return 0 on success, -1 if it already runs its own thread or has no descriptor
+ */
+int swim_reactor_attach(swim_reactor_t *reactor, swim_context_t *ctx);
+
+/**
+ * Release a context from its loop (no-op if not attached)
+ */
+void swim_reactor_detach(swim_context_t *ctx);
+
+/**
+ * Get counters
+ */
+void swim_reactor_get_stats(swim_reactor_t *reactor, swim_reactor_stats_t *stats);
+
+/**
+ * Start / stop driving an attached context (called by swim_start and
+ * swim_stop). Once swim_reactor_remove returns, the loop no longer
+ * touches the context.
+ */
+void swim_reactor_add(swim_context_t *ctx);
+void swim_reactor_remove(swim_context_t *ctx);
+
+#endif // SWIM_REACTOR_H
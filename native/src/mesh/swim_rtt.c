@@ -0,0 +1,69 @@
+/**
+ * LSDAMM - SWIM Round-Trip Time Estimator Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_rtt.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Add sample (RFC 6298 section 2, alpha = 1/8, beta = 1/4)
+ */
+void swim_rtt_sample(swim_rtt_t *rtt, uint64_t rtt_us) {
+    double r = (double)rtt_us;
+
+    if (rtt->samples == 0) {
+        rtt->srtt_us = r;
+        rtt->rttvar_us = r / 2.0;
+    } else {
+        double err = rtt->srtt_us > r ? rtt->srtt_us - r : r - rtt->srtt_us;
+        rtt->rttvar_us = 0.75 * rtt->rttvar_us + 0.25 * err;
+        rtt->srtt_us = 0.875 * rtt->srtt_us + 0.125 * r;
+    }
+
+    rtt->window_us[rtt->window_next] = rtt_us > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt_us;
+    rtt->window_next = (uint8_t)((rtt->window_next + 1) % SWIM_RTT_WINDOW);
+    rtt->samples++;
+}
+
+/**
+ * Adaptive probe timeout
+ */
+uint32_t swim_rtt_timeout_ms(const swim_rtt_t *rtt, uint32_t base_ms) {
+    if (rtt->samples < SWIM_RTT_MIN_SAMPLES) return base_ms;
+
+    double timeout = (rtt->srtt_us + 4.0 * rtt->rttvar_us) / 1000.0;
+    double max_ms = (double)base_ms * SWIM_RTT_MAX_MULT;
+
+    if (timeout < SWIM_RTT_MIN_TIMEOUT_MS) timeout = SWIM_RTT_MIN_TIMEOUT_MS;
+    if (timeout > max_ms) timeout = max_ms;
+    return (uint32_t)(timeout + 0.5);
+}
+
+static int swim_rtt_compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Nearest-rank percentile over the window
+ */
+uint32_t swim_rtt_percentile_us(const swim_rtt_t *rtt, double pct) {
+    uint32_t count = rtt->samples < SWIM_RTT_WINDOW ? rtt->samples : SWIM_RTT_WINDOW;
+    if (count == 0) return 0;
+
+    uint32_t sorted[SWIM_RTT_WINDOW];
+    memcpy(sorted, rtt->window_us, count * sizeof(uint32_t));
+    qsort(sorted, count, sizeof(uint32_t), swim_rtt_compare);
+
+    if (pct <= 0) return sorted[0];
+    if (pct >= 100) return sorted[count - 1];
+
+    // Smallest sample with at least pct% of the window at or below it
+    uint32_t rank = (uint32_t)(pct / 100.0 * count + 0.999999);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
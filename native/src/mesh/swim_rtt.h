@@ -0,0 +1,54 @@
+/**
+ * LSDAMM - SWIM Round-Trip Time Estimator Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Per-member PING -> ACK round-trip tracking. A smoothed RTT and its mean
+ * deviation give each member its own probe timeout (srtt + 4 * rttvar, as
+ * for the TCP retransmission timer), so same-rack members are probed with
+ * a tight deadline and distant ones are not suspected for being far away.
+ * A window of recent samples backs the percentile queries.
+ *
+ * Reference: RFC 6298, "Computing TCP's Retransmission Timer"
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_RTT_H
+#define SWIM_RTT_H
+
+#include <stdint.h>
+
+#define SWIM_RTT_WINDOW         32    // Samples kept for percentiles
+#define SWIM_RTT_MIN_SAMPLES    3     // Below this, use the configured timeout
+#define SWIM_RTT_MIN_TIMEOUT_MS 10    // Floor for adaptive probe timeouts
+#define SWIM_RTT_MAX_MULT       4     // Ceiling, in multiples of the configured timeout
+
+// Per-member estimator (embedded in swim_node_t)
+typedef struct {
+    double srtt_us;                     // Smoothed RTT
+    double rttvar_us;                   // Smoothed mean deviation
+    uint32_t samples;                   // Total samples seen
+    uint32_t window_us[SWIM_RTT_WINDOW];    // Most recent samples
+    uint8_t window_next;
+} swim_rtt_t;
+
+/**
+ * Add a PING -> ACK round trip
+ */
+void swim_rtt_sample(swim_rtt_t *rtt, uint64_t rtt_us);
+
+/**
+ * Probe timeout for the member: srtt + 4 * rttvar, clamped to
+ * [SWIM_RTT_MIN_TIMEOUT_MS, SWIM_RTT_MAX_MULT * base_ms]; base_ms until
+ * SWIM_RTT_MIN_SAMPLES round trips have been seen
+ */
+uint32_t swim_rtt_timeout_ms(const swim_rtt_t *rtt, uint32_t base_ms);
+
+/**
+ * RTT percentile over the sample window
+ * @param pct Percentile, 0-100
+ * @return Microseconds, 0 without samples
+ */
+uint32_t swim_rtt_percentile_us(const swim_rtt_t *rtt, double pct);
+
+#endif // SWIM_RTT_H
@@ -0,0 +1,506 @@
+/**
+ * LSDAMM - SWIM Shared-Memory Transport Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "swim_shm.h"
+#include "swim_epoch.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#define SWIM_SHM_SUPPORTED
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#ifdef SWIM_SHM_SUPPORTED
+
+#define SWIM_SHM_RING_MASK      ((uint64_t)SWIM_SHM_RING_BYTES - 1)
+#define SWIM_SHM_RECORD_HEADER  8
+#define SWIM_SHM_ALIGN(n)       (((n) + 7) & ~(uint64_t)7)
+
+// Record header in a ring; len 0 pads to the end of the ring
+typedef struct {
+    uint32_t len;
+    uint16_t port;              // Sender's port
+    uint16_t to_port;           // Receiver's port (the slot may have been reused since)
+} swim_shm_record_t;
+
+// SPSC byte ring; positions are free-running byte counts
+typedef struct {
+    swim_atomic_u64 tail;       // Published by the producer
+    uint8_t pad0[56];
+    swim_atomic_u64 head;       // Released by the consumer
+    uint8_t pad1[56];
+    uint8_t data[SWIM_SHM_RING_BYTES];
+} swim_shm_ring_t;
+
+// Receiving side of a hub slot
+typedef struct {
+    swim_atomic_u64 port;       // 0 while the slot is free
+    swim_atomic_u64 armed;      // Receiver drained its rings; next publisher wakes it
+    swim_atomic_u64 woken;      // wake_fd written since the receiver last drained it
+    swim_atomic_u64 rings[SWIM_SHM_MAX_ENDPOINTS]; // Inbound ring per sender slot (pointer)
+    int wake_fd;                // eventfd, kept open for the hub's lifetime
+} swim_shm_endpoint_t;
+
+struct swim_shm_hub {
+    pthread_mutex_t lock;       // Registration only
+    uint32_t open;
+    swim_shm_endpoint_t endpoints[SWIM_SHM_MAX_ENDPOINTS];
+};
+
+// Per-context transport
+typedef struct {
+    swim_transport_t base;
+    swim_transport_t *udp;      // Remote peers and ring overflow
+    swim_shm_hub_t *hub;
+    uint32_t slot;
+    uint16_t port;
+
+    // Producer state, by receiver slot
+    uint64_t tx_tail[SWIM_SHM_MAX_ENDPOINTS];   // Written, published on flush
+    uint32_t tx_open;           // tx_tail initialized from the ring
+    uint32_t tx_dirty;          // Unpublished writes
+
+    // Consumer state, by sender slot
+    uint64_t rx_read[SWIM_SHM_MAX_ENDPOINTS];   // Handed out, released on the next recv
+    uint32_t rx_open;           // rx_read initialized from the ring
+    uint32_t rx_held;           // Records handed out but not released
+    uint32_t rx_start;          // Round-robin start slot
+    swim_io_rx_t rx[SWIM_IO_BATCH];
+
+    uint64_t wake_writes;       // Wake syscalls, added to the UDP transport's counts
+    uint64_t wake_reads;        // Wakeup eventfd reads, added likewise
+    swim_shm_stats_t stats;
+} swim_shm_transport_t;
+
+static inline swim_shm_ring_t* swim_shm_ring(swim_shm_endpoint_t *ep, uint32_t from) {
+    return (swim_shm_ring_t*)(uintptr_t)swim_atomic_load(&ep->rings[from]);
+}
+
+/**
+ * Hub slot of a registered local port
+ * @return Slot, or -1 if to is not a hub member on loopback
+ */
+static int swim_shm_lookup(swim_shm_hub_t *hub, const struct sockaddr_in *to) {
+    if ((ntohl(to->sin_addr.s_addr) >> 24) != 127) return -1;
+
+    uint64_t port = ntohs(to->sin_port);
+    for (int i = 0; i < SWIM_SHM_MAX_ENDPOINTS; i++) {
+        if (swim_atomic_load(&hub->endpoints[i].port) == port) return i;
+    }
+    return -1;
+}
+
+/**
+ * Mirror UDP counters (plus wake syscalls) into the transport
+ */
+static void swim_shm_sync_counters(swim_shm_transport_t *shm) {
+    shm->base.rx_calls = shm->udp->rx_calls + shm->wake_reads;
+    shm->base.rx_datagrams = shm->udp->rx_datagrams + shm->stats.local_rx;
+    shm->base.tx_calls = shm->udp->tx_calls + shm->wake_writes;
+    shm->base.tx_datagrams = shm->udp->tx_datagrams + shm->stats.local_tx;
+    shm->base.tx_dropped = shm->udp->tx_dropped;
+}
+
+/**
+ * Append one datagram to the ring towards slot dst (unpublished until flush)
+ * @return 0 on success, -1 if the ring has no room
+ */
+static int swim_shm_push(swim_shm_transport_t *shm, uint32_t dst, uint16_t to_port,
+                         const uint8_t *data, size_t len) {
+    swim_shm_endpoint_t *ep = &shm->hub->endpoints[dst];
+    swim_shm_ring_t *ring = swim_shm_ring(ep, shm->slot);
+
+    if (!ring) {
+        // Only this sender ever creates or writes this ring
+        ring = (swim_shm_ring_t*)calloc(1, sizeof(swim_shm_ring_t));
+        if (!ring) return -1;
+        swim_atomic_store(&ep->rings[shm->slot], (uint64_t)(uintptr_t)ring);
+    }
+
+    uint32_t bit = 1u << dst;
+    if (!(shm->tx_open & bit)) {
+        shm->tx_tail[dst] = swim_atomic_load(&ring->tail);
+        shm->tx_open |= bit;
+    }
+
+    uint64_t tail = shm->tx_tail[dst];
+    uint64_t head = swim_atomic_load(&ring->head);
+    uint64_t need = SWIM_SHM_ALIGN(SWIM_SHM_RECORD_HEADER + len);
+    uint64_t contiguous = SWIM_SHM_RING_BYTES - (tail & SWIM_SHM_RING_MASK);
+    uint64_t pad = need > contiguous ? contiguous : 0;
+
+    if (tail + pad + need - head > SWIM_SHM_RING_BYTES) return -1;
+
+    if (pad) {
+        swim_shm_record_t marker = {0, 0, 0};
+        memcpy(&ring->data[tail & SWIM_SHM_RING_MASK], &marker, sizeof(marker));
+        tail += pad;
+    }
+
+    swim_shm_record_t record = {(uint32_t)len, shm->port, to_port};
+    uint8_t *at = &ring->data[tail & SWIM_SHM_RING_MASK];
+    memcpy(at, &record, sizeof(record));
+    memcpy(at + SWIM_SHM_RECORD_HEADER, data, len);
+
+    shm->tx_tail[dst] = tail + need;
+    shm->tx_dirty |= bit;
+    return 0;
+}
+
+static void swim_shm_send(swim_transport_t *t, const struct sockaddr_in *to, const uint8_t *data,
+                          size_t len, bool copy) {
+    swim_shm_transport_t *shm = (swim_shm_transport_t*)t;
+    int dst = len <= SWIM_IO_TX_SIZE ? swim_shm_lookup(shm->hub, to) : -1;
+
+    t->tx_bytes += len;
+    if (dst >= 0 && swim_shm_push(shm, (uint32_t)dst, ntohs(to->sin_port), data, len) == 0) {
+        shm->stats.local_tx++;
+    } else {
+        if (dst >= 0) {
+            shm->stats.ring_full++;
+        } else {
+            shm->stats.remote_tx++;
+        }
+        shm->udp->ops->send(shm->udp, to, data, len, copy);
+    }
+    swim_shm_sync_counters(shm);
+}
+
+/**
+ * Publish ring writes, wake receivers that may be asleep, flush UDP
+ */
+static void swim_shm_flush(swim_transport_t *t) {
+    swim_shm_transport_t *shm = (swim_shm_transport_t*)t;
+
+    while (shm->tx_dirty) {
+        uint32_t dst = (uint32_t)__builtin_ctz(shm->tx_dirty);
+        shm->tx_dirty &= shm->tx_dirty - 1;
+
+        swim_shm_endpoint_t *ep = &shm->hub->endpoints[dst];
+        swim_atomic_store(&swim_shm_ring(ep, shm->slot)->tail, shm->tx_tail[dst]);
+
+        // Pairs with the receiver's arm-then-recheck in swim_shm_recv
+        if (swim_atomic_exchange(&ep->armed, 0)) {
+            uint64_t one = 1;
+            if (write(ep->wake_fd, &one, sizeof(one)) < 0) {
+                // Counter saturated: already readable
+            }
+            swim_atomic_store(&ep->woken, 1);
+            shm->wake_writes++;
+            shm->stats.wakeups++;
+        }
+    }
+
+    swim_transport_flush(shm->udp);
+    swim_shm_sync_counters(shm);
+}
+
+/**
+ * Hand out records from the inbound rings, round-robin across senders
+ * @return Datagrams added to shm->rx (from index count)
+ */
+static uint32_t swim_shm_drain(swim_shm_transport_t *shm, uint32_t count) {
+    swim_shm_endpoint_t *ep = &shm->hub->endpoints[shm->slot];
+    uint32_t start = shm->rx_start++ % SWIM_SHM_MAX_ENDPOINTS;
+
+    for (uint32_t n = 0; n < SWIM_SHM_MAX_ENDPOINTS && count < SWIM_IO_BATCH; n++) {
+        uint32_t from = (start + n) % SWIM_SHM_MAX_ENDPOINTS;
+        swim_shm_ring_t *ring = swim_shm_ring(ep, from);
+        if (!ring) continue;
+
+        uint32_t bit = 1u << from;
+        if (!(shm->rx_open & bit)) {
+            shm->rx_read[from] = swim_atomic_load(&ring->head);
+            shm->rx_open |= bit;
+        }
+
+        uint64_t read = shm->rx_read[from];
+        uint64_t tail = swim_atomic_load(&ring->tail);
+
+        while (read != tail && count < SWIM_IO_BATCH) {
+            uint8_t *at = &ring->data[read & SWIM_SHM_RING_MASK];
+            swim_shm_record_t record;
+            memcpy(&record, at, sizeof(record));
+
+            if (record.len == 0) {
+                read += SWIM_SHM_RING_BYTES - (read & SWIM_SHM_RING_MASK);
+                continue;
+            }
+
+            uint64_t next = read + SWIM_SHM_ALIGN(SWIM_SHM_RECORD_HEADER + record.len);
+            if (record.to_port != shm->port) {
+                read = next;
+                continue;
+            }
+
+            swim_io_rx_t *rx = &shm->rx[count++];
+            rx->data = at + SWIM_SHM_RECORD_HEADER;
+            rx->len = record.len;
+            memset(&rx->from, 0, sizeof(rx->from));
+            rx->from.sin_family = AF_INET;
+            rx->from.sin_port = htons(record.port);
+            rx->from.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            read = next;
+        }
+
+        if (read != shm->rx_read[from]) {
+            shm->rx_read[from] = read;
+            shm->rx_held |= bit;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Whether any inbound ring has unread records
+ */
+static bool swim_shm_pending(swim_shm_transport_t *shm) {
+    swim_shm_endpoint_t *ep = &shm->hub->endpoints[shm->slot];
+
+    for (uint32_t from = 0; from < SWIM_SHM_MAX_ENDPOINTS; from++) {
+        swim_shm_ring_t *ring = swim_shm_ring(ep, from);
+        if (!ring) continue;
+
+        uint64_t read = (shm->rx_open & (1u << from)) ? shm->rx_read[from] : swim_atomic_load(&ring->head);
+        if (swim_atomic_load(&ring->tail) != read) return true;
+    }
+    return false;
+}
+
+/**
+ * Release the previous batch, then receive from the rings; UDP is read
+ * once the rings are empty (the epoll set stays readable while it has data)
+ */
+static uint32_t swim_shm_recv(swim_transport_t *t, const swim_io_rx_t **rx) {
+    swim_shm_transport_t *shm = (swim_shm_transport_t*)t;
+    swim_shm_endpoint_t *ep = &shm->hub->endpoints[shm->slot];
+
+    while (shm->rx_held) {
+        uint32_t from = (uint32_t)__builtin_ctz(shm->rx_held);
+        shm->rx_held &= shm->rx_held - 1;
+        swim_atomic_store(&swim_shm_ring(ep, from)->head, shm->rx_read[from]);
+    }
+
+    uint32_t count = swim_shm_drain(shm, 0);
+
+    if (count < SWIM_IO_BATCH) {
+        // Rings looked empty: clear a pending wakeup, arm, and look again so
+        // a record published before the arm is not left behind
+        if (swim_atomic_exchange(&ep->woken, 0)) {
+            uint64_t value;
+            if (read(ep->wake_fd, &value, sizeof(value)) < 0) {
+                // Already drained
+            }
+            shm->wake_reads++;
+        }
+        swim_atomic_store(&ep->armed, 1);
+        if (swim_shm_pending(shm)) {
+            count = swim_shm_drain(shm, count);
+        }
+    }
+
+    shm->stats.local_rx += count;
+    if (count > 0) {
+        swim_shm_sync_counters(shm);
+        *rx = shm->rx;
+        return count;
+    }
+
+    count = swim_transport_recv(shm->udp, rx);
+    swim_shm_sync_counters(shm);
+    return count;
+}
+
+static uint64_t swim_shm_now_us(swim_transport_t *t) {
+    (void)t;
+    return swim_transport_system_us();
+}
+
+/**
+ * Unregister from the hub (unread ring records are dropped) and close
+ */
+static void swim_shm_close(swim_transport_t *t) {
+    swim_shm_transport_t *shm = (swim_shm_transport_t*)t;
+    swim_shm_hub_t *hub = shm->hub;
+
+    pthread_mutex_lock(&hub->lock);
+    swim_atomic_store(&hub->endpoints[shm->slot].port, 0);
+    hub->open--;
+    pthread_mutex_unlock(&hub->lock);
+
+    close(t->fd);
+    swim_transport_close(shm->udp);
+    free(shm);
+}
+
+static const swim_transport_ops_t swim_shm_ops = {
+    "shm",
+    swim_shm_send,
+    swim_shm_flush,
+    swim_shm_recv,
+    swim_shm_now_us,
+    swim_shm_close
+};
+
+/**
+ * Create hub
+ */
+swim_shm_hub_t* swim_shm_hub_create(void) {
+    swim_shm_hub_t *hub = (swim_shm_hub_t*)calloc(1, sizeof(swim_shm_hub_t));
+    if (!hub) return NULL;
+
+    for (int i = 0; i < SWIM_SHM_MAX_ENDPOINTS; i++) {
+        hub->endpoints[i].wake_fd = -1;
+    }
+    pthread_mutex_init(&hub->lock, NULL);
+    return hub;
+}
+
+/**
+ * Destroy hub
+ */
+void swim_shm_hub_destroy(swim_shm_hub_t *hub) {
+    if (!hub) return;
+
+    if (hub->open) {
+        log_error("SWIM: Destroying shared-memory hub with %u open transports", hub->open);
+    }
+
+    for (int i = 0; i < SWIM_SHM_MAX_ENDPOINTS; i++) {
+        swim_shm_endpoint_t *ep = &hub->endpoints[i];
+        for (int j = 0; j < SWIM_SHM_MAX_ENDPOINTS; j++) {
+            free(swim_shm_ring(ep, (uint32_t)j));
+        }
+        if (ep->wake_fd >= 0) close(ep->wake_fd);
+    }
+
+    pthread_mutex_destroy(&hub->lock);
+    free(hub);
+}
+
+/**
+ * Open shared-memory transport
+ */
+swim_transport_t* swim_transport_shm(swim_shm_hub_t *hub, uint16_t port) {
+    if (!hub) return swim_transport_udp(port);
+
+    swim_shm_transport_t *shm = (swim_shm_transport_t*)calloc(1, sizeof(swim_shm_transport_t));
+    if (!shm) return NULL;
+    shm->base.ops = &swim_shm_ops;
+    shm->hub = hub;
+    shm->port = port;
+
+    // The UDP socket owns the port, so a second registration fails here
+    shm->udp = swim_transport_udp(port);
+    if (!shm->udp) {
+        free(shm);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&hub->lock);
+
+    int slot = -1;
+    for (int i = 0; i < SWIM_SHM_MAX_ENDPOINTS && slot < 0; i++) {
+        if (swim_atomic_load(&hub->endpoints[i].port) == 0) slot = i;
+    }
+
+    swim_shm_endpoint_t *ep = slot >= 0 ? &hub->endpoints[slot] : NULL;
+    if (ep && ep->wake_fd < 0) {
+        ep->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+
+    // Readable when either the socket or the wakeup eventfd is
+    shm->base.fd = epoll_create1(EPOLL_CLOEXEC);
+    bool ok = ep && ep->wake_fd >= 0 && shm->base.fd >= 0;
+    int fds[2] = { shm->udp->fd, ok ? ep->wake_fd : -1 };
+    for (int i = 0; ok && i < 2; i++) {
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.fd = fds[i];
+        ok = epoll_ctl(shm->base.fd, EPOLL_CTL_ADD, fds[i], &ev) == 0;
+    }
+
+    if (!ok) {
+        pthread_mutex_unlock(&hub->lock);
+        if (slot < 0) {
+            log_warn("SWIM: Shared-memory hub full, port %d uses UDP only", port);
+        } else {
+            log_warn("SWIM: Shared-memory setup failed (%s), port %d uses UDP only", strerror(errno), port);
+        }
+        if (shm->base.fd >= 0) close(shm->base.fd);
+        swim_transport_t *udp = shm->udp;
+        free(shm);
+        return udp;
+    }
+
+    // Records left by a previous context on this slot are dropped
+    for (uint32_t from = 0; from < SWIM_SHM_MAX_ENDPOINTS; from++) {
+        swim_shm_ring_t *ring = swim_shm_ring(ep, from);
+        if (ring) swim_atomic_store(&ring->head, swim_atomic_load(&ring->tail));
+    }
+    uint64_t value;
+    if (read(ep->wake_fd, &value, sizeof(value)) < 0) {
+        // Nothing pending
+    }
+    swim_atomic_store(&ep->woken, 0);
+    swim_atomic_store(&ep->armed, 1);
+
+    shm->slot = (uint32_t)slot;
+    swim_atomic_store(&ep->port, port);
+    hub->open++;
+    pthread_mutex_unlock(&hub->lock);
+
+    return &shm->base;
+}
+
+/**
+ * Get shared-memory counters
+ */
+bool swim_transport_shm_stats(const swim_transport_t *t, swim_shm_stats_t *stats) {
+    if (!t || t->ops != &swim_shm_ops) return false;
+    *stats = ((const swim_shm_transport_t*)t)->stats;
+    return true;
+}
+
+#else // !SWIM_SHM_SUPPORTED
+
+struct swim_shm_hub {
+    int unused;
+};
+
+swim_shm_hub_t* swim_shm_hub_create(void) {
+    return (swim_shm_hub_t*)calloc(1, sizeof(swim_shm_hub_t));
+}
+
+void swim_shm_hub_destroy(swim_shm_hub_t *hub) {
+    free(hub);
+}
+
+swim_transport_t* swim_transport_shm(swim_shm_hub_t *hub, uint16_t port) {
+    (void)hub;
+    return swim_transport_udp(port);
+}
+
+bool swim_transport_shm_stats(const swim_transport_t *t, swim_shm_stats_t *stats) {
+    (void)t;
+    (void)stats;
+    return false;
+}
+
+#endif // SWIM_SHM_SUPPORTED
@@ -0,0 +1,70 @@
+/**
+ * LSDAMM - SWIM Shared-Memory Transport Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Transport for SWIM contexts hosted in the same process (node_manager).
+ * Contexts registered on one hub exchange datagrams through lock-free
+ * single-producer/single-consumer byte rings, one per (sender, receiver)
+ * pair, instead of the loopback UDP stack. Datagrams to any other address,
+ * larger than SWIM_IO_TX_SIZE, or that find their ring full go out over the
+ * context's own UDP socket as before.
+ *
+ * A datagram is copied once, into the ring, and handed to the receiver in
+ * place. A sender issues a syscall only to wake a receiver that has drained
+ * its rings and may be sleeping (one eventfd write); a busy receiver is
+ * never woken.
+ *
+ * Ring state lives in the hub, so a context may be closed and a new one
+ * registered on the same port while others keep running. Shared-memory
+ * delivery needs Linux (eventfd + epoll); elsewhere swim_transport_shm
+ * returns a plain UDP transport.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_SHM_H
+#define SWIM_SHM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swim_transport.h"
+
+#define SWIM_SHM_MAX_ENDPOINTS  32          // Contexts per hub
+#define SWIM_SHM_RING_BYTES     (32 * 1024) // Per (sender, receiver) pair, power of two
+
+typedef struct swim_shm_hub swim_shm_hub_t;
+
+// Shared-memory transport counters
+typedef struct {
+    uint64_t local_tx;          // Datagrams written to a ring
+    uint64_t local_rx;          // Datagrams read from a ring
+    uint64_t remote_tx;         // Datagrams sent over UDP (not a hub member)
+    uint64_t ring_full;         // Datagrams sent over UDP because the ring was full
+    uint64_t wakeups;           // Receivers woken (eventfd writes)
+} swim_shm_stats_t;
+
+/**
+ * Create an empty hub
+ * @return Hub, or NULL on allocation failure
+ */
+swim_shm_hub_t* swim_shm_hub_create(void);
+
+/**
+ * Destroy a hub; every transport on it must already be closed
+ */
+void swim_shm_hub_destroy(swim_shm_hub_t *hub);
+
+/**
+ * Open a UDP socket on port and register it on the hub, so loopback
+ * datagrams to other hub members skip the socket
+ * @return Transport, or NULL on failure
+ */
+swim_transport_t* swim_transport_shm(swim_shm_hub_t *hub, uint16_t port);
+
+/**
+ * Get shared-memory counters
+ * @return false if t is not a shared-memory transport
+ */
+bool swim_transport_shm_stats(const swim_transport_t *t, swim_shm_stats_t *stats);
+
+#endif // SWIM_SHM_H
@@ -0,0 +1,579 @@
+/**
+ * LSDAMM - SWIM Network Simulator Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_sim.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+#define SWIM_SIM_PORTS          65536
+#define SWIM_SIM_NOT_QUEUED     UINT32_MAX
+
+// Datagram in flight or waiting in an inbox
+typedef struct {
+    uint64_t deliver_us;
+    uint64_t seq;                   // Send order, breaks delivery-time ties
+    uint16_t from_port;
+    uint16_t to_port;
+    uint32_t len;
+    uint8_t data[];
+} swim_sim_packet_t;
+
+// Growable array of packets (FIFO from head)
+typedef struct {
+    swim_sim_packet_t **items;
+    uint32_t head;
+    uint32_t count;
+    uint32_t capacity;
+} swim_sim_queue_t;
+
+// Simulated node: the transport of one context
+typedef struct swim_sim_endpoint {
+    swim_transport_t base;
+    swim_sim_t *sim;
+    swim_context_t *ctx;
+    uint16_t port;
+    uint32_t partition;
+    bool crashed;
+    bool ready;                     // In sim->ready, inbox not yet processed
+    uint32_t index;                 // Position in sim->endpoints
+    uint32_t heap_pos;              // Position in sim->deadlines, or SWIM_SIM_NOT_QUEUED
+    uint64_t deadline_us;
+
+    swim_sim_queue_t tx;            // Sent, not yet flushed
+    swim_sim_queue_t inbox;         // Delivered, not yet received
+    swim_sim_packet_t *held[SWIM_IO_BATCH];     // Backing the last recv
+    uint32_t held_count;
+    swim_io_rx_t rx[SWIM_IO_BATCH];
+} swim_sim_endpoint_t;
+
+struct swim_sim {
+    uint64_t now_us;
+    uint64_t next_seq;
+    swim_rand_t rng;
+
+    uint32_t latency_us;
+    uint32_t jitter_us;
+    double loss;
+
+    swim_sim_endpoint_t **by_port;  // SWIM_SIM_PORTS entries
+    swim_sim_endpoint_t **endpoints;
+    uint32_t endpoint_count;
+    uint32_t endpoint_capacity;
+
+    // Min-heap of live endpoints by protocol deadline
+    swim_sim_endpoint_t **deadlines;
+    uint32_t deadline_count;
+
+    // Min-heap of datagrams in flight by (deliver_us, seq)
+    swim_sim_packet_t **packets;
+    uint32_t packet_count;
+    uint32_t packet_capacity;
+
+    // Endpoints with fresh inbox entries
+    swim_sim_endpoint_t **ready;
+    uint32_t ready_count;
+
+    swim_sim_stats_t stats;
+};
+
+/*
+ * Queues
+ */
+
+static int swim_sim_queue_push(swim_sim_queue_t *q, swim_sim_packet_t *packet) {
+    if (q->head + q->count == q->capacity) {
+        if (q->head > 0) {
+            // Reuse the consumed prefix before growing
+            memmove(q->items, q->items + q->head, q->count * sizeof(*q->items));
+            q->head = 0;
+        } else {
+            uint32_t capacity = q->capacity ? q->capacity * 2 : 16;
+            swim_sim_packet_t **items = (swim_sim_packet_t**)realloc(q->items, capacity * sizeof(*items));
+            if (!items) return -1;
+            q->items = items;
+            q->capacity = capacity;
+        }
+    }
+    q->items[q->head + q->count++] = packet;
+    return 0;
+}
+
+static swim_sim_packet_t* swim_sim_queue_pop(swim_sim_queue_t *q) {
+    if (q->count == 0) return NULL;
+    q->count--;
+    swim_sim_packet_t *packet = q->items[q->head++];
+    if (q->count == 0) q->head = 0;
+    return packet;
+}
+
+static void swim_sim_queue_free(swim_sim_queue_t *q) {
+    swim_sim_packet_t *packet;
+    while ((packet = swim_sim_queue_pop(q)) != NULL) free(packet);
+    free(q->items);
+    memset(q, 0, sizeof(*q));
+}
+
+/*
+ * Datagram heap
+ */
+
+static bool swim_sim_packet_before(const swim_sim_packet_t *a, const swim_sim_packet_t *b) {
+    return a->deliver_us < b->deliver_us || (a->deliver_us == b->deliver_us && a->seq < b->seq);
+}
+
+static int swim_sim_packet_push(swim_sim_t *sim, swim_sim_packet_t *packet) {
+    if (sim->packet_count == sim->packet_capacity) {
+        uint32_t capacity = sim->packet_capacity ? sim->packet_capacity * 2 : 256;
+        swim_sim_packet_t **packets = (swim_sim_packet_t**)realloc(sim->packets, capacity * sizeof(*packets));
+        if (!packets) return -1;
+        sim->packets = packets;
+        sim->packet_capacity = capacity;
+    }
+
+    uint32_t i = sim->packet_count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!swim_sim_packet_before(packet, sim->packets[parent])) break;
+        sim->packets[i] = sim->packets[parent];
+        i = parent;
+    }
+    sim->packets[i] = packet;
+    return 0;
+}
+
+static swim_sim_packet_t* swim_sim_packet_pop(swim_sim_t *sim) {
+    swim_sim_packet_t *top = sim->packets[0];
+    swim_sim_packet_t *last = sim->packets[--sim->packet_count];
+    uint32_t n = sim->packet_count;
+    uint32_t i = 0;
+
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && swim_sim_packet_before(sim->packets[child + 1], sim->packets[child])) child++;
+        if (!swim_sim_packet_before(sim->packets[child], last)) break;
+        sim->packets[i] = sim->packets[child];
+        i = child;
+    }
+    if (n > 0) sim->packets[i] = last;
+    return top;
+}
+
+/*
+ * Deadline heap (indexed, so an endpoint's key can move either way)
+ */
+
+static void swim_sim_heap_set(swim_sim_t *sim, uint32_t i, swim_sim_endpoint_t *ep) {
+    sim->deadlines[i] = ep;
+    ep->heap_pos = i;
+}
+
+static void swim_sim_heap_up(swim_sim_t *sim, uint32_t i) {
+    swim_sim_endpoint_t *ep = sim->deadlines[i];
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (sim->deadlines[parent]->deadline_us <= ep->deadline_us) break;
+        swim_sim_heap_set(sim, i, sim->deadlines[parent]);
+        i = parent;
+    }
+    swim_sim_heap_set(sim, i, ep);
+}
+
+static void swim_sim_heap_down(swim_sim_t *sim, uint32_t i) {
+    swim_sim_endpoint_t *ep = sim->deadlines[i];
+    uint32_t n = sim->deadline_count;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && sim->deadlines[child + 1]->deadline_us < sim->deadlines[child]->deadline_us) child++;
+        if (sim->deadlines[child]->deadline_us >= ep->deadline_us) break;
+        swim_sim_heap_set(sim, i, sim->deadlines[child]);
+        i = child;
+    }
+    swim_sim_heap_set(sim, i, ep);
+}
+
+static void swim_sim_heap_remove(swim_sim_t *sim, swim_sim_endpoint_t *ep) {
+    uint32_t i = ep->heap_pos;
+    if (i == SWIM_SIM_NOT_QUEUED) return;
+
+    ep->heap_pos = SWIM_SIM_NOT_QUEUED;
+    swim_sim_endpoint_t *last = sim->deadlines[--sim->deadline_count];
+    if (last == ep) return;
+
+    swim_sim_heap_set(sim, i, last);
+    swim_sim_heap_up(sim, i);
+    swim_sim_heap_down(sim, last->heap_pos);
+}
+
+/**
+ * (Re)schedule endpoint at its context's next deadline
+ */
+static void swim_sim_schedule(swim_sim_t *sim, swim_sim_endpoint_t *ep, uint64_t deadline_ms) {
+    uint64_t deadline_us = deadline_ms * 1000;
+
+    // Everything due at the current millisecond has just run
+    if (deadline_us <= sim->now_us) deadline_us = (sim->now_us / 1000 + 1) * 1000;
+    ep->deadline_us = deadline_us;
+
+    if (ep->heap_pos == SWIM_SIM_NOT_QUEUED) {
+        ep->heap_pos = sim->deadline_count++;
+        sim->deadlines[ep->heap_pos] = ep;
+        swim_sim_heap_up(sim, ep->heap_pos);
+    } else {
+        swim_sim_heap_up(sim, ep->heap_pos);
+        swim_sim_heap_down(sim, ep->heap_pos);
+    }
+}
+
+/*
+ * Transport
+ */
+
+/**
+ * Queue datagram (always copied: it outlives the sender's buffer)
+ */
+static void swim_sim_send(swim_transport_t *t, const struct sockaddr_in *to, const uint8_t *data,
+                          size_t len, bool copy) {
+    (void)copy;
+    swim_sim_endpoint_t *ep = (swim_sim_endpoint_t*)t;
+
+    swim_sim_packet_t *packet = (swim_sim_packet_t*)malloc(sizeof(swim_sim_packet_t) + len);
+    if (!packet || swim_sim_queue_push(&ep->tx, packet) != 0) {
+        free(packet);
+        t->tx_dropped++;
+        return;
+    }
+
+    packet->from_port = ep->port;
+    packet->to_port = ntohs(to->sin_port);
+    packet->len = (uint32_t)len;
+    memcpy(packet->data, data, len);
+}
+
+/**
+ * Put queued datagrams on the wire: loss, partitions, then latency
+ */
+static void swim_sim_flush(swim_transport_t *t) {
+    swim_sim_endpoint_t *ep = (swim_sim_endpoint_t*)t;
+    swim_sim_t *sim = ep->sim;
+    swim_sim_packet_t *packet;
+
+    if (ep->tx.count > 0) t->tx_calls++;
+
+    while ((packet = swim_sim_queue_pop(&ep->tx)) != NULL) {
+        swim_sim_endpoint_t *dst = sim->by_port[packet->to_port];
+        t->tx_datagrams++;
+        t->tx_bytes += packet->len;
+        sim->stats.datagrams_sent++;
+        sim->stats.bytes_sent += packet->len;
+
+        if (ep->crashed || !dst || dst->crashed) {
+            sim->stats.dropped_unreachable++;
+            free(packet);
+            continue;
+        }
+        if (dst->partition != ep->partition) {
+            sim->stats.dropped_partition++;
+            free(packet);
+            continue;
+        }
+        if (sim->loss > 0 && (double)(swim_rand_next(&sim->rng) >> 11) * (1.0 / 9007199254740992.0) < sim->loss) {
+            sim->stats.dropped_loss++;
+            free(packet);
+            continue;
+        }
+
+        packet->deliver_us = sim->now_us + sim->latency_us +
+                             (sim->jitter_us ? swim_rand_below(&sim->rng, sim->jitter_us) : 0);
+        packet->seq = sim->next_seq++;
+        if (swim_sim_packet_push(sim, packet) != 0) {
+            t->tx_dropped++;
+            free(packet);
+        }
+    }
+}
+
+/**
+ * Hand out up to a batch of delivered datagrams
+ */
+static uint32_t swim_sim_recv(swim_transport_t *t, const swim_io_rx_t **rx) {
+    swim_sim_endpoint_t *ep = (swim_sim_endpoint_t*)t;
+
+    // The previous batch has been handled
+    for (uint32_t i = 0; i < ep->held_count; i++) free(ep->held[i]);
+    ep->held_count = 0;
+
+    swim_sim_packet_t *packet;
+    while (ep->held_count < SWIM_IO_BATCH && (packet = swim_sim_queue_pop(&ep->inbox)) != NULL) {
+        swim_io_rx_t *slot = &ep->rx[ep->held_count];
+        memset(&slot->from, 0, sizeof(slot->from));
+        slot->from.sin_family = AF_INET;
+        slot->from.sin_port = htons(packet->from_port);
+        slot->from.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        slot->data = packet->data;
+        slot->len = packet->len;
+        ep->held[ep->held_count++] = packet;
+    }
+
+    t->rx_calls++;
+    t->rx_datagrams += ep->held_count;
+    *rx = ep->rx;
+    return ep->held_count;
+}
+
+static uint64_t swim_sim_clock(swim_transport_t *t) {
+    return ((swim_sim_endpoint_t*)t)->sim->now_us;
+}
+
+/**
+ * Detach endpoint from the network and free it (called by swim_destroy)
+ */
+static void swim_sim_close(swim_transport_t *t) {
+    swim_sim_endpoint_t *ep = (swim_sim_endpoint_t*)t;
+    swim_sim_t *sim = ep->sim;
+
+    swim_sim_heap_remove(sim, ep);
+    sim->by_port[ep->port] = NULL;
+    swim_sim_endpoint_t *last = sim->endpoints[--sim->endpoint_count];
+    sim->endpoints[ep->index] = last;
+    last->index = ep->index;
+
+    for (uint32_t i = 0; i < ep->held_count; i++) free(ep->held[i]);
+    swim_sim_queue_free(&ep->tx);
+    swim_sim_queue_free(&ep->inbox);
+    free(ep);
+}
+
+static const swim_transport_ops_t swim_sim_ops = {
+    "sim",
+    swim_sim_send,
+    swim_sim_flush,
+    swim_sim_recv,
+    swim_sim_clock,
+    swim_sim_close
+};
+
+/*
+ * Simulator
+ */
+
+/**
+ * Create simulator
+ */
+swim_sim_t* swim_sim_create(uint64_t seed) {
+    swim_sim_t *sim = (swim_sim_t*)calloc(1, sizeof(swim_sim_t));
+    if (!sim) return NULL;
+
+    sim->by_port = (swim_sim_endpoint_t**)calloc(SWIM_SIM_PORTS, sizeof(*sim->by_port));
+    if (!sim->by_port) {
+        free(sim);
+        return NULL;
+    }
+
+    swim_rand_seed(&sim->rng, seed);
+    return sim;
+}
+
+/**
+ * Destroy simulator and its contexts
+ */
+void swim_sim_destroy(swim_sim_t *sim) {
+    if (!sim) return;
+
+    // Each swim_destroy closes its endpoint, which removes it from the array
+    while (sim->endpoint_count > 0) {
+        swim_destroy(sim->endpoints[sim->endpoint_count - 1]->ctx);
+    }
+
+    while (sim->packet_count > 0) free(swim_sim_packet_pop(sim));
+    free(sim->packets);
+    free(sim->endpoints);
+    free(sim->deadlines);
+    free(sim->ready);
+    free(sim->by_port);
+    free(sim);
+}
+
+/**
+ * Configure links
+ */
+void swim_sim_set_network(swim_sim_t *sim, uint32_t latency_us, uint32_t jitter_us, double loss) {
+    sim->latency_us = latency_us;
+    sim->jitter_us = jitter_us;
+    sim->loss = loss;
+}
+
+/**
+ * Make room for one more endpoint in the per-endpoint arrays
+ */
+static int swim_sim_reserve(swim_sim_t *sim) {
+    if (sim->endpoint_count < sim->endpoint_capacity) return 0;
+
+    uint32_t capacity = sim->endpoint_capacity ? sim->endpoint_capacity * 2 : 64;
+    swim_sim_endpoint_t **endpoints = (swim_sim_endpoint_t**)realloc(sim->endpoints, capacity * sizeof(*endpoints));
+    if (!endpoints) return -1;
+    sim->endpoints = endpoints;
+
+    swim_sim_endpoint_t **deadlines = (swim_sim_endpoint_t**)realloc(sim->deadlines, capacity * sizeof(*deadlines));
+    if (!deadlines) return -1;
+    sim->deadlines = deadlines;
+
+    swim_sim_endpoint_t **ready = (swim_sim_endpoint_t**)realloc(sim->ready, capacity * sizeof(*ready));
+    if (!ready) return -1;
+    sim->ready = ready;
+
+    sim->endpoint_capacity = capacity;
+    return 0;
+}
+
+/**
+ * Add node
+ */
+swim_context_t* swim_sim_add_node(swim_sim_t *sim, const char *id, uint16_t port, uint32_t gossip_interval_ms) {
+    if (port == 0 || sim->by_port[port]) {
+        log_error("SWIM: Simulated port %d unavailable", port);
+        return NULL;
+    }
+    if (swim_sim_reserve(sim) != 0) return NULL;
+
+    swim_sim_endpoint_t *ep = (swim_sim_endpoint_t*)calloc(1, sizeof(swim_sim_endpoint_t));
+    if (!ep) return NULL;
+
+    ep->base.ops = &swim_sim_ops;
+    ep->base.fd = SWIM_TRANSPORT_NO_FD;
+    ep->sim = sim;
+    ep->port = port;
+    ep->heap_pos = SWIM_SIM_NOT_QUEUED;
+    ep->index = sim->endpoint_count;
+    sim->endpoints[sim->endpoint_count++] = ep;
+    sim->by_port[port] = ep;
+
+    // On failure the context closes (and unregisters) the endpoint itself
+    swim_context_t *ctx = swim_init_transport(id, port, gossip_interval_ms, &ep->base);
+    if (!ctx) return NULL;
+
+    ep->ctx = ctx;
+    swim_start(ctx);
+    swim_sim_schedule(sim, ep, swim_run_due(ctx));
+    return ctx;
+}
+
+/**
+ * Assign partition
+ */
+void swim_sim_set_partition(swim_sim_t *sim, uint16_t port, uint32_t partition) {
+    if (sim->by_port[port]) sim->by_port[port]->partition = partition;
+}
+
+/**
+ * Heal all partitions
+ */
+void swim_sim_heal(swim_sim_t *sim) {
+    for (uint32_t i = 0; i < sim->endpoint_count; i++) {
+        sim->endpoints[i]->partition = 0;
+    }
+}
+
+/**
+ * Crash node
+ */
+void swim_sim_crash(swim_sim_t *sim, uint16_t port) {
+    swim_sim_endpoint_t *ep = sim->by_port[port];
+    if (!ep || ep->crashed) return;
+
+    ep->crashed = true;
+    swim_sim_heap_remove(sim, ep);
+
+    swim_sim_packet_t *packet;
+    while ((packet = swim_sim_queue_pop(&ep->inbox)) != NULL) free(packet);
+}
+
+/**
+ * Deliver every datagram due by now into its receiver's inbox
+ */
+static void swim_sim_deliver(swim_sim_t *sim) {
+    while (sim->packet_count > 0 && sim->packets[0]->deliver_us <= sim->now_us) {
+        swim_sim_packet_t *packet = swim_sim_packet_pop(sim);
+        swim_sim_endpoint_t *dst = sim->by_port[packet->to_port];
+
+        if (!dst || dst->crashed || swim_sim_queue_push(&dst->inbox, packet) != 0) {
+            sim->stats.dropped_unreachable++;
+            free(packet);
+            continue;
+        }
+
+        sim->stats.datagrams_delivered++;
+        if (!dst->ready) {
+            dst->ready = true;
+            sim->ready[sim->ready_count++] = dst;
+        }
+    }
+}
+
+/**
+ * Run the network
+ */
+void swim_sim_run(swim_sim_t *sim, uint64_t duration_ms) {
+    uint64_t end_us = sim->now_us + duration_ms * 1000;
+
+    // API calls since the last run may have added earlier deadlines
+    for (uint32_t i = 0; i < sim->endpoint_count; i++) {
+        swim_sim_endpoint_t *ep = sim->endpoints[i];
+        if (!ep->crashed) swim_sim_schedule(sim, ep, swim_run_due(ep->ctx));
+    }
+
+    for (;;) {
+        uint64_t next = UINT64_MAX;
+        if (sim->packet_count > 0) next = sim->packets[0]->deliver_us;
+        if (sim->deadline_count > 0 && sim->deadlines[0]->deadline_us < next) {
+            next = sim->deadlines[0]->deadline_us;
+        }
+        if (next > end_us) break;
+        if (next > sim->now_us) sim->now_us = next;
+
+        swim_sim_deliver(sim);
+
+        for (uint32_t i = 0; i < sim->ready_count; i++) {
+            swim_sim_endpoint_t *ep = sim->ready[i];
+            ep->ready = false;
+            swim_process(ep->ctx);
+            swim_sim_schedule(sim, ep, swim_run_due(ep->ctx));
+        }
+        sim->ready_count = 0;
+
+        while (sim->deadline_count > 0 && sim->deadlines[0]->deadline_us <= sim->now_us) {
+            swim_sim_endpoint_t *ep = sim->deadlines[0];
+            swim_sim_schedule(sim, ep, swim_run_due(ep->ctx));
+        }
+    }
+
+    if (end_us > sim->now_us) sim->now_us = end_us;
+}
+
+/**
+ * Virtual time
+ */
+uint64_t swim_sim_now_ms(const swim_sim_t *sim) {
+    return sim->now_us / 1000;
+}
+
+/**
+ * Network counters
+ */
+void swim_sim_get_stats(const swim_sim_t *sim, swim_sim_stats_t *stats) {
+    *stats = sim->stats;
+    stats->in_flight = sim->packet_count;
+    stats->nodes = sim->endpoint_count;
+}
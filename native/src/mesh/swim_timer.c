@@ -0,0 +1,232 @@
+/**
+ * LSDAMM - SWIM Timer Wheel Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_timer.h"
+#include <string.h>
+
+#define SWIM_TIMER_MASK ((uint64_t)SWIM_TIMER_SLOTS - 1)
+
+/**
+ * Count trailing zeros (x != 0)
+ */
+static int swim_timer_ctz(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Link timer into the slot matching its deadline.
+ * Level L holds deadlines in the same level-(L+1) span as the next tick, so
+ * lower levels never wrap; only the top level spans into the next rotation.
+ */
+static void swim_timer_place(swim_timer_wheel_t *wheel, swim_timer_t *timer) {
+    uint64_t ref = wheel->now + 1;
+    uint64_t expires = timer->expires < ref ? ref : timer->expires;
+
+    int level = 0;
+    while (level < SWIM_TIMER_LEVELS - 1 &&
+           (expires >> (SWIM_TIMER_SLOT_BITS * (level + 1))) != (ref >> (SWIM_TIMER_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    int shift = SWIM_TIMER_SLOT_BITS * level;
+    uint32_t slot = (uint32_t)((expires >> shift) & SWIM_TIMER_MASK);
+
+    // Beyond the wheel's range: park in the current top slot, re-placed on cascade
+    if (level == SWIM_TIMER_LEVELS - 1 && (expires >> shift) - (ref >> shift) > SWIM_TIMER_SLOTS) {
+        slot = (uint32_t)((ref >> shift) & SWIM_TIMER_MASK);
+    }
+
+    swim_timer_t **head = &wheel->slots[level][slot];
+
+    timer->level = (uint8_t)level;
+    timer->slot = (uint8_t)slot;
+    timer->prev = NULL;
+    timer->next = *head;
+    if (*head) (*head)->prev = timer;
+    *head = timer;
+
+    wheel->occupied[level] |= 1ull << slot;
+}
+
+/**
+ * Unlink timer from its slot
+ */
+static void swim_timer_unlink(swim_timer_wheel_t *wheel, swim_timer_t *timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        wheel->slots[timer->level][timer->slot] = timer->next;
+        if (!timer->next) {
+            wheel->occupied[timer->level] &= ~(1ull << timer->slot);
+        }
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->prev = NULL;
+    timer->next = NULL;
+}
+
+/**
+ * Move timers of the level slot that starts at tick t down the hierarchy
+ */
+static void swim_timer_cascade(swim_timer_wheel_t *wheel, int level, uint64_t t) {
+    if (level >= SWIM_TIMER_LEVELS) return;
+
+    uint32_t slot = (uint32_t)((t >> (SWIM_TIMER_SLOT_BITS * level)) & SWIM_TIMER_MASK);
+    if (slot == 0) {
+        swim_timer_cascade(wheel, level + 1, t);
+    }
+
+    swim_timer_t *timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(1ull << slot);
+
+    // wheel->now is t - 1 here, so re-placement is relative to tick t
+    while (timer) {
+        swim_timer_t *next = timer->next;
+        swim_timer_place(wheel, timer);
+        timer = next;
+    }
+}
+
+/**
+ * Initialize wheel
+ */
+void swim_timer_wheel_init(swim_timer_wheel_t *wheel, uint64_t now) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now;
+}
+
+/**
+ * Prepare timer
+ */
+void swim_timer_init(swim_timer_t *timer, void *owner, uint8_t kind) {
+    memset(timer, 0, sizeof(*timer));
+    timer->owner = owner;
+    timer->kind = kind;
+}
+
+/**
+ * Arm timer
+ */
+void swim_timer_schedule(swim_timer_wheel_t *wheel, swim_timer_t *timer, uint64_t expires) {
+    if (timer->active) {
+        swim_timer_unlink(wheel, timer);
+    } else {
+        timer->active = true;
+        wheel->active++;
+    }
+
+    timer->expires = expires;
+    swim_timer_place(wheel, timer);
+}
+
+/**
+ * Disarm timer
+ */
+void swim_timer_cancel(swim_timer_wheel_t *wheel, swim_timer_t *timer) {
+    if (!timer->active) return;
+
+    swim_timer_unlink(wheel, timer);
+    timer->active = false;
+    wheel->active--;
+}
+
+/**
+ * Advance wheel, firing due timers
+ */
+void swim_timer_advance(swim_timer_wheel_t *wheel, uint64_t now, swim_timer_cb callback, void *arg) {
+    while (wheel->now < now) {
+        if (wheel->active == 0) {
+            wheel->now = now;
+            break;
+        }
+
+        uint64_t t = wheel->now + 1;
+        uint32_t slot = (uint32_t)(t & SWIM_TIMER_MASK);
+
+        if (slot != 0) {
+            // Skip straight to the next occupied level-0 slot in this rotation
+            uint64_t bits = wheel->occupied[0] >> slot;
+            if (!bits) {
+                uint64_t last = t | SWIM_TIMER_MASK;
+                wheel->now = last < now ? last : now;
+                continue;
+            }
+            t += (uint64_t)swim_timer_ctz(bits);
+            if (t > now) {
+                wheel->now = now;
+                break;
+            }
+            slot = (uint32_t)(t & SWIM_TIMER_MASK);
+        } else {
+            swim_timer_cascade(wheel, 1, t);
+        }
+
+        wheel->now = t;
+
+        // Pop one at a time: callbacks may cancel or re-arm other timers
+        while (wheel->slots[0][slot]) {
+            swim_timer_t *timer = wheel->slots[0][slot];
+            swim_timer_unlink(wheel, timer);
+            timer->active = false;
+            wheel->active--;
+            callback(timer, arg);
+        }
+    }
+}
+
+/**
+ * Next servicing time
+ */
+uint64_t swim_timer_next_expiry(const swim_timer_wheel_t *wheel) {
+    if (wheel->active == 0) return SWIM_TIMER_NEVER;
+
+    uint64_t best = SWIM_TIMER_NEVER;
+    uint64_t ref = wheel->now + 1;
+
+    // Level 0 holds exact deadlines within the current 64 ms span
+    uint64_t ahead = wheel->occupied[0] >> (ref & SWIM_TIMER_MASK);
+    if (ahead) {
+        best = ref + (uint64_t)swim_timer_ctz(ahead);
+    }
+
+    // Higher levels: time of the next cascade of an occupied slot
+    for (int level = 1; level < SWIM_TIMER_LEVELS; level++) {
+        uint64_t bits = wheel->occupied[level];
+        if (!bits) continue;
+
+        int shift = SWIM_TIMER_SLOT_BITS * level;
+        uint64_t span = ref >> shift;
+        uint32_t cur = (uint32_t)(span & SWIM_TIMER_MASK);
+
+        // Current slot is due right now only if the next tick starts its span
+        if ((bits & (1ull << cur)) && (ref & ((1ull << shift) - 1)) == 0) {
+            return ref;
+        }
+
+        // Rotate so bit k is slot cur + 1 + k; the current slot itself is 64 away
+        uint32_t rot = (cur + 1) & (uint32_t)SWIM_TIMER_MASK;
+        uint64_t rotated = rot ? (bits >> rot) | (bits << (SWIM_TIMER_SLOTS - rot)) : bits;
+        uint64_t distance = (uint64_t)swim_timer_ctz(rotated) + 1;
+
+        uint64_t when = (span + distance) << shift;
+        if (when < best) best = when;
+    }
+
+    return best;
+}
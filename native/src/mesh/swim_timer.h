@@ -0,0 +1,79 @@
+/**
+ * LSDAMM - SWIM Timer Wheel Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Hierarchical timing wheel with 1 ms resolution for probe, indirect-probe
+ * and suspicion deadlines. Schedule and cancel are O(1); each timer fires
+ * at most (levels - 1) cascades after being scheduled, with no per-round
+ * scan over members.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_TIMER_H
+#define SWIM_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SWIM_TIMER_LEVELS       4
+#define SWIM_TIMER_SLOT_BITS    6
+#define SWIM_TIMER_SLOTS        (1 << SWIM_TIMER_SLOT_BITS)   // 64 ms, 4 s, 4.4 min, 4.6 h
+#define SWIM_TIMER_NEVER        UINT64_MAX
+
+// Timer (embedded in its owner, no allocation)
+typedef struct swim_timer {
+    uint64_t expires;           // Absolute deadline (ms)
+    void *owner;
+    uint8_t kind;               // Owner-defined event type
+    bool active;
+    uint8_t level;
+    uint8_t slot;
+    struct swim_timer *prev;
+    struct swim_timer *next;
+} swim_timer_t;
+
+typedef void (*swim_timer_cb)(swim_timer_t *timer, void *arg);
+
+// Timer wheel
+typedef struct {
+    uint64_t now;               // Last processed tick (ms)
+    uint64_t occupied[SWIM_TIMER_LEVELS];   // Non-empty slot bitmap per level
+    swim_timer_t *slots[SWIM_TIMER_LEVELS][SWIM_TIMER_SLOTS];
+    uint32_t active;
+} swim_timer_wheel_t;
+
+/**
+ * Initialize wheel at the given time (ms)
+ */
+void swim_timer_wheel_init(swim_timer_wheel_t *wheel, uint64_t now);
+
+/**
+ * Prepare an embedded timer
+ */
+void swim_timer_init(swim_timer_t *timer, void *owner, uint8_t kind);
+
+/**
+ * Arm (or re-arm) timer to fire at an absolute time.
+ * Deadlines at or before the wheel's current time fire on the next advance.
+ */
+void swim_timer_schedule(swim_timer_wheel_t *wheel, swim_timer_t *timer, uint64_t expires);
+
+/**
+ * Disarm timer (no-op if not active)
+ */
+void swim_timer_cancel(swim_timer_wheel_t *wheel, swim_timer_t *timer);
+
+/**
+ * Advance wheel to now, invoking callback for every timer that became due.
+ * Callbacks may schedule or cancel any timer, including the one firing.
+ */
+void swim_timer_advance(swim_timer_wheel_t *wheel, uint64_t now, swim_timer_cb callback, void *arg);
+
+/**
+ * Earliest time the wheel needs servicing (exact for deadlines within the
+ * next 64 ms, otherwise the next cascade). SWIM_TIMER_NEVER if empty.
+ */
+uint64_t swim_timer_next_expiry(const swim_timer_wheel_t *wheel);
+
+#endif // SWIM_TIMER_H
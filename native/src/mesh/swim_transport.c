@@ -0,0 +1,202 @@
+/**
+ * LSDAMM - SWIM Transport Implementation (UDP)
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "swim_transport.h"
+#include "../util/logging.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <unistd.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#endif
+
+// UDP transport: batched socket I/O
+typedef struct {
+    swim_transport_t base;
+    swim_io_t io;
+} swim_udp_transport_t;
+
+/**
+ * System monotonic clock
+ */
+uint64_t swim_transport_system_us(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000 +
+           (uint64_t)(count.QuadPart % freq.QuadPart) * 1000000 / (uint64_t)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * Mirror socket I/O counters into the transport
+ */
+static void swim_udp_sync_counters(swim_udp_transport_t *udp) {
+    udp->base.rx_calls = udp->io.rx_syscalls;
+    udp->base.rx_datagrams = udp->io.rx_datagrams;
+    udp->base.tx_calls = udp->io.tx_syscalls;
+    udp->base.tx_datagrams = udp->io.tx_datagrams;
+    udp->base.tx_dropped = udp->io.tx_dropped;
+}
+
+static void swim_udp_send(swim_transport_t *t, const struct sockaddr_in *to, const uint8_t *data,
+                          size_t len, bool copy) {
+    swim_udp_transport_t *udp = (swim_udp_transport_t*)t;
+    if (copy) {
+        swim_io_queue(&udp->io, to, data, len);
+    } else {
+        swim_io_queue_ref(&udp->io, to, data, len);
+    }
+    t->tx_bytes += len;
+    swim_udp_sync_counters(udp);
+}
+
+static void swim_udp_flush(swim_transport_t *t) {
+    swim_udp_transport_t *udp = (swim_udp_transport_t*)t;
+    swim_io_flush(&udp->io);
+    swim_udp_sync_counters(udp);
+}
+
+static uint32_t swim_udp_recv(swim_transport_t *t, const swim_io_rx_t **rx) {
+    swim_udp_transport_t *udp = (swim_udp_transport_t*)t;
+    uint32_t count = swim_io_recv(&udp->io);
+    swim_udp_sync_counters(udp);
+    *rx = udp->io.rx;
+    return count;
+}
+
+static uint64_t swim_udp_now_us(swim_transport_t *t) {
+    (void)t;
+    return swim_transport_system_us();
+}
+
+/**
+ * Close socket and free
+ */
+static void swim_udp_close(swim_transport_t *t) {
+    swim_udp_transport_t *udp = (swim_udp_transport_t*)t;
+    swim_io_destroy(&udp->io);
+#ifdef _WIN32
+    closesocket(t->fd);
+#else
+    close(t->fd);
+#endif
+    free(udp);
+}
+
+static const swim_transport_ops_t swim_udp_ops = {
+    "udp",
+    swim_udp_send,
+    swim_udp_flush,
+    swim_udp_recv,
+    swim_udp_now_us,
+    swim_udp_close
+};
+
+/**
+ * Open UDP transport, optionally sharing the port with other SO_REUSEPORT sockets
+ */
+static swim_transport_t* swim_udp_open(uint16_t port, bool reuseport) {
+    swim_udp_transport_t *udp = (swim_udp_transport_t*)calloc(1, sizeof(swim_udp_transport_t));
+    if (!udp) return NULL;
+    udp->base.ops = &swim_udp_ops;
+
+    // Create UDP socket
+#ifdef _WIN32
+    swim_socket_t sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock == INVALID_SOCKET) {
+#else
+    swim_socket_t sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+#endif
+        log_error("SWIM: Failed to create socket");
+        free(udp);
+        return NULL;
+    }
+    udp->base.fd = sock;
+
+    // Set non-blocking
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+
+#ifdef SO_REUSEPORT
+    int one = 1;
+    if (reuseport && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+        log_error("SWIM: Failed to enable SO_REUSEPORT on port %d", port);
+        close(sock);
+        free(udp);
+        return NULL;
+    }
+#else
+    (void)reuseport;
+#endif
+
+    // Bind socket
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        log_error("SWIM: Failed to bind socket to port %d", port);
+#ifdef _WIN32
+        closesocket(sock);
+#else
+        close(sock);
+#endif
+        free(udp);
+        return NULL;
+    }
+
+    if (swim_io_init(&udp->io, sock) != 0) {
+        log_error("SWIM: Failed to allocate I/O buffers");
+        swim_udp_close(&udp->base);
+        return NULL;
+    }
+
+    return &udp->base;
+}
+
+/**
+ * Open UDP transport
+ */
+swim_transport_t* swim_transport_udp(uint16_t port) {
+    return swim_udp_open(port, false);
+}
+
+/**
+ * Open UDP transport that receive shards can share
+ */
+swim_transport_t* swim_transport_udp_shared(uint16_t port) {
+#if defined(SO_REUSEPORT) && defined(__linux__)
+    return swim_udp_open(port, true);
+#else
+    log_warn("SWIM: SO_REUSEPORT load balancing unavailable on this platform");
+    (void)port;
+    return NULL;
+#endif
+}
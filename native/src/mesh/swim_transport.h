@@ -0,0 +1,108 @@
+/**
+ * LSDAMM - SWIM Transport Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Everything a SWIM context needs from the outside world: send and receive
+ * datagrams, and read a monotonic clock. The UDP transport is the default;
+ * swim_sim provides an in-memory network on a virtual clock so thousands of
+ * contexts can run deterministically in one process.
+ *
+ * A transport with a descriptor (fd) is driven by the context's protocol
+ * thread. One without (SWIM_TRANSPORT_NO_FD) is driven by its owner through
+ * swim_run_due and swim_process.
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_TRANSPORT_H
+#define SWIM_TRANSPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "swim_io.h"
+
+#ifdef _WIN32
+#define SWIM_TRANSPORT_NO_FD    INVALID_SOCKET
+#else
+#define SWIM_TRANSPORT_NO_FD    (-1)
+#endif
+
+typedef struct swim_transport swim_transport_t;
+
+typedef struct {
+    const char *name;
+    // Queue a datagram; copy = false means data stays valid until the next flush
+    void (*send)(swim_transport_t *t, const struct sockaddr_in *to, const uint8_t *data, size_t len, bool copy);
+    // Hand queued datagrams to the network
+    void (*flush)(swim_transport_t *t);
+    // Receive up to SWIM_IO_BATCH datagrams without blocking; *rx valid until the next recv
+    uint32_t (*recv)(swim_transport_t *t, const swim_io_rx_t **rx);
+    // Monotonic clock (us)
+    uint64_t (*now_us)(swim_transport_t *t);
+    // Release the transport (and the struct itself)
+    void (*close)(swim_transport_t *t);
+} swim_transport_ops_t;
+
+struct swim_transport {
+    const swim_transport_ops_t *ops;
+    swim_socket_t fd;           // Readable when datagrams are waiting, or SWIM_TRANSPORT_NO_FD
+
+    // Counters (maintained by the implementation)
+    uint64_t rx_calls;          // recv syscalls (or simulated receives)
+    uint64_t rx_datagrams;
+    uint64_t tx_calls;
+    uint64_t tx_datagrams;
+    uint64_t tx_bytes;
+    uint64_t tx_dropped;
+};
+
+/**
+ * Open a non-blocking UDP socket bound to port on all interfaces
+ * @return Transport, or NULL on failure
+ */
+swim_transport_t* swim_transport_udp(uint16_t port);
+
+/**
+ * Like swim_transport_udp, but with SO_REUSEPORT so further sockets can
+ * bind the same port and the kernel spreads incoming datagrams across them
+ * @return Transport, or NULL on failure or where the kernel does not
+ *         balance SO_REUSEPORT datagrams (non-Linux)
+ */
+swim_transport_t* swim_transport_udp_shared(uint16_t port);
+
+/**
+ * System monotonic clock (us), as used by the UDP transport
+ */
+uint64_t swim_transport_system_us(void);
+
+/*
+ * Dispatch helpers
+ */
+static inline void swim_transport_send(swim_transport_t *t, const struct sockaddr_in *to,
+                                       const uint8_t *data, size_t len) {
+    t->ops->send(t, to, data, len, true);
+}
+
+static inline void swim_transport_send_ref(swim_transport_t *t, const struct sockaddr_in *to,
+                                           const uint8_t *data, size_t len) {
+    t->ops->send(t, to, data, len, false);
+}
+
+static inline void swim_transport_flush(swim_transport_t *t) {
+    t->ops->flush(t);
+}
+
+static inline uint32_t swim_transport_recv(swim_transport_t *t, const swim_io_rx_t **rx) {
+    return t->ops->recv(t, rx);
+}
+
+static inline uint64_t swim_transport_now_us(swim_transport_t *t) {
+    return t->ops->now_us(t);
+}
+
+static inline void swim_transport_close(swim_transport_t *t) {
+    if (t) t->ops->close(t);
+}
+
+#endif // SWIM_TRANSPORT_H
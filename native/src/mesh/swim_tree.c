@@ -0,0 +1,140 @@
+/**
+ * LSDAMM - SWIM Broadcast Tree Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_tree.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Initialize
+ */
+void swim_tree_init(swim_tree_t *tree, uint8_t timer_kind) {
+    memset(tree, 0, sizeof(*tree));
+    for (uint32_t i = 0; i < SWIM_TREE_MISSING; i++) {
+        swim_timer_init(&tree->missing[i].timer, &tree->missing[i], timer_kind);
+    }
+}
+
+/**
+ * Free cached messages
+ */
+void swim_tree_destroy(swim_tree_t *tree) {
+    for (uint32_t i = 0; i < SWIM_TREE_CACHE; i++) {
+        free(tree->cache[i].data);
+        tree->cache[i].data = NULL;
+    }
+}
+
+/**
+ * Keep a copy of a broadcast
+ */
+int swim_tree_store(swim_tree_t *tree, const char *origin, uint32_t origin_hash, uint32_t seq,
+                    const uint8_t *data, uint32_t len) {
+    uint8_t *copy = (uint8_t*)malloc(len ? len : 1);
+    if (!copy) return -1;
+    if (len) memcpy(copy, data, len);
+
+    swim_tree_msg_t *msg = &tree->cache[tree->cache_next];
+    tree->cache_next = (tree->cache_next + 1) % SWIM_TREE_CACHE;
+
+    free(msg->data);
+    strncpy(msg->origin, origin, SWIM_WIRE_ID_SIZE - 1);
+    msg->origin[SWIM_WIRE_ID_SIZE - 1] = '\0';
+    msg->origin_hash = origin_hash;
+    msg->seq = seq;
+    msg->len = len;
+    msg->data = copy;
+    return 0;
+}
+
+/**
+ * Cached broadcast
+ */
+const swim_tree_msg_t* swim_tree_find(const swim_tree_t *tree, uint32_t origin_hash, uint32_t seq) {
+    for (uint32_t i = 0; i < SWIM_TREE_CACHE; i++) {
+        const swim_tree_msg_t *msg = &tree->cache[i];
+        if (msg->data && msg->origin_hash == origin_hash && msg->seq == seq) return msg;
+    }
+    return NULL;
+}
+
+/**
+ * Awaited broadcast
+ */
+swim_tree_missing_t* swim_tree_missing_find(swim_tree_t *tree, uint32_t origin_hash, uint32_t seq) {
+    for (uint32_t i = 0; i < SWIM_TREE_MISSING; i++) {
+        swim_tree_missing_t *entry = &tree->missing[i];
+        if (entry->used && entry->origin_hash == origin_hash && entry->seq == seq) return entry;
+    }
+    return NULL;
+}
+
+/**
+ * Start awaiting a broadcast
+ */
+swim_tree_missing_t* swim_tree_missing_add(swim_tree_t *tree, const char *origin, uint32_t origin_hash,
+                                           uint32_t seq) {
+    for (uint32_t i = 0; i < SWIM_TREE_MISSING; i++) {
+        swim_tree_missing_t *entry = &tree->missing[i];
+        if (entry->used) continue;
+
+        entry->used = true;
+        strncpy(entry->origin, origin, SWIM_WIRE_ID_SIZE - 1);
+        entry->origin[SWIM_WIRE_ID_SIZE - 1] = '\0';
+        entry->origin_hash = origin_hash;
+        entry->seq = seq;
+        entry->announcer_count = 0;
+        return entry;
+    }
+    return NULL;
+}
+
+/**
+ * Remember another announcer
+ */
+void swim_tree_missing_announce(swim_tree_missing_t *entry, struct swim_node *node) {
+    for (uint32_t i = 0; i < entry->announcer_count; i++) {
+        if (entry->announcers[i] == node) return;
+    }
+    if (entry->announcer_count < SWIM_TREE_ANNOUNCERS) {
+        entry->announcers[entry->announcer_count++] = node;
+    }
+}
+
+/**
+ * Take the oldest announcer
+ */
+struct swim_node* swim_tree_missing_next(swim_tree_missing_t *entry) {
+    if (entry->announcer_count == 0) return NULL;
+
+    struct swim_node *node = entry->announcers[0];
+    entry->announcer_count--;
+    memmove(&entry->announcers[0], &entry->announcers[1], entry->announcer_count * sizeof(entry->announcers[0]));
+    return node;
+}
+
+/**
+ * Stop awaiting
+ */
+void swim_tree_missing_remove(swim_tree_missing_t *entry) {
+    entry->used = false;
+    entry->announcer_count = 0;
+}
+
+/**
+ * Drop a member from every announcer list
+ */
+void swim_tree_forget(swim_tree_t *tree, const struct swim_node *node) {
+    for (uint32_t i = 0; i < SWIM_TREE_MISSING; i++) {
+        swim_tree_missing_t *entry = &tree->missing[i];
+        uint32_t kept = 0;
+        for (uint32_t j = 0; j < entry->announcer_count; j++) {
+            if (entry->announcers[j] != node) entry->announcers[kept++] = entry->announcers[j];
+        }
+        entry->announcer_count = kept;
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * LSDAMM - SWIM Broadcast Tree Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Bookkeeping for Plumtree broadcasts: the recent messages a member can
+ * resend when a neighbour GRAFTs onto the tree through it, and the
+ * messages announced by IHAVE that have not arrived yet, each with the
+ * members that announced it and a timer for asking them.
+ *
+ * Pure state: encoding, sending and the eager/lazy peer sets belong to
+ * the caller.
+ *
+ * Reference: Leitao, Pereira, Rodrigues, "Epidemic Broadcast Trees" (SRDS 2007)
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_TREE_H
+#define SWIM_TREE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swim_timer.h"
+#include "swim_wire.h"
+
+struct swim_node;
+
+#define SWIM_TREE_CACHE         256   // Recent broadcasts kept to answer GRAFTs
+#define SWIM_TREE_MISSING       64    // Announced broadcasts awaited at once
+#define SWIM_TREE_ANNOUNCERS    3     // Members remembered per awaited broadcast
+
+// Broadcast kept for GRAFT replies
+typedef struct {
+    char origin[SWIM_WIRE_ID_SIZE];
+    uint32_t origin_hash;
+    uint32_t seq;
+    uint32_t len;
+    uint8_t *data;              // NULL when the slot is free
+} swim_tree_msg_t;
+
+// Broadcast announced by IHAVE but not yet received
+typedef struct {
+    bool used;
+    char origin[SWIM_WIRE_ID_SIZE];
+    uint32_t origin_hash;
+    uint32_t seq;
+    struct swim_node *announcers[SWIM_TREE_ANNOUNCERS];    // Oldest first
+    uint32_t announcer_count;
+    swim_timer_t timer;         // Owner is this entry
+} swim_tree_missing_t;
+
+typedef struct {
+    swim_tree_msg_t cache[SWIM_TREE_CACHE];    // Ring, oldest overwritten
+    uint32_t cache_next;
+    swim_tree_missing_t missing[SWIM_TREE_MISSING];
+} swim_tree_t;
+
+/**
+ * Initialize
+ * @param timer_kind Kind given to the awaited-message timers
+ */
+void swim_tree_init(swim_tree_t *tree, uint8_t timer_kind);
+
+/**
+ * Free cached messages (timers are the caller's to cancel)
+ */
+void swim_tree_destroy(swim_tree_t *tree);
+
+/**
+ * Keep a copy of a broadcast, evicting the oldest
+ * @return 0 on success, -1 out of memory
+ */
+int swim_tree_store(swim_tree_t *tree, const char *origin, uint32_t origin_hash, uint32_t seq,
+                    const uint8_t *data, uint32_t len);
+
+/**
+ * Cached broadcast, or NULL
+ */
+const swim_tree_msg_t* swim_tree_find(const swim_tree_t *tree, uint32_t origin_hash, uint32_t seq);
+
+/**
+ * Awaited broadcast, or NULL
+ */
+swim_tree_missing_t* swim_tree_missing_find(swim_tree_t *tree, uint32_t origin_hash, uint32_t seq);
+
+/**
+ * Start awaiting a broadcast
+ * @return Entry (timer not yet scheduled), or NULL if SWIM_TREE_MISSING are awaited
+ */
+swim_tree_missing_t* swim_tree_missing_add(swim_tree_t *tree, const char *origin, uint32_t origin_hash,
+                                           uint32_t seq);
+
+/**
+ * Remember another member announcing an awaited broadcast
+ * (ignored once SWIM_TREE_ANNOUNCERS are known)
+ */
+void swim_tree_missing_announce(swim_tree_missing_t *entry, struct swim_node *node);
+
+/**
+ * Take the oldest announcer, or NULL if none is left
+ */
+struct swim_node* swim_tree_missing_next(swim_tree_missing_t *entry);
+
+/**
+ * Stop awaiting (cancel the timer first)
+ */
+void swim_tree_missing_remove(swim_tree_missing_t *entry);
+
+/**
+ * Drop a member from every announcer list (before freeing the node)
+ */
+void swim_tree_forget(swim_tree_t *tree, const struct swim_node *node);
+
+#endif // SWIM_TREE_H
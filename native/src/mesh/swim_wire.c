@@ -0,0 +1,496 @@
+/**
+ * LSDAMM - SWIM Wire Format Implementation
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#include "swim_wire.h"
+#include "swim_gossip.h"
+#include <string.h>
+
+/**
+ * Append bytes if they fit
+ */
+static int swim_wire_put(swim_wire_writer_t *w, const void *src, size_t len) {
+    if (w->cap - w->len < len) return -1;
+    memcpy(w->data + w->len, src, len);
+    w->len += len;
+    return 0;
+}
+
+/**
+ * Append unsigned LEB128 varint
+ */
+static int swim_wire_put_varint(swim_wire_writer_t *w, uint32_t value) {
+    uint8_t buf[5];
+    size_t n = 0;
+
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buf[n++] = value ? (byte | 0x80) : byte;
+    } while (value);
+
+    return swim_wire_put(w, buf, n);
+}
+
+/**
+ * Append length-prefixed string
+ */
+static int swim_wire_put_string(swim_wire_writer_t *w, const char *str, size_t max) {
+    const char *end = (const char*)memchr(str, '\0', max - 1);
+    size_t len = end ? (size_t)(end - str) : max - 1;
+    if (swim_wire_put_varint(w, (uint32_t)len) != 0) return -1;
+    return swim_wire_put(w, str, len);
+}
+
+/**
+ * Quantize ms to coordinate units, saturating at the i16/u16 range
+ */
+static int32_t swim_wire_coord_units(float ms, int32_t lo, int32_t hi) {
+    double units = (double)ms / SWIM_WIRE_COORD_UNIT_MS;
+    if (units < lo) return lo;
+    if (units > hi) return hi;
+    return (int32_t)(units < 0 ? units - 0.5 : units + 0.5);
+}
+
+/**
+ * Append network coordinate (dimension 0 when absent)
+ */
+static int swim_wire_put_coord(swim_wire_writer_t *w, const swim_wire_header_t *header) {
+    uint8_t buf[1 + 2 * SWIM_COORD_DIM + 3];
+    size_t n = 0;
+
+    buf[n++] = header->has_coord ? SWIM_COORD_DIM : 0;
+    if (header->has_coord) {
+        for (int i = 0; i < SWIM_COORD_DIM; i++) {
+            uint16_t v = (uint16_t)(int16_t)swim_wire_coord_units(header->coord.vec[i], INT16_MIN, INT16_MAX);
+            buf[n++] = (uint8_t)(v >> 8);
+            buf[n++] = (uint8_t)v;
+        }
+        uint16_t height = (uint16_t)swim_wire_coord_units(header->coord.height, 0, UINT16_MAX);
+        buf[n++] = (uint8_t)(height >> 8);
+        buf[n++] = (uint8_t)height;
+        double error = header->coord.error * 100.0 + 0.5;
+        buf[n++] = (uint8_t)(error > 255 ? 255 : error < 0 ? 0 : error);
+    }
+
+    return swim_wire_put(w, buf, n);
+}
+
+/**
+ * Append big-endian integer of size bytes
+ */
+static int swim_wire_put_be(swim_wire_writer_t *w, uint64_t value, size_t size) {
+    uint8_t buf[8];
+    for (size_t i = 0; i < size; i++) buf[i] = (uint8_t)(value >> (8 * (size - 1 - i)));
+    return swim_wire_put(w, buf, size);
+}
+
+/**
+ * Read one byte
+ */
+static int swim_wire_get_u8(swim_wire_reader_t *r, uint8_t *out) {
+    if (r->pos >= r->len) return -1;
+    *out = r->data[r->pos++];
+    return 0;
+}
+
+/**
+ * Read unsigned LEB128 varint (at most 5 bytes for 32 bits)
+ */
+static int swim_wire_get_varint(swim_wire_reader_t *r, uint32_t *out) {
+    uint32_t value = 0;
+
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte;
+        if (swim_wire_get_u8(r, &byte) != 0) return -1;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *out = value;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Read big-endian integer of size bytes
+ */
+static int swim_wire_get_be(swim_wire_reader_t *r, uint64_t *out, size_t size) {
+    if (r->len - r->pos < size) return -1;
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) value = (value << 8) | r->data[r->pos++];
+    *out = value;
+    return 0;
+}
+
+/**
+ * Read network coordinate; a dimension we do not use is an error
+ */
+static int swim_wire_get_coord(swim_wire_reader_t *r, swim_wire_header_t *header) {
+    uint8_t dim;
+    if (swim_wire_get_u8(r, &dim) != 0) return -1;
+
+    header->has_coord = 0;
+    if (dim == 0) return 0;
+    if (dim != SWIM_COORD_DIM || r->len - r->pos < 2 * (size_t)dim + 3) return -1;
+
+    const uint8_t *p = r->data + r->pos;
+    for (int i = 0; i < SWIM_COORD_DIM; i++, p += 2) {
+        int16_t v = (int16_t)(uint16_t)((p[0] << 8) | p[1]);
+        header->coord.vec[i] = (float)(v * SWIM_WIRE_COORD_UNIT_MS);
+    }
+    header->coord.height = (float)(((p[0] << 8) | p[1]) * SWIM_WIRE_COORD_UNIT_MS);
+    header->coord.error = p[2] / 100.0f;
+    r->pos += 2 * (size_t)dim + 3;
+
+    header->has_coord = 1;
+    return 0;
+}
+
+/**
+ * Read length-prefixed string into a NUL-terminated buffer
+ */
+static int swim_wire_get_string(swim_wire_reader_t *r, char *out, size_t size) {
+    uint32_t len;
+    if (swim_wire_get_varint(r, &len) != 0) return -1;
+    if (len >= size || r->len - r->pos < len) return -1;
+
+    memcpy(out, r->data + r->pos, len);
+    out[len] = '\0';
+    r->pos += len;
+    return 0;
+}
+
+/**
+ * Start encoding
+ */
+void swim_wire_writer_init(swim_wire_writer_t *w, uint8_t *buf, size_t cap) {
+    w->data = buf;
+    w->cap = cap;
+    w->len = 0;
+}
+
+/**
+ * Encode message header
+ */
+int swim_wire_write_header(swim_wire_writer_t *w, const swim_wire_header_t *header) {
+    size_t start = w->len;
+    uint8_t prefix[2] = { SWIM_WIRE_VERSION, header->type };
+
+    int rc = swim_wire_put(w, prefix, sizeof(prefix));
+    if (rc == 0) rc = swim_wire_put_varint(w, header->seq_num);
+    if (rc == 0) rc = swim_wire_put_varint(w, header->incarnation);
+    if (rc == 0) rc = swim_wire_put_string(w, header->sender_id, sizeof(header->sender_id));
+    if (rc == 0 && (header->type == SWIM_MSG_PING || header->type == SWIM_MSG_PING_REQ)) {
+        rc = swim_wire_put_string(w, header->target_id, sizeof(header->target_id));
+    }
+    if (rc == 0 && (header->type == SWIM_MSG_PING || header->type == SWIM_MSG_ACK)) {
+        rc = swim_wire_put_coord(w, header);
+    }
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append membership update
+ */
+int swim_wire_write_update(swim_wire_writer_t *w, const swim_wire_update_t *update) {
+    size_t start = w->len;
+    uint8_t fixed[3] = {
+        (uint8_t)(update->port >> 8),
+        (uint8_t)(update->port & 0xFF),
+        (uint8_t)((update->state & 0x07) | (update->accuser[0] ? 0x40 : 0) |
+                  (update->is_main_node ? 0x80 : 0))
+    };
+
+    int rc = swim_wire_put_string(w, update->id, sizeof(update->id));
+    if (rc == 0) rc = swim_wire_put_string(w, update->address, sizeof(update->address));
+    if (rc == 0) rc = swim_wire_put(w, fixed, sizeof(fixed));
+    if (rc == 0) rc = swim_wire_put_varint(w, update->incarnation);
+    if (rc == 0 && update->accuser[0]) {
+        rc = swim_wire_put_string(w, update->accuser, sizeof(update->accuser));
+    }
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append membership digest
+ */
+int swim_wire_write_digest(swim_wire_writer_t *w, const uint32_t *buckets, uint32_t count) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_varint(w, count);
+    for (uint32_t i = 0; rc == 0 && i < count; i++) {
+        uint8_t be[4] = {
+            (uint8_t)(buckets[i] >> 24), (uint8_t)(buckets[i] >> 16),
+            (uint8_t)(buckets[i] >> 8), (uint8_t)buckets[i]
+        };
+        rc = swim_wire_put(w, be, sizeof(be));
+    }
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append user message body
+ */
+int swim_wire_write_user(swim_wire_writer_t *w, const swim_wire_user_t *user) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_string(w, user->origin, sizeof(user->origin));
+    if (rc == 0) rc = swim_wire_put_varint(w, user->origin_seq);
+    if (rc == 0) rc = swim_wire_put(w, &user->hops, 1);
+    if (rc == 0) rc = swim_wire_put_varint(w, user->len);
+    if (rc == 0) rc = swim_wire_put(w, user->payload, user->len);
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append broadcast identities
+ */
+int swim_wire_write_ids(swim_wire_writer_t *w, const swim_wire_msgid_t *ids, uint32_t count) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_varint(w, count);
+    for (uint32_t i = 0; rc == 0 && i < count; i++) {
+        rc = swim_wire_put_string(w, ids[i].origin, sizeof(ids[i].origin));
+        if (rc == 0) rc = swim_wire_put_varint(w, ids[i].origin_seq);
+    }
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append channel fragment
+ */
+int swim_wire_write_data(swim_wire_writer_t *w, const swim_wire_data_t *data) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_be(w, data->session, 4);
+    if (rc == 0) rc = swim_wire_put_varint(w, data->seq);
+    if (rc == 0) rc = swim_wire_put(w, &data->flags, 1);
+    if (rc == 0) rc = swim_wire_put_varint(w, data->len);
+    if (rc == 0) rc = swim_wire_put(w, data->payload, data->len);
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Append channel acknowledgement
+ */
+int swim_wire_write_data_ack(swim_wire_writer_t *w, const swim_wire_data_ack_t *ack) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_be(w, ack->session, 4);
+    if (rc == 0) rc = swim_wire_put_varint(w, ack->cum);
+    if (rc == 0) rc = swim_wire_put_varint(w, ack->window);
+    if (rc == 0) rc = swim_wire_put_be(w, ack->sack, 8);
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Start compound datagram
+ */
+int swim_wire_write_compound(swim_wire_writer_t *w) {
+    uint8_t prefix[SWIM_WIRE_COMPOUND_PREFIX] = { SWIM_WIRE_VERSION, SWIM_MSG_COMPOUND };
+    return swim_wire_put(w, prefix, sizeof(prefix));
+}
+
+/**
+ * Append compound part
+ */
+int swim_wire_write_part(swim_wire_writer_t *w, const uint8_t *msg, size_t len) {
+    size_t start = w->len;
+
+    int rc = swim_wire_put_varint(w, (uint32_t)len);
+    if (rc == 0) rc = swim_wire_put(w, msg, len);
+
+    if (rc != 0) w->len = start;
+    return rc;
+}
+
+/**
+ * Start decoding
+ */
+void swim_wire_reader_init(swim_wire_reader_t *r, const uint8_t *data, size_t len) {
+    r->data = data;
+    r->len = len;
+    r->pos = 0;
+}
+
+/**
+ * Decode message header
+ */
+int swim_wire_read_header(swim_wire_reader_t *r, swim_wire_header_t *header) {
+    uint8_t version;
+
+    if (swim_wire_get_u8(r, &version) != 0 || version != SWIM_WIRE_VERSION) return -1;
+    if (swim_wire_get_u8(r, &header->type) != 0) return -1;
+    if (swim_wire_get_varint(r, &header->seq_num) != 0) return -1;
+    if (swim_wire_get_varint(r, &header->incarnation) != 0) return -1;
+    if (swim_wire_get_string(r, header->sender_id, sizeof(header->sender_id)) != 0) return -1;
+
+    header->target_id[0] = '\0';
+    if (header->type == SWIM_MSG_PING || header->type == SWIM_MSG_PING_REQ) {
+        if (swim_wire_get_string(r, header->target_id, sizeof(header->target_id)) != 0) return -1;
+    }
+
+    header->has_coord = 0;
+    if (header->type == SWIM_MSG_PING || header->type == SWIM_MSG_ACK) {
+        if (swim_wire_get_coord(r, header) != 0) return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Decode user message body
+ */
+int swim_wire_read_user(swim_wire_reader_t *r, swim_wire_user_t *user) {
+    if (swim_wire_get_string(r, user->origin, sizeof(user->origin)) != 0) return -1;
+    if (swim_wire_get_varint(r, &user->origin_seq) != 0) return -1;
+    if (swim_wire_get_u8(r, &user->hops) != 0) return -1;
+    if (swim_wire_get_varint(r, &user->len) != 0) return -1;
+    if (r->len - r->pos < user->len) return -1;
+
+    user->payload = r->data + r->pos;
+    r->pos += user->len;
+    return 0;
+}
+
+/**
+ * Decode broadcast identities
+ */
+int swim_wire_read_ids(swim_wire_reader_t *r, swim_wire_msgid_t *ids, uint32_t max) {
+    uint32_t count;
+
+    if (swim_wire_get_varint(r, &count) != 0 || count > max) return -1;
+    for (uint32_t i = 0; i < count; i++) {
+        if (swim_wire_get_string(r, ids[i].origin, sizeof(ids[i].origin)) != 0) return -1;
+        if (swim_wire_get_varint(r, &ids[i].origin_seq) != 0) return -1;
+    }
+
+    return (int)count;
+}
+
+/**
+ * Decode channel fragment
+ */
+int swim_wire_read_data(swim_wire_reader_t *r, swim_wire_data_t *data) {
+    uint64_t session;
+
+    if (swim_wire_get_be(r, &session, 4) != 0) return -1;
+    if (swim_wire_get_varint(r, &data->seq) != 0) return -1;
+    if (swim_wire_get_u8(r, &data->flags) != 0) return -1;
+    if (swim_wire_get_varint(r, &data->len) != 0) return -1;
+    if (r->len - r->pos < data->len) return -1;
+
+    data->session = (uint32_t)session;
+    data->payload = r->data + r->pos;
+    r->pos += data->len;
+    return 0;
+}
+
+/**
+ * Decode channel acknowledgement
+ */
+int swim_wire_read_data_ack(swim_wire_reader_t *r, swim_wire_data_ack_t *ack) {
+    uint64_t session;
+
+    if (swim_wire_get_be(r, &session, 4) != 0) return -1;
+    if (swim_wire_get_varint(r, &ack->cum) != 0) return -1;
+    if (swim_wire_get_varint(r, &ack->window) != 0) return -1;
+    if (swim_wire_get_be(r, &ack->sack, 8) != 0) return -1;
+
+    ack->session = (uint32_t)session;
+    return 0;
+}
+
+/**
+ * Consume compound prefix
+ */
+int swim_wire_read_compound(swim_wire_reader_t *r) {
+    if (r->len - r->pos < SWIM_WIRE_COMPOUND_PREFIX) return -1;
+    if (r->data[r->pos] != SWIM_WIRE_VERSION || r->data[r->pos + 1] != SWIM_MSG_COMPOUND) return -1;
+
+    r->pos += SWIM_WIRE_COMPOUND_PREFIX;
+    return 0;
+}
+
+/**
+ * Decode next compound part
+ */
+int swim_wire_read_part(swim_wire_reader_t *r, const uint8_t **msg, size_t *len) {
+    if (r->pos == r->len) return 0;
+
+    uint32_t part_len;
+    if (swim_wire_get_varint(r, &part_len) != 0) return -1;
+    if (part_len == 0 || r->len - r->pos < part_len) return -1;
+
+    *msg = r->data + r->pos;
+    *len = part_len;
+    r->pos += part_len;
+    return 1;
+}
+
+/**
+ * Decode next membership update
+ */
+int swim_wire_read_update(swim_wire_reader_t *r, swim_wire_update_t *update) {
+    if (r->pos == r->len) return 0;
+
+    uint8_t fixed[3];
+
+    if (swim_wire_get_string(r, update->id, sizeof(update->id)) != 0) return -1;
+    if (swim_wire_get_string(r, update->address, sizeof(update->address)) != 0) return -1;
+    if (r->len - r->pos < sizeof(fixed)) return -1;
+    memcpy(fixed, r->data + r->pos, sizeof(fixed));
+    r->pos += sizeof(fixed);
+    if (swim_wire_get_varint(r, &update->incarnation) != 0) return -1;
+
+    update->port = (uint16_t)((fixed[0] << 8) | fixed[1]);
+    update->state = fixed[2] & 0x07;
+    update->is_main_node = (fixed[2] & 0x80) ? 1 : 0;
+
+    update->accuser[0] = '\0';
+    if ((fixed[2] & 0x40) &&
+        swim_wire_get_string(r, update->accuser, sizeof(update->accuser)) != 0) {
+        return -1;
+    }
+
+    return 1;
+}
+
+/**
+ * Decode membership digest
+ */
+int swim_wire_read_digest(swim_wire_reader_t *r, uint32_t *buckets, uint32_t max) {
+    uint32_t count;
+
+    if (swim_wire_get_varint(r, &count) != 0 || count > max) return -1;
+    if (r->len - r->pos < (size_t)count * 4) return -1;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *be = r->data + r->pos + (size_t)i * 4;
+        buckets[i] = ((uint32_t)be[0] << 24) | ((uint32_t)be[1] << 16) |
+                     ((uint32_t)be[2] << 8) | be[3];
+    }
+    r->pos += (size_t)count * 4;
+
+    return (int)count;
+}
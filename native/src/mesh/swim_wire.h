@@ -0,0 +1,244 @@
+/**
+ * LSDAMM - SWIM Wire Format Header
+ * Lackadaisical Spectral Distributed AI MCP Mesh
+ *
+ * Compact, versioned binary encoding for SWIM datagrams. Integers are
+ * big-endian or unsigned LEB128 varints, strings are varint length-prefixed
+ * (no padding, no NUL). Layout:
+ *
+ *   datagram = message | compound
+ *   compound = version:u8 type:u8 (COMPOUND) part*   (to the end of the datagram)
+ *   part     = len:varint message
+ *   message  = version:u8 type:u8 seq:varint incarnation:varint sender:str
+ *              [target:str]                 (PING, PING_REQ)
+ *              [coord]                      (PING, ACK)
+ *              [user]                       (USER, PUSH)
+ *              [ids]                        (IHAVE, GRAFT)
+ *              [data]                       (DATA)
+ *              [data_ack]                   (DATA_ACK)
+ *              update*                      (to the end of the datagram)
+ *              | digest                     (DIGEST, DIGEST_REPLY)
+ *   user     = origin:str origin_seq:varint hops:u8 len:varint payload:u8*len
+ *   ids      = count:varint (origin:str origin_seq:varint)*
+ *   data     = session:u32 seq:varint flags:u8 len:varint payload:u8*len
+ *   data_ack = session:u32 cum:varint window:varint sack:u64
+ *   update   = id:str address:str port:u16 flags:u8 incarnation:varint
+ *              [accuser:str]                (flags bit 6)
+ *   digest   = count:varint hash:u32*count
+ *   coord    = dim:u8 [component:i16*dim height:u16 error:u8]   (dim 0: none)
+ *              (distances in SWIM_WIRE_COORD_UNIT_MS, error in hundredths)
+ *   flags    = state (bits 0-2) | accuser present (bit 6) | main node (bit 7)
+ *
+ * (c) 2025 Lackadaisical Security
+ */
+
+#ifndef SWIM_WIRE_H
+#define SWIM_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "swim_coord.h"
+
+#define SWIM_WIRE_VERSION       4
+#define SWIM_WIRE_ID_SIZE       64    // Decoded ID buffer, including NUL
+#define SWIM_WIRE_ADDR_SIZE     64    // Decoded address buffer, including NUL
+#define SWIM_WIRE_COORD_UNIT_MS 0.025 // Coordinate resolution (+-819 ms per axis)
+
+// Largest encoded update entry (three maximal strings, port, flags, 5-byte varint)
+#define SWIM_WIRE_UPDATE_MAX    (3 * SWIM_WIRE_ID_SIZE + 2 + 1 + 5)
+
+// Compound prefix, and the length prefix a part adds for messages up to 16 KB
+#define SWIM_WIRE_COMPOUND_PREFIX   2
+#define SWIM_WIRE_PART_OVERHEAD     2
+
+// DATA message less its sender string and payload (prefix, seq, incarnation,
+// sender length, session, fragment seq, flags, payload length)
+#define SWIM_WIRE_DATA_OVERHEAD     (2 + 5 + 5 + 1 + 4 + 5 + 1 + 3)
+
+// Decoded message header
+typedef struct {
+    uint8_t type;
+    uint32_t seq_num;
+    uint32_t incarnation;
+    char sender_id[SWIM_WIRE_ID_SIZE];
+    char target_id[SWIM_WIRE_ID_SIZE];  // PING / PING_REQ only
+    uint8_t has_coord;                  // PING / ACK: sender's network coordinate follows
+    swim_coord_t coord;
+} swim_wire_header_t;
+
+// Decoded membership update entry
+typedef struct {
+    char id[SWIM_WIRE_ID_SIZE];
+    char address[SWIM_WIRE_ADDR_SIZE];
+    uint16_t port;
+    uint8_t state;
+    uint32_t incarnation;
+    uint8_t is_main_node;
+    char accuser[SWIM_WIRE_ID_SIZE];    // Member that raised a suspicion ("" if none)
+} swim_wire_update_t;
+
+// Decoded user message body
+typedef struct {
+    char origin[SWIM_WIRE_ID_SIZE];     // Member that broadcast it
+    uint32_t origin_seq;                // Per-origin sequence (with origin, the dedup key)
+    uint8_t hops;                       // Gossip hops left (0: deliver, do not forward)
+    const uint8_t *payload;             // Points into the datagram once decoded
+    uint32_t len;
+} swim_wire_user_t;
+
+// Broadcast identity, as announced by IHAVE and requested by GRAFT
+typedef struct {
+    char origin[SWIM_WIRE_ID_SIZE];
+    uint32_t origin_seq;
+} swim_wire_msgid_t;
+
+// Decoded reliable channel fragment
+typedef struct {
+    uint32_t session;                   // Sender's stream id
+    uint32_t seq;                       // Fragment number within the session
+    uint8_t flags;                      // SWIM_CHANNEL_FLAG_*
+    const uint8_t *payload;             // Points into the datagram once decoded
+    uint32_t len;
+} swim_wire_data_t;
+
+// Decoded reliable channel acknowledgement
+typedef struct {
+    uint32_t session;                   // Stream being acknowledged
+    uint32_t cum;                       // Next fragment expected in order
+    uint32_t window;                    // Fragments the receiver can still hold
+    uint64_t sack;                      // Bit i: fragment cum + i is held
+} swim_wire_data_ack_t;
+
+// Encoder over a caller-owned buffer
+typedef struct {
+    uint8_t *data;
+    size_t cap;
+    size_t len;
+} swim_wire_writer_t;
+
+// Decoder over a received datagram
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} swim_wire_reader_t;
+
+/**
+ * Start encoding into buf
+ */
+void swim_wire_writer_init(swim_wire_writer_t *w, uint8_t *buf, size_t cap);
+
+/**
+ * Encode message header (and target for PING/PING_REQ, coordinate for PING/ACK)
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_header(swim_wire_writer_t *w, const swim_wire_header_t *header);
+
+/**
+ * Append one membership update
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_update(swim_wire_writer_t *w, const swim_wire_update_t *update);
+
+/**
+ * Append a membership digest (anti-entropy bucket hashes)
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_digest(swim_wire_writer_t *w, const uint32_t *buckets, uint32_t count);
+
+/**
+ * Append a user message body (after a USER header)
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_user(swim_wire_writer_t *w, const swim_wire_user_t *user);
+
+/**
+ * Append broadcast identities (after an IHAVE or GRAFT header)
+ * @return 0 on success, -1 if they do not fit (writer unchanged)
+ */
+int swim_wire_write_ids(swim_wire_writer_t *w, const swim_wire_msgid_t *ids, uint32_t count);
+
+/**
+ * Append a channel fragment (after a DATA header)
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_data(swim_wire_writer_t *w, const swim_wire_data_t *data);
+
+/**
+ * Append a channel acknowledgement (after a DATA_ACK header)
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_data_ack(swim_wire_writer_t *w, const swim_wire_data_ack_t *ack);
+
+/**
+ * Start a compound datagram; follow with swim_wire_write_part
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_compound(swim_wire_writer_t *w);
+
+/**
+ * Append one encoded message to a compound datagram
+ * @return 0 on success, -1 if it does not fit (writer unchanged)
+ */
+int swim_wire_write_part(swim_wire_writer_t *w, const uint8_t *msg, size_t len);
+
+/**
+ * Start decoding a datagram
+ */
+void swim_wire_reader_init(swim_wire_reader_t *r, const uint8_t *data, size_t len);
+
+/**
+ * Decode message header
+ * @return 0 on success, -1 if malformed or an unsupported version
+ */
+int swim_wire_read_header(swim_wire_reader_t *r, swim_wire_header_t *header);
+
+/**
+ * Decode a user message body; payload points into the datagram
+ * @return 0 on success, -1 if malformed
+ */
+int swim_wire_read_user(swim_wire_reader_t *r, swim_wire_user_t *user);
+
+/**
+ * Decode broadcast identities into ids[0..max)
+ * @return Count, or -1 if malformed or more than max
+ */
+int swim_wire_read_ids(swim_wire_reader_t *r, swim_wire_msgid_t *ids, uint32_t max);
+
+/**
+ * Decode a channel fragment; payload points into the datagram
+ * @return 0 on success, -1 if malformed
+ */
+int swim_wire_read_data(swim_wire_reader_t *r, swim_wire_data_t *data);
+
+/**
+ * Decode a channel acknowledgement
+ * @return 0 on success, -1 if malformed
+ */
+int swim_wire_read_data_ack(swim_wire_reader_t *r, swim_wire_data_ack_t *ack);
+
+/**
+ * Consume the compound prefix if the datagram is one
+ * @return 0 if compound, -1 otherwise (reader unchanged)
+ */
+int swim_wire_read_compound(swim_wire_reader_t *r);
+
+/**
+ * Decode the next part of a compound datagram; msg points into the datagram
+ * @return 1 if a part was read, 0 at end of datagram, -1 if malformed
+ */
+int swim_wire_read_part(swim_wire_reader_t *r, const uint8_t **msg, size_t *len);
+
+/**
+ * Decode the next membership update
+ * @return 1 if an update was read, 0 at end of datagram, -1 if malformed
+ */
+int swim_wire_read_update(swim_wire_reader_t *r, swim_wire_update_t *update);
+
+/**
+ * Decode a membership digest into buckets[0..max)
+ * @return Bucket count, or -1 if malformed or larger than max
+ */
+int swim_wire_read_digest(swim_wire_reader_t *r, uint32_t *buckets, uint32_t max);
+
+#endif // SWIM_WIRE_H
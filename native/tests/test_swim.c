@@ -5,11 +5,31 @@
  * (c) 2025 Lackadaisical Security
  */
 
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
+#ifdef _WIN32
+#include <windows.h>
+#define sleep_ms(ms) Sleep(ms)
+#else
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#define sleep_ms(ms) usleep((ms) * 1000)
+#endif
 #include "../src/mesh/swim_gossip.h"
+#include "../src/mesh/swim_shm.h"
+#include "../src/mesh/swim_reactor.h"
+#include "../src/mesh/swim_sim.h"
+#include "../src/mesh/swim_index.h"
+#include "../src/mesh/swim_timer.h"
+#include "../src/mesh/swim_wire.h"
+#include "../src/mesh/swim_bootstrap.h"
+#include "../src/mesh/node_manager.h"
 #include "../src/util/logging.h"
 
 #define TEST_PASS() printf("  PASS\n")
@@ -107,6 +127,2867 @@ int test_node_lookup(void) {
     return 0;
 }
 
+/**
+ * Test hash index insert/find/remove with growth and tombstones
+ */
+int test_node_index(void) {
+    printf("Testing swim_index...\n");
+    
+    enum { COUNT = 1000 };
+    swim_node_t *nodes = (swim_node_t*)calloc(COUNT, sizeof(swim_node_t));
+    swim_index_t index;
+    if (!nodes || swim_index_init(&index, 0) != 0) {
+        free(nodes);
+        TEST_FAIL("Failed to create index");
+    }
+    
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(nodes[i].id, SWIM_NODE_ID_SIZE, "node-%d", i);
+        nodes[i].id_hash = swim_hash_id(nodes[i].id);
+        swim_index_insert(&index, &nodes[i]);
+    }
+    
+    // Remove every other node, then look everything up
+    for (int i = 0; i < COUNT; i += 2) {
+        if (swim_index_remove(&index, nodes[i].id, nodes[i].id_hash) != &nodes[i]) {
+            swim_index_destroy(&index);
+            free(nodes);
+            TEST_FAIL("Remove returned wrong node");
+        }
+    }
+    
+    for (int i = 0; i < COUNT; i++) {
+        swim_node_t *found = swim_index_find(&index, nodes[i].id, nodes[i].id_hash);
+        if ((i % 2 == 0 && found) || (i % 2 == 1 && found != &nodes[i])) {
+            swim_index_destroy(&index);
+            free(nodes);
+            TEST_FAIL("Lookup mismatch after removal");
+        }
+    }
+    
+    if (index.count != COUNT / 2) {
+        swim_index_destroy(&index);
+        free(nodes);
+        TEST_FAIL("Index count mismatch");
+    }
+    
+    swim_index_destroy(&index);
+    free(nodes);
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test wire format round trip and rejection of bad datagrams
+ */
+int test_wire_format(void) {
+    printf("Testing swim_wire...\n");
+    
+    uint8_t buf[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    swim_wire_update_t update = {0};
+    
+    header.type = SWIM_MSG_PING;
+    header.seq_num = 300000;
+    header.incarnation = 129;
+    strcpy(header.sender_id, "lsdamm-server-01-node-0-1735689600");
+    strcpy(header.target_id, "lsdamm-server-01-node-1-1735689600");
+    header.has_coord = 1;
+    swim_coord_init(&header.coord);
+    for (int i = 0; i < SWIM_COORD_DIM; i++) header.coord.vec[i] = (float)(i * 3.3 - 10.0);
+    header.coord.height = 0.5f;
+    header.coord.error = 0.4f;
+    
+    swim_wire_writer_init(&w, buf, sizeof(buf));
+    if (swim_wire_write_header(&w, &header) != 0) {
+        TEST_FAIL("Header encode failed");
+    }
+    if (w.len >= 100) {
+        TEST_FAIL("PING not under 100 bytes");
+    }
+    
+    strcpy(update.id, "lsdamm-server-01-node-2-1735689600");
+    strcpy(update.address, "10.0.0.2");
+    update.port = 7946;
+    update.state = NODE_STATE_SUSPECT;
+    update.incarnation = 70000;
+    update.is_main_node = 1;
+    swim_wire_write_update(&w, &update);
+    swim_wire_write_update(&w, &update);
+    
+    swim_wire_reader_t r;
+    swim_wire_header_t decoded;
+    swim_wire_update_t out;
+    swim_wire_reader_init(&r, buf, w.len);
+    if (swim_wire_read_header(&r, &decoded) != 0 ||
+        decoded.type != SWIM_MSG_PING || decoded.seq_num != 300000 || decoded.incarnation != 129 ||
+        strcmp(decoded.sender_id, header.sender_id) != 0 ||
+        strcmp(decoded.target_id, header.target_id) != 0) {
+        TEST_FAIL("Header round trip mismatch");
+    }
+    if (!decoded.has_coord || fabs(decoded.coord.vec[7] - header.coord.vec[7]) > SWIM_WIRE_COORD_UNIT_MS ||
+        fabs(decoded.coord.height - 0.5) > SWIM_WIRE_COORD_UNIT_MS || fabs(decoded.coord.error - 0.4) > 0.01) {
+        TEST_FAIL("Coordinate round trip mismatch");
+    }
+    
+    int count = 0;
+    while (swim_wire_read_update(&r, &out) > 0) {
+        if (strcmp(out.id, update.id) != 0 || strcmp(out.address, update.address) != 0 ||
+            out.port != 7946 || out.state != NODE_STATE_SUSPECT ||
+            out.incarnation != 70000 || !out.is_main_node) {
+            TEST_FAIL("Update round trip mismatch");
+        }
+        count++;
+    }
+    if (count != 2) {
+        TEST_FAIL("Wrong update count");
+    }
+    
+    // Truncated update entry is an error, not a short read
+    swim_wire_reader_init(&r, buf, w.len - 1);
+    swim_wire_read_header(&r, &decoded);
+    swim_wire_read_update(&r, &out);
+    if (swim_wire_read_update(&r, &out) != -1) {
+        TEST_FAIL("Truncated update accepted");
+    }
+    
+    // Other protocol versions are rejected
+    buf[0] = 1;
+    swim_wire_reader_init(&r, buf, w.len);
+    if (swim_wire_read_header(&r, &decoded) != -1) {
+        TEST_FAIL("Unsupported version accepted");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test batched send/receive crosses batch boundaries without loss
+ */
+int test_batched_io(void) {
+    printf("Testing swim_io batching...\n");
+    
+    swim_context_t *a = swim_init("io-node-a", 7957, 1000);
+    swim_context_t *b = swim_init("io-node-b", 7958, 1000);
+    if (!a || !b) {
+        if (a) swim_destroy(a);
+        if (b) swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(7958);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    enum { COUNT = SWIM_IO_BATCH + 8 };
+    for (uint8_t i = 0; i < COUNT; i++) {
+        uint8_t payload[100];
+        memset(payload, i, sizeof(payload));
+        swim_transport_send(a->transport, &to, payload, sizeof(payload) - i);
+    }
+    swim_transport_flush(a->transport);
+    sleep_ms(50);
+    
+    int received = 0;
+    uint32_t n;
+    const swim_io_rx_t *batch;
+    while ((n = swim_transport_recv(b->transport, &batch)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            const swim_io_rx_t *rx = &batch[i];
+            if (rx->len != 100u - (size_t)received || rx->data[0] != (uint8_t)received) {
+                swim_destroy(a);
+                swim_destroy(b);
+                TEST_FAIL("Datagram lost, reordered or corrupted");
+            }
+            received++;
+        }
+    }
+    
+    int ok = received == COUNT && a->transport->tx_datagrams == COUNT && a->transport->tx_calls <= COUNT;
+    swim_destroy(a);
+    swim_destroy(b);
+    if (!ok) {
+        TEST_FAIL("Datagram count mismatch");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test PINGs are answered on arrival, not after the sender's next sleep
+ */
+int test_ack_latency(void) {
+    printf("Testing event-driven ACK latency...\n");
+    
+    swim_context_t *a = swim_init("latency-a", 7959, 500);
+    swim_context_t *b = swim_init("latency-b", 7960, 500);
+    if (!a || !b) {
+        swim_destroy(a);
+        swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_join(b, "127.0.0.1", 7959);
+    
+    swim_stats_t stats = {0};
+    for (int i = 0; i < 100 && stats.ack_samples < 3; i++) {
+        sleep_ms(50);
+        swim_get_detailed_stats(b, &stats);
+    }
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    if (stats.ack_samples < 3) {
+        TEST_FAIL("No ACKs received");
+    }
+    
+    // Loopback RTT is tens of us; anything near the 500 ms period means polling
+    printf("  ACK RTT avg %.0f us, max %llu us\n",
+           stats.ack_rtt_avg_us, (unsigned long long)stats.ack_rtt_max_us);
+    if (stats.ack_rtt_avg_us > 20000.0) {
+        TEST_FAIL("ACK latency tied to the gossip interval");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test Lifeguard suspicion timeouts, phi-accrual grace and refutation
+ */
+int test_failure_detector(void) {
+    printf("Testing failure detector...\n");
+    
+    // Suspicion timeout starts long and shrinks with each confirmation
+    swim_detector_t det;
+    swim_detector_init(&det, SWIM_DETECTOR_LIFEGUARD, 500, 5000);
+    uint32_t t0 = swim_detector_suspect_timeout(&det, 5, 0);
+    uint32_t t1 = swim_detector_suspect_timeout(&det, 5, 1);
+    uint32_t t3 = swim_detector_suspect_timeout(&det, 5, 3);
+    if (t0 != 5000 * SWIM_LIFEGUARD_MAX_MULT || !(t1 < t0) || t3 != 5000) {
+        TEST_FAIL("Lifeguard suspicion timeout not shrinking to the minimum");
+    }
+    
+    // Phi keeps a probe open only while the delay fits the member's history
+    swim_node_t slow;
+    memset(&slow, 0, sizeof(slow));
+    swim_detector_init(&det, SWIM_DETECTOR_PHI, 500, 5000);
+    if (swim_detector_grace(&det, &slow, 1000) != 0) {
+        TEST_FAIL("Phi waited without ACK history");
+    }
+    for (int i = 0; i < 8; i++) {
+        swim_detector_record_ack(&slow.detector, 900.0 + (i % 2) * 200.0);
+    }
+    if (swim_detector_grace(&det, &slow, 1000) == 0 ||
+        swim_detector_grace(&det, &slow, 3000) != 0) {
+        TEST_FAIL("Phi grace does not follow ACK delay history");
+    }
+    
+    // A suspicion of ourselves is refuted; a second accuser confirms another's
+    swim_context_t *a = swim_init("detector-a", 7961, 1000);
+    swim_context_t *b = swim_init("detector-b", 7962, 1000);
+    if (!a || !b) {
+        swim_destroy(a);
+        swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    uint8_t buf[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    swim_wire_update_t update = {0};
+    
+    header.type = SWIM_MSG_SYNC;
+    header.seq_num = 1;
+    header.incarnation = 1;
+    strcpy(header.sender_id, "detector-b");
+    swim_wire_writer_init(&w, buf, sizeof(buf));
+    swim_wire_write_header(&w, &header);
+    
+    strcpy(update.address, "127.0.0.1");
+    update.port = 7963;
+    update.state = NODE_STATE_SUSPECT;
+    update.incarnation = 1;
+    strcpy(update.id, "detector-a");
+    strcpy(update.accuser, "detector-b");
+    swim_wire_write_update(&w, &update);
+    strcpy(update.id, "detector-c");
+    swim_wire_write_update(&w, &update);
+    strcpy(update.accuser, "detector-d");
+    swim_wire_write_update(&w, &update);
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(7961);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    swim_transport_send(b->transport, &to, buf, w.len);
+    swim_transport_flush(b->transport);
+    sleep_ms(50);
+    swim_process(a);
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(a, &stats);
+    swim_node_t *c = swim_find_node(a, "detector-c");
+    int refuted = swim_get_local_node(a)->incarnation == 2 && stats.self_refutes == 1 &&
+                  stats.local_health == 1;
+    int confirmed = c && c->state == NODE_STATE_SUSPECT && c->detector.confirmations == 1;
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    if (!refuted) {
+        TEST_FAIL("Suspicion of the local node not refuted");
+    }
+    if (!confirmed) {
+        TEST_FAIL("Independent accuser not counted as a confirmation");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Count transitions of indirect-c away from ALIVE
+ */
+static void on_indirect_event(const swim_member_t *member, swim_node_state_t old_state,
+                              swim_node_state_t new_state, void *user_data) {
+    (void)old_state;
+    if (new_state != NODE_STATE_ALIVE && strcmp(member->id, "indirect-c") == 0) {
+        (*(int*)user_data)++;
+    }
+}
+
+/**
+ * Test a member behind one broken link is reached through a helper
+ */
+int test_indirect_probe(void) {
+    printf("Testing indirect probing...\n");
+    
+    swim_context_t *a = swim_init("indirect-a", 7964, 50);
+    swim_context_t *b = swim_init("indirect-b", 7965, 50);
+    swim_context_t *c = swim_init("indirect-c", 7966, 50);
+    if (!a || !b || !c) {
+        swim_destroy(a);
+        swim_destroy(b);
+        swim_destroy(c);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_start(c);
+    swim_join(b, "127.0.0.1", 7964);
+    swim_join(c, "127.0.0.1", 7964);
+    
+    swim_node_t *c_at_a = NULL;
+    for (int i = 0; i < 40 && (!c_at_a || !swim_find_node(c, "indirect-b")); i++) {
+        sleep_ms(50);
+        c_at_a = swim_find_node(a, "indirect-c");
+    }
+    if (!c_at_a) {
+        swim_destroy(c);
+        swim_destroy(b);
+        swim_destroy(a);
+        TEST_FAIL("Membership did not converge");
+    }
+    
+    // Break the a <-> c link in both directions: a sends everything for c to a dead port
+    int c_suspected = 0;
+    swim_set_node_callback(a, on_indirect_event, &c_suspected);
+    c_at_a->port = 7967;
+    sleep_ms(2000);
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(a, &stats);
+    swim_node_state_t c_state = c_at_a->state;
+    
+    swim_destroy(c);
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    printf("  %llu PING_REQs, %llu probes answered through a helper\n",
+           (unsigned long long)stats.indirect_probes, (unsigned long long)stats.indirect_acks);
+    if (stats.indirect_acks == 0) {
+        TEST_FAIL("No ACK relayed back to the requester");
+    }
+    if (c_state != NODE_STATE_ALIVE || c_suspected != 0) {
+        TEST_FAIL("Lossy link caused a suspicion");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Teach the context on port about count members named prefix-N, one page
+ * of SYNC updates per datagram, each with its own seq
+ */
+static void send_members(swim_transport_t *from, const char *sender, uint16_t port,
+                         const char *prefix, int count) {
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    uint32_t seq = 1;
+    for (int i = 0; i < count; ) {
+        uint8_t buf[SWIM_MAX_DATAGRAM];
+        swim_wire_writer_t w;
+        swim_wire_header_t header = {0};
+        header.type = SWIM_MSG_SYNC;
+        header.seq_num = seq++;
+        header.incarnation = 1;
+        strcpy(header.sender_id, sender);
+        swim_wire_writer_init(&w, buf, sizeof(buf));
+        swim_wire_write_header(&w, &header);
+        
+        for (; i < count; i++) {
+            swim_wire_update_t update = {0};
+            snprintf(update.id, sizeof(update.id), "%s-%d", prefix, i);
+            strcpy(update.address, "127.0.0.1");
+            update.port = 7970;
+            update.state = NODE_STATE_ALIVE;
+            update.incarnation = 1;
+            if (swim_wire_write_update(&w, &update) != 0) break;
+        }
+        swim_transport_send(from, &to, buf, w.len);
+        swim_transport_flush(from);
+        sleep_ms(5);
+    }
+}
+
+/**
+ * Test push-pull anti-entropy converges membership far beyond one SYNC
+ * datagram. Over plain UDP transports there is no bootstrap listener, so
+ * the join falls back to the UDP path and the state arrives in pages.
+ */
+int test_anti_entropy(void) {
+    printf("Testing push-pull anti-entropy...\n");
+    
+    enum { MEMBERS = 400 };
+    swim_context_t *a = swim_init_transport("entropy-a", 7968, 50, swim_transport_udp(7968));
+    swim_context_t *b = swim_init_transport("entropy-b", 7969, 50, swim_transport_udp(7969));
+    if (!a || !b) {
+        swim_destroy(a);
+        swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    // Teach a about MEMBERS others, one page of updates per datagram
+    send_members(b->transport, "entropy-b", 7968, "entropy-member", MEMBERS);
+    swim_process(a);
+    
+    uint32_t known_a = a->node_count;
+    swim_start(a);
+    swim_start(b);
+    swim_join(b, "127.0.0.1", 7968);
+    
+    for (int i = 0; i < 60 && b->node_count < known_a; i++) {
+        sleep_ms(50);
+    }
+    
+    swim_stats_t stats, joiner;
+    swim_get_detailed_stats(a, &stats);
+    swim_get_detailed_stats(b, &joiner);
+    uint32_t known_b = b->node_count;
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    printf("  %u of %u members after join, %llu SYNC pages\n",
+           known_b, known_a, (unsigned long long)stats.sync_pages);
+    if (known_a < MEMBERS) {
+        TEST_FAIL("Seed did not learn injected members");
+    }
+    if (joiner.bootstrap_joins != 0) {
+        TEST_FAIL("Join used the bootstrap exchange");
+    }
+    if (stats.sync_pages < 2) {
+        TEST_FAIL("State not sent as several SYNC pages");
+    }
+    if (known_b < known_a) {
+        TEST_FAIL("Joiner did not converge");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Encode a DIGEST of count buckets from sender
+ */
+static size_t encode_digest(uint8_t *buf, size_t cap, const char *sender, uint32_t seq,
+                            const uint32_t *buckets, uint32_t count) {
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    header.type = SWIM_MSG_DIGEST;
+    header.seq_num = seq;
+    header.incarnation = 1;
+    strcpy(header.sender_id, sender);
+    swim_wire_writer_init(&w, buf, cap);
+    swim_wire_write_header(&w, &header);
+    swim_wire_write_digest(&w, buckets, count);
+    return w.len;
+}
+
+typedef void (*message_fn)(const swim_wire_header_t *header, swim_wire_reader_t *body, void *arg);
+
+/**
+ * Receive replies to peer and pass each message to fn
+ * @return Datagrams received, or -1 on an oversized or malformed one
+ */
+static int drain_messages(swim_transport_t *peer, uint32_t mtu, message_fn fn, void *arg) {
+    int datagrams = 0;
+    uint32_t n;
+    const swim_io_rx_t *batch;
+    
+    while ((n = swim_transport_recv(peer, &batch)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            swim_wire_reader_t r, part_reader;
+            swim_wire_header_t header;
+            const uint8_t *part;
+            size_t part_len;
+            int rc;
+            
+            if (batch[i].len > mtu) return -1;
+            datagrams++;
+            swim_wire_reader_init(&r, batch[i].data, batch[i].len);
+            if (swim_wire_read_compound(&r) != 0) {
+                if (swim_wire_read_header(&r, &header) != 0) return -1;
+                fn(&header, &r, arg);
+                continue;
+            }
+            while ((rc = swim_wire_read_part(&r, &part, &part_len)) > 0) {
+                swim_wire_reader_init(&part_reader, part, part_len);
+                if (swim_wire_read_header(&part_reader, &header) != 0) return -1;
+                fn(&header, &part_reader, arg);
+            }
+            if (rc < 0) return -1;
+        }
+    }
+    return datagrams;
+}
+
+typedef struct {
+    int sync_pages;
+    int digest_buckets;         // Of the last DIGEST_REPLY, -1 if none or malformed
+} digest_replies_t;
+
+static void on_digest_reply(const swim_wire_header_t *header, swim_wire_reader_t *body, void *arg) {
+    digest_replies_t *replies = (digest_replies_t*)arg;
+    uint32_t buckets[SWIM_SYNC_BUCKETS];
+    
+    if (header->type == SWIM_MSG_SYNC) {
+        replies->sync_pages++;
+    } else if (header->type == SWIM_MSG_DIGEST_REPLY) {
+        replies->digest_buckets = swim_wire_read_digest(body, buckets, SWIM_SYNC_BUCKETS);
+    }
+}
+
+/**
+ * Test digests stay within a small MTU by folding, and folded digests are
+ * answered at their own resolution
+ */
+int test_digest_mtu(void) {
+    printf("Testing digest folding...\n");
+    
+    swim_context_t *node = swim_init("digest-node", 8232, 1000);
+    swim_transport_t *peer = swim_transport_udp(8233);
+    if (!node || !peer) {
+        swim_destroy(node);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create node and peer");
+    }
+    swim_set_mtu(node, SWIM_MTU_MIN);
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(8232);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // An empty full-size digest: the node sends itself and its folded digest
+    uint32_t empty[SWIM_SYNC_BUCKETS] = {0};
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    size_t len = encode_digest(msg, sizeof(msg), "digest-peer", 1, empty, SWIM_SYNC_BUCKETS);
+    swim_transport_send(peer, &to, msg, len);
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(node);
+    sleep_ms(20);
+    
+    digest_replies_t full = { 0, -1 };
+    int datagrams = drain_messages(peer, SWIM_MTU_MIN, on_digest_reply, &full);
+    
+    // A folded digest is compared at 64 buckets
+    digest_replies_t folded = { 0, -1 };
+    if (datagrams > 0) {
+        len = encode_digest(msg, sizeof(msg), "digest-peer", 2, empty, 64);
+        swim_transport_send(peer, &to, msg, len);
+        swim_transport_flush(peer);
+        sleep_ms(20);
+        swim_process(node);
+        sleep_ms(20);
+        datagrams = drain_messages(peer, SWIM_MTU_MIN, on_digest_reply, &folded);
+    }
+    
+    swim_destroy(node);
+    swim_transport_close(peer);
+    
+    printf("  DIGEST_REPLY of %d buckets within %d bytes\n", full.digest_buckets, SWIM_MTU_MIN);
+    if (datagrams <= 0) {
+        TEST_FAIL("Reply lost, oversized or malformed");
+    }
+    if (full.sync_pages != 1 || full.digest_buckets <= 0 || full.digest_buckets >= SWIM_SYNC_BUCKETS ||
+        (full.digest_buckets & (full.digest_buckets - 1)) != 0) {
+        TEST_FAIL("Digest not folded to fit the MTU");
+    }
+    if (folded.sync_pages != 1 || folded.digest_buckets != full.digest_buckets) {
+        TEST_FAIL("Folded digest not answered");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+static int epoch_freed;
+
+static void count_free(void *ptr) {
+    epoch_freed++;
+    free(ptr);
+}
+
+/**
+ * Test snapshots stay intact while pinned and are reclaimed afterwards
+ */
+int test_membership_snapshot(void) {
+    printf("Testing membership snapshots...\n");
+    
+    // Reclamation waits for the pinned reader, not for later ones
+    swim_epoch_t epoch;
+    swim_epoch_guard_t early, late;
+    swim_epoch_init(&epoch);
+    swim_epoch_enter(&epoch, &early);
+    swim_epoch_retire(&epoch, malloc(16), count_free);
+    swim_epoch_enter(&epoch, &late);
+    swim_epoch_reclaim(&epoch);
+    int held = epoch_freed == 0;
+    swim_epoch_exit(&epoch, &early);
+    swim_epoch_reclaim(&epoch);
+    int freed = epoch_freed == 1;
+    swim_epoch_exit(&epoch, &late);
+    swim_epoch_destroy(&epoch);
+    if (!held || !freed) {
+        TEST_FAIL("Epoch reclamation freed too early or never");
+    }
+    
+    swim_context_t *ctx = swim_init("snapshot-node", 7971, 1000);
+    if (!ctx) {
+        TEST_FAIL("Failed to create SWIM context");
+    }
+    
+    swim_epoch_guard_t guard;
+    const swim_membership_t *before = swim_membership_acquire(ctx, &guard);
+    const swim_member_t *self = swim_membership_find(before, "snapshot-node");
+    if (!before || before->count != 1 || !self || !self->is_local || self->is_main_node) {
+        swim_membership_release(ctx, &guard);
+        swim_destroy(ctx);
+        TEST_FAIL("Initial snapshot wrong");
+    }
+    uint64_t version = before->version;
+    
+    // A change publishes a new version; the pinned one is left untouched
+    swim_set_main_node(ctx, true);
+    swim_epoch_guard_t guard2;
+    const swim_membership_t *after = swim_membership_acquire(ctx, &guard2);
+    const swim_member_t *self_after = swim_membership_find(after, "snapshot-node");
+    int ok = after != before && after->version > version && self_after && self_after->is_main_node &&
+             !self->is_main_node && before->version == version &&
+             swim_membership_find(after, "no-such-node") == NULL;
+    swim_membership_release(ctx, &guard2);
+    swim_membership_release(ctx, &guard);
+    
+    swim_destroy(ctx);
+    if (!ok) {
+        TEST_FAIL("Snapshot not versioned or not immutable");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Send one SYNC datagram carrying updates from one context to another's port
+ */
+static void send_sync_updates(swim_context_t *from, uint16_t port,
+                              const swim_wire_update_t *updates, int count) {
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    uint8_t buf[SWIM_MAX_DATAGRAM];
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    header.type = SWIM_MSG_SYNC;
+    header.seq_num = ++from->seq_num;
+    header.incarnation = 1;
+    strcpy(header.sender_id, from->local_id);
+    swim_wire_writer_init(&w, buf, sizeof(buf));
+    swim_wire_write_header(&w, &header);
+    for (int i = 0; i < count; i++) {
+        swim_wire_write_update(&w, &updates[i]);
+    }
+    swim_transport_send(from->transport, &to, buf, w.len);
+    swim_transport_flush(from->transport);
+}
+
+/**
+ * Build a member update for the event queue test
+ */
+static swim_wire_update_t event_update(const char *id, swim_node_state_t state, uint32_t incarnation) {
+    swim_wire_update_t update = {0};
+    strcpy(update.id, id);
+    strcpy(update.address, "127.0.0.1");
+    update.port = 7974;
+    update.state = state;
+    update.incarnation = incarnation;
+    return update;
+}
+
+/**
+ * Look up an event about member id in a batch
+ */
+static const swim_event_t* find_event(const swim_event_batch_t *batch, const char *id) {
+    for (uint32_t i = 0; i < batch->count; i++) {
+        if (strcmp(batch->events[i].member.id, id) == 0) return &batch->events[i];
+    }
+    return NULL;
+}
+
+static int events_delivered;
+
+/**
+ * Calls back into the API, which deadlocked while callbacks ran under the lock
+ */
+static void on_queued_event(const swim_member_t *member, swim_node_state_t old_state,
+                            swim_node_state_t new_state, void *user_data) {
+    (void)old_state;
+    (void)new_state;
+    if (swim_find_node((swim_context_t*)user_data, member->id)) {
+        events_delivered++;
+    }
+}
+
+/**
+ * Test membership events are coalesced, versioned and delivered outside the lock
+ */
+int test_event_queue(void) {
+    printf("Testing membership event queue...\n");
+    
+    swim_context_t *a = swim_init("events-a", 7972, 1000);
+    swim_context_t *b = swim_init("events-b", 7973, 1000);
+    if (!a || !b) {
+        swim_destroy(a);
+        swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_wire_update_t joins[2] = {
+        event_update("events-x", NODE_STATE_ALIVE, 1),
+        event_update("events-y", NODE_STATE_ALIVE, 1)
+    };
+    send_sync_updates(b, 7972, joins, 2);
+    sleep_ms(20);
+    swim_process(a);
+    
+    swim_event_batch_t first;
+    swim_poll_events(a, &first);
+    const swim_event_t *x_joined = find_event(&first, "events-x");
+    int joined = x_joined && x_joined->old_state == NODE_STATE_DEAD &&
+                 x_joined->new_state == NODE_STATE_ALIVE && find_event(&first, "events-y");
+    
+    // x flaps SUSPECT -> ALIVE (cancels out), y dies
+    swim_wire_update_t changes[3] = {
+        event_update("events-x", NODE_STATE_SUSPECT, 1),
+        event_update("events-x", NODE_STATE_ALIVE, 2),
+        event_update("events-y", NODE_STATE_DEAD, 1)
+    };
+    send_sync_updates(b, 7972, changes, 3);
+    sleep_ms(20);
+    swim_process(a);
+    
+    swim_event_batch_t second;
+    swim_poll_events(a, &second);
+    const swim_event_t *y_died = find_event(&second, "events-y");
+    int coalesced = !find_event(&second, "events-x") && y_died &&
+                    y_died->old_state == NODE_STATE_ALIVE && y_died->new_state == NODE_STATE_DEAD &&
+                    second.version > first.version && !second.overflow;
+    
+    // With a callback set, swim_process delivers after unlocking
+    swim_set_node_callback(a, on_queued_event, a);
+    swim_wire_update_t revive = event_update("events-y", NODE_STATE_ALIVE, 2);
+    send_sync_updates(b, 7972, &revive, 1);
+    sleep_ms(20);
+    swim_process(a);
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(a, &stats);
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    printf("  %llu queued, %llu coalesced, %llu dropped\n",
+           (unsigned long long)stats.events_queued, (unsigned long long)stats.events_coalesced,
+           (unsigned long long)stats.events_dropped);
+    if (!joined) {
+        TEST_FAIL("Join events missing");
+    }
+    if (!coalesced) {
+        TEST_FAIL("Flap not coalesced or batch version not increasing");
+    }
+    if (events_delivered != 1) {
+        TEST_FAIL("Callback not delivered outside the lock");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test per-member RTT estimation and adaptive probe timeouts
+ */
+int test_rtt_tracking(void) {
+    printf("Testing RTT tracking...\n");
+    
+    // Steady 2 ms round trips converge to a tight timeout; a slow member gets a long one
+    swim_rtt_t near, far;
+    memset(&near, 0, sizeof(near));
+    memset(&far, 0, sizeof(far));
+    if (swim_rtt_timeout_ms(&near, 500) != 500) {
+        TEST_FAIL("Timeout without samples should be the configured one");
+    }
+    for (int i = 0; i < 40; i++) {
+        swim_rtt_sample(&near, 2000);
+        swim_rtt_sample(&far, 300000 + (i % 4) * 50000);
+    }
+    uint32_t near_timeout = swim_rtt_timeout_ms(&near, 500);
+    uint32_t far_timeout = swim_rtt_timeout_ms(&far, 500);
+    if (near_timeout != SWIM_RTT_MIN_TIMEOUT_MS || far_timeout <= 450 || far_timeout > 2000) {
+        TEST_FAIL("Adaptive timeouts not derived from RTT");
+    }
+    if (swim_rtt_percentile_us(&far, 50) != 350000 || swim_rtt_percentile_us(&far, 99) != 450000) {
+        TEST_FAIL("RTT percentiles wrong");
+    }
+    
+    swim_context_t *a = swim_init("rtt-a", 7975, 50);
+    swim_context_t *b = swim_init("rtt-b", 7976, 50);
+    if (!a || !b) {
+        swim_destroy(a);
+        swim_destroy(b);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_join(b, "127.0.0.1", 7975);
+    
+    swim_rtt_stats_t rtt = {0};
+    for (int i = 0; i < 100 && rtt.samples < SWIM_RTT_MIN_SAMPLES; i++) {
+        sleep_ms(20);
+        swim_get_node_rtt(a, "rtt-b", &rtt);
+    }
+    
+    swim_rtt_stats_t table[4];
+    uint32_t rows = swim_get_rtt_stats(a, table, 4);
+    int unknown = swim_get_node_rtt(a, "no-such-node", &rtt) != 0;
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    printf("  %u samples, srtt %.3f ms, p99 %.3f ms, timeout %u ms\n",
+           rtt.samples, rtt.srtt_ms, rtt.p99_ms, rtt.probe_timeout_ms);
+    if (rtt.samples < SWIM_RTT_MIN_SAMPLES || rows < 1 || strcmp(table[0].id, "rtt-b") != 0 || !unknown) {
+        TEST_FAIL("RTT statistics not collected");
+    }
+    if (rtt.probe_timeout_ms >= SWIM_PROBE_TIMEOUT || rtt.p50_ms > rtt.p99_ms) {
+        TEST_FAIL("Loopback member kept the configured probe timeout");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test Vivaldi coordinates predict RTTs and find the nearest members
+ */
+int test_network_coordinates(void) {
+    printf("Testing network coordinates...\n");
+    
+    // Two racks, 1 ms inside a rack and 40 ms across; nodes only ever see sampled pairs
+    enum { NODES = 8 };
+    swim_coord_t coords[NODES];
+    swim_rand_t rng;
+    swim_rand_seed(&rng, 42);
+    for (int i = 0; i < NODES; i++) swim_coord_init(&coords[i]);
+    
+    for (int round = 0; round < 2000; round++) {
+        int i = (int)swim_rand_below(&rng, NODES);
+        int j = (int)swim_rand_below(&rng, NODES);
+        if (i == j) continue;
+        double rtt = (i < NODES / 2) == (j < NODES / 2) ? 1.0 : 40.0;
+        swim_coord_update(&coords[i], &coords[j], rtt, swim_rand_next(&rng));
+    }
+    
+    double same = swim_coord_distance_ms(&coords[0], &coords[1]);
+    double cross = swim_coord_distance_ms(&coords[0], &coords[NODES - 1]);
+    printf("  simulated: same rack %.2f ms, cross rack %.2f ms, error %.3f\n",
+           same, cross, coords[0].error);
+    if (same > 5.0 || cross < 30.0 || cross > 50.0 || coords[0].error > 0.5f) {
+        TEST_FAIL("Coordinates did not converge");
+    }
+    
+    // Garbage from the wire is rejected without moving the coordinate
+    swim_coord_t bad = coords[1];
+    bad.vec[0] = NAN;
+    swim_coord_t before = coords[0];
+    if (swim_coord_update(&coords[0], &bad, 1.0, 0) || memcmp(&before, &coords[0], sizeof(before)) != 0) {
+        TEST_FAIL("Invalid remote coordinate accepted");
+    }
+    
+    // Coordinates ride on PING/ACK between live nodes
+    swim_context_t *a = swim_init("coord-a", 7977, 50);
+    swim_context_t *b = swim_init("coord-b", 7978, 50);
+    swim_context_t *c = swim_init("coord-c", 7979, 50);
+    if (!a || !b || !c) {
+        swim_destroy(a);
+        swim_destroy(b);
+        swim_destroy(c);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_start(c);
+    swim_join(b, "127.0.0.1", 7977);
+    swim_join(c, "127.0.0.1", 7977);
+    
+    swim_stats_t stats = {0};
+    for (int i = 0; i < 100 && (stats.coord_updates < 5 || swim_estimate_rtt(a, "coord-b", "coord-c") < 0); i++) {
+        sleep_ms(20);
+        swim_get_detailed_stats(a, &stats);
+    }
+    
+    double b_to_c = swim_estimate_rtt(a, "coord-b", "coord-c");
+    swim_neighbor_t near[4];
+    uint32_t found = swim_nearest_nodes(a, NULL, 4, near);
+    uint32_t one = swim_nearest_nodes(a, "coord-b", 1, near + 3);
+    int sorted = found < 2 || near[0].rtt_ms <= near[1].rtt_ms;
+    int unknown = swim_estimate_rtt(a, "coord-a", "no-such-node") < 0;
+    
+    swim_destroy(c);
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    printf("  live: %llu updates, b<->c %.3f ms, %u nearest\n",
+           (unsigned long long)stats.coord_updates, b_to_c, found);
+    if (stats.coord_updates == 0 || b_to_c < 0 || !unknown) {
+        TEST_FAIL("Coordinates not exchanged");
+    }
+    if (found < 2 || !sorted || one != 1 || strcmp(near[3].member.id, "coord-b") == 0) {
+        TEST_FAIL("Nearest members wrong");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Count (observer, member) pairs where observer sees member in state
+ */
+static uint32_t sim_count_state(swim_context_t **nodes, int count, const bool *skip,
+                                swim_node_state_t state) {
+    uint32_t pairs = 0;
+    for (int i = 0; i < count; i++) {
+        if (skip && skip[i]) continue;
+        swim_epoch_guard_t guard;
+        const swim_membership_t *m = swim_membership_acquire(nodes[i], &guard);
+        for (int j = 0; j < count; j++) {
+            const swim_member_t *member = swim_membership_find(m, nodes[j]->local_id);
+            if (i != j && member && member->state == state) pairs++;
+        }
+        swim_membership_release(nodes[i], &guard);
+    }
+    return pairs;
+}
+
+/**
+ * Run a simulated cluster through join, crash and partition; returns the
+ * total bytes sent so runs can be compared
+ */
+static uint64_t run_simulated_cluster(uint64_t seed, uint64_t *converge_ms, uint64_t *detect_ms,
+                                      uint64_t *partition_drops, bool *healed) {
+    enum { NODES = 32, CRASHED = 5 };
+    swim_sim_t *sim = swim_sim_create(seed);
+    swim_sim_set_network(sim, 500, 300, 0.01);
+    
+    swim_context_t *nodes[NODES];
+    bool skip[NODES] = {0};
+    for (int i = 0; i < NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "sim-%02d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(1000 + i), 100);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 1000);
+    }
+    
+    const uint32_t all_pairs = NODES * (NODES - 1);
+    *converge_ms = 0;
+    while (swim_sim_now_ms(sim) < 30000 && sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) < all_pairs) {
+        swim_sim_run(sim, 100);
+    }
+    *converge_ms = swim_sim_now_ms(sim);
+    
+    // Every survivor must see the crashed node DEAD
+    uint64_t crash_at = swim_sim_now_ms(sim);
+    swim_sim_crash(sim, 1000 + CRASHED);
+    skip[CRASHED] = true;
+    while (swim_sim_now_ms(sim) - crash_at < 60000) {
+        swim_sim_run(sim, 100);
+        uint32_t seen = 0;
+        for (int i = 0; i < NODES; i++) {
+            if (skip[i]) continue;
+            swim_epoch_guard_t guard;
+            const swim_membership_t *m = swim_membership_acquire(nodes[i], &guard);
+            const swim_member_t *member = swim_membership_find(m, "sim-05");
+            if (member && member->state == NODE_STATE_DEAD) seen++;
+            swim_membership_release(nodes[i], &guard);
+        }
+        if (seen == NODES - 1) break;
+    }
+    *detect_ms = swim_sim_now_ms(sim) - crash_at;
+    
+    // Split the survivors in two for a moment, then heal and let refutation repair it
+    for (int i = 0; i < NODES; i++) {
+        if (i % 2) swim_sim_set_partition(sim, (uint16_t)(1000 + i), 1);
+    }
+    swim_sim_run(sim, 1000);
+    swim_sim_heal(sim);
+    
+    const uint32_t survivor_pairs = (NODES - 1) * (NODES - 2);
+    for (int i = 0; i < 600 && sim_count_state(nodes, NODES, skip, NODE_STATE_ALIVE) < survivor_pairs; i++) {
+        swim_sim_run(sim, 100);
+    }
+    *healed = sim_count_state(nodes, NODES, skip, NODE_STATE_ALIVE) == survivor_pairs;
+    
+    swim_sim_stats_t stats;
+    swim_sim_get_stats(sim, &stats);
+    *partition_drops = stats.dropped_partition;
+    swim_sim_destroy(sim);
+    return stats.bytes_sent;
+}
+
+/**
+ * Test the in-memory transport: no sockets, virtual clock, reproducible
+ */
+int test_simulated_network(void) {
+    printf("Testing simulated network...\n");
+    
+    uint64_t converge_ms, detect_ms, partition_drops;
+    bool healed;
+    uint64_t bytes = run_simulated_cluster(7, &converge_ms, &detect_ms, &partition_drops, &healed);
+    
+    printf("  32 nodes: converged at %llu ms, crash detected by all in %llu ms, %llu KB sent\n",
+           (unsigned long long)converge_ms, (unsigned long long)detect_ms,
+           (unsigned long long)(bytes / 1024));
+    if (converge_ms >= 30000) {
+        TEST_FAIL("Simulated cluster did not converge");
+    }
+    if (detect_ms >= 60000) {
+        TEST_FAIL("Crash not detected");
+    }
+    if (partition_drops == 0 || !healed) {
+        TEST_FAIL("Partition not applied or not repaired");
+    }
+    
+    uint64_t converge2, detect2, drops2;
+    bool healed2;
+    if (run_simulated_cluster(7, &converge2, &detect2, &drops2, &healed2) != bytes ||
+        converge2 != converge_ms || detect2 != detect_ms) {
+        TEST_FAIL("Same seed gave a different run");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Count deliveries per node; checks the payload and origin
+ */
+static void count_user_message(swim_node_t *from, const uint8_t *payload, size_t len, void *user_data) {
+    int *count = (int*)user_data;
+    if (from && len == 6 && memcmp(payload, "hello", 6) == 0) (*count)++;
+}
+
+/**
+ * Count members seen joining
+ */
+static void count_join(const swim_member_t *member, swim_node_state_t old_state,
+                       swim_node_state_t new_state, void *user_data) {
+    (void)member;
+    if (old_state != NODE_STATE_ALIVE && new_state == NODE_STATE_ALIVE) (*(int*)user_data)++;
+}
+
+/**
+ * Test user messages reach on_message exactly once, by unicast and by gossip
+ */
+int test_user_messages(void) {
+    printf("Testing user message broadcast...\n");
+    
+    enum { NODES = 64 };
+    swim_sim_t *sim = swim_sim_create(11);
+    swim_sim_set_network(sim, 1000, 0, 0);
+    
+    swim_context_t *nodes[NODES];
+    int delivered[NODES] = {0};
+    int joins = 0;
+    for (int i = 0; i < NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "user-%02d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(2000 + i), 100);
+        // Each callback keeps its own user_data
+        if (i == 0) swim_set_node_callback(nodes[i], count_join, &joins);
+        swim_set_message_callback(nodes[i], count_user_message, &delivered[i]);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 2000);
+    }
+    while (swim_sim_now_ms(sim) < 30000 &&
+           sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) < NODES * (NODES - 1)) {
+        swim_sim_run(sim, 100);
+    }
+    
+    const char *error = NULL;
+    if (joins < NODES - 1) {
+        error = "Node callback lost its user_data";
+    }
+    
+    // Unicast to every member: one datagram each, one delivery each
+    int direct = swim_broadcast(nodes[3], (const uint8_t*)"hello", 6);
+    swim_sim_run(sim, 20);
+    for (int i = 0; i < NODES && !error; i++) {
+        if (delivered[i] != (i == 3 ? 0 : 1)) error = "Unicast broadcast not delivered exactly once";
+    }
+    if (!error && direct != NODES - 1) {
+        error = "Unicast broadcast did not reach every member";
+    }
+    
+    // Gossip: the origin sends fanout copies; every member still gets it once
+    memset(delivered, 0, sizeof(delivered));
+    for (int i = 0; i < NODES; i++) swim_set_broadcast_fanout(nodes[i], 8);
+    int gossip = swim_broadcast(nodes[5], (const uint8_t*)"hello", 6);
+    uint64_t start = swim_sim_now_ms(sim);
+    int reached = 0;
+    while (!error && reached < NODES - 1 && swim_sim_now_ms(sim) - start < 100) {
+        swim_sim_run(sim, 1);
+        reached = 0;
+        for (int i = 0; i < NODES; i++) reached += delivered[i] > 0;
+    }
+    uint64_t spread_ms = swim_sim_now_ms(sim) - start;
+    swim_sim_run(sim, 50);
+    
+    uint64_t forwarded = 0, duplicates = 0;
+    for (int i = 0; i < NODES; i++) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[i], &stats);
+        forwarded += stats.user_forwarded;
+        duplicates += stats.user_duplicates;
+        if (!error && delivered[i] != (i == 5 ? 0 : 1)) error = "Gossip broadcast not delivered exactly once";
+    }
+    printf("  gossip: origin sent %d, all %d reached in %llu ms, %llu forwards, %llu duplicates dropped\n",
+           gossip, NODES - 1, (unsigned long long)spread_ms, (unsigned long long)forwarded,
+           (unsigned long long)duplicates);
+    if (!error && gossip != 8) {
+        error = "Gossip origin did not send to its fanout";
+    }
+    if (!error && spread_ms > 10) {
+        error = "Gossip did not spread in O(log n) hops";
+    }
+    
+    // Point to point
+    memset(delivered, 0, sizeof(delivered));
+    if (!error && (swim_send_to(nodes[1], "user-02", (const uint8_t*)"hello", 6) != 0 ||
+                   swim_send_to(nodes[1], "no-such-node", (const uint8_t*)"hello", 6) != -1)) {
+        error = "swim_send_to result wrong";
+    }
+    swim_sim_run(sim, 20);
+    if (!error && (delivered[2] != 1 || delivered[1] != 0 || delivered[3] != 0)) {
+        error = "swim_send_to not delivered to its target only";
+    }
+    
+    // Payloads larger than the MTU are refused, not truncated
+    uint8_t big[SWIM_MAX_DATAGRAM] = {0};
+    if (!error && swim_broadcast(nodes[1], big, sizeof(big)) != -1) {
+        error = "Oversized broadcast accepted";
+    }
+    
+    swim_sim_destroy(sim);
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test a restarted origin's messages are not taken for the ones it sent
+ * before the restart
+ */
+int test_user_restart(void) {
+    printf("Testing user messages across an origin restart...\n");
+    
+    int delivered = 0;
+    swim_context_t *b = swim_init("restart-b", 8240, 50);
+    if (!b) {
+        TEST_FAIL("Failed to create SWIM context");
+    }
+    swim_set_message_callback(b, count_user_message, &delivered);
+    swim_start(b);
+    
+    // Same id and port both times, like a process restart
+    int sent = 0;
+    for (int run = 0; run < 2; run++) {
+        swim_context_t *a = swim_init("restart-a", 8241, 50);
+        if (!a) break;
+        swim_start(a);
+        swim_join(a, "127.0.0.1", 8240);
+        for (int i = 0; i < 40 && !swim_find_node(b, "restart-a"); i++) {
+            sleep_ms(10);
+        }
+        sent += swim_send_to(a, "restart-b", (const uint8_t*)"hello", 6) == 0;
+        for (int i = 0; i < 40 && delivered < sent; i++) {
+            sleep_ms(10);
+        }
+        swim_destroy(a);
+    }
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(b, &stats);
+    swim_destroy(b);
+    
+    printf("  %d of %d delivered, %llu dropped as duplicates\n", delivered, sent,
+           (unsigned long long)stats.user_duplicates);
+    if (sent != 2) {
+        TEST_FAIL("Message not sent");
+    }
+    if (delivered != 2 || stats.user_duplicates != 0) {
+        TEST_FAIL("Restarted origin's message dropped as a duplicate");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Encode a PING from sender to target
+ */
+static size_t encode_ping(uint8_t *buf, size_t cap, const char *sender, const char *target, uint32_t seq) {
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    header.type = SWIM_MSG_PING;
+    header.seq_num = seq;
+    header.incarnation = 1;
+    strcpy(header.sender_id, sender);
+    strcpy(header.target_id, target);
+    swim_wire_writer_init(&w, buf, cap);
+    swim_wire_write_header(&w, &header);
+    return w.len;
+}
+
+/**
+ * Encode a USER message from sender carrying "hello" from origin
+ */
+static size_t encode_user(uint8_t *buf, size_t cap, const char *sender, uint32_t seq,
+                          const char *origin, uint32_t origin_seq) {
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    header.type = SWIM_MSG_USER;
+    header.seq_num = seq;
+    header.incarnation = 1;
+    strcpy(header.sender_id, sender);
+    swim_wire_user_t user = {0};
+    strcpy(user.origin, origin);
+    user.origin_seq = origin_seq;
+    user.payload = (const uint8_t*)"hello";
+    user.len = 6;
+    swim_wire_writer_init(&w, buf, cap);
+    swim_wire_write_header(&w, &header);
+    swim_wire_write_user(&w, &user);
+    return w.len;
+}
+
+/**
+ * Test user message dedup tells apart origins whose id hashes collide
+ */
+int test_user_origin_collision(void) {
+    printf("Testing user messages from colliding origins...\n");
+    
+    // Different ids with the same 32-bit swim_hash_id
+    const char *first = "o-922a1bc8", *second = "o-678310dc";
+    if (swim_hash_id(first) != swim_hash_id(second)) {
+        TEST_FAIL("Ids do not collide");
+    }
+    
+    int delivered = 0;
+    swim_context_t *node = swim_init("collide-node", 8242, 1000);
+    swim_transport_t *peer = swim_transport_udp(8243);
+    if (!node || !peer) {
+        swim_destroy(node);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create node and peer");
+    }
+    swim_set_message_callback(node, count_user_message, &delivered);
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(8242);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // Same origin seq from both, then the first again: two delivered, one duplicate
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    size_t len = encode_ping(msg, sizeof(msg), "collide-peer", "collide-node", 1);
+    swim_transport_send(peer, &to, msg, len);
+    len = encode_user(msg, sizeof(msg), "collide-peer", 2, first, 7);
+    swim_transport_send(peer, &to, msg, len);
+    len = encode_user(msg, sizeof(msg), "collide-peer", 3, second, 7);
+    swim_transport_send(peer, &to, msg, len);
+    len = encode_user(msg, sizeof(msg), "collide-peer", 4, first, 7);
+    swim_transport_send(peer, &to, msg, len);
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(node);
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(node, &stats);
+    swim_transport_close(peer);
+    swim_destroy(node);
+    
+    printf("  %d delivered, %llu dropped as duplicates\n", delivered,
+           (unsigned long long)stats.user_duplicates);
+    if (delivered != 2 || stats.user_duplicates != 1) {
+        TEST_FAIL("Colliding origins treated as one");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Sum of user_duplicates over a cluster
+ */
+static uint64_t sim_duplicates(swim_context_t **nodes, int count) {
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[i], &stats);
+        total += stats.user_duplicates;
+    }
+    return total;
+}
+
+/**
+ * Test the broadcast tree delivers every message once, settles to few
+ * redundant copies, and routes around a failed member
+ */
+int test_broadcast_tree(void) {
+    printf("Testing broadcast tree...\n");
+    
+    enum { NODES = 64, WARMUP = 20, MEASURED = 10 };
+    swim_sim_t *sim = swim_sim_create(17);
+    swim_sim_set_network(sim, 1000, 200, 0);
+    
+    swim_context_t *nodes[NODES];
+    int delivered[NODES] = {0};
+    for (int i = 0; i < NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "tree-%02d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(4000 + i), 100);
+        swim_set_message_callback(nodes[i], count_user_message, &delivered[i]);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 4000);
+    }
+    while (swim_sim_now_ms(sim) < 30000 &&
+           sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) < NODES * (NODES - 1)) {
+        swim_sim_run(sim, 100);
+    }
+    for (int i = 0; i < NODES; i++) {
+        swim_set_broadcast_fanout(nodes[i], 4);
+        swim_set_broadcast_tree(nodes[i], true);
+    }
+    
+    const char *error = NULL;
+    
+    // Early broadcasts prune the random edges down to a tree
+    uint64_t first_duplicates = 0;
+    for (int m = 0; m < WARMUP && !error; m++) {
+        int origin = (m * 7) % NODES;
+        memset(delivered, 0, sizeof(delivered));
+        swim_broadcast(nodes[origin], (const uint8_t*)"hello", 6);
+        swim_sim_run(sim, 300);
+        if (m == 0) first_duplicates = sim_duplicates(nodes, NODES);
+        
+        for (int i = 0; i < NODES && !error; i++) {
+            if (delivered[i] != (i == origin ? 0 : 1)) error = "Tree broadcast not delivered exactly once";
+        }
+    }
+    uint64_t warm = sim_duplicates(nodes, NODES);
+    for (int m = 0; m < MEASURED && !error; m++) {
+        int origin = (m * 13 + 5) % NODES;
+        memset(delivered, 0, sizeof(delivered));
+        swim_broadcast(nodes[origin], (const uint8_t*)"hello", 6);
+        swim_sim_run(sim, 300);
+        for (int i = 0; i < NODES && !error; i++) {
+            if (delivered[i] != (i == origin ? 0 : 1)) error = "Tree broadcast not delivered exactly once";
+        }
+    }
+    double steady = (double)(sim_duplicates(nodes, NODES) - warm) / MEASURED;
+    
+    uint64_t ihaves = 0, grafts = 0, prunes = 0, edges = 0;
+    for (int i = 0; i < NODES; i++) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[i], &stats);
+        ihaves += stats.tree_ihave_sent;
+        grafts += stats.tree_graft_sent;
+        prunes += stats.tree_prune_sent;
+        edges += stats.tree_eager_peers;
+    }
+    printf("  redundant copies per broadcast: %llu first, %.1f settled; %llu tree edges, "
+           "%llu prunes, %llu grafts, %llu ihaves\n",
+           (unsigned long long)first_duplicates, steady, (unsigned long long)edges / 2,
+           (unsigned long long)prunes, (unsigned long long)grafts, (unsigned long long)ihaves);
+    if (!error && steady > NODES / 8) {
+        error = "Broadcast tree did not settle to about one copy per member";
+    }
+    
+    // A failed member's neighbours reconnect through IHAVE / GRAFT and repair
+    const int crashed = 9;
+    swim_sim_crash(sim, 4000 + crashed);
+    swim_sim_run(sim, 15000);
+    for (int m = 0; m < 5 && !error; m++) {
+        int origin = (m * 11 + 2) % NODES;
+        if (origin == crashed) origin++;
+        memset(delivered, 0, sizeof(delivered));
+        swim_broadcast(nodes[origin], (const uint8_t*)"hello", 6);
+        swim_sim_run(sim, 500);
+        for (int i = 0; i < NODES && !error; i++) {
+            if (i != crashed && delivered[i] != (i == origin ? 0 : 1)) {
+                error = "Tree broadcast lost after a member failed";
+            }
+        }
+    }
+    
+    swim_sim_destroy(sim);
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test the send budget holds user traffic to its allowance per round,
+ * drops from a full backlog, and leaves failure detection untouched
+ */
+int test_bandwidth_budget(void) {
+    printf("Testing bandwidth budget...\n");
+    
+    enum { NODES = 8, FLOOD = 150, BUDGET = 4096 };
+    swim_sim_t *sim = swim_sim_create(23);
+    swim_sim_set_network(sim, 1000, 0, 0);
+    
+    swim_context_t *nodes[NODES];
+    for (int i = 0; i < NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "budget-%02d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(5000 + i), 100);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 5000);
+    }
+    while (swim_sim_now_ms(sim) < 30000 &&
+           sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) < NODES * (NODES - 1)) {
+        swim_sim_run(sim, 100);
+    }
+    
+    // Members probing node 0 rely on its ACKs getting out past the flood
+    const char *error = NULL;
+    uint64_t failures_before = 0;
+    for (int i = 1; i < NODES; i++) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[i], &stats);
+        failures_before += stats.probe_failure;
+    }
+    
+    // Far more than one round's allowance, and more than the backlog holds
+    swim_set_bandwidth_budget(nodes[0], BUDGET, 0);
+    uint8_t payload[1000] = {0};
+    for (int m = 0; m < FLOOD && !error; m++) {
+        if (swim_send_to(nodes[0], "budget-01", payload, sizeof(payload)) != 0) error = "swim_send_to failed";
+    }
+    
+    swim_stats_t stats;
+    swim_get_detailed_stats(nodes[0], &stats);
+    uint64_t tx_before = stats.io_tx_bytes;
+    uint64_t worst_round = 0;
+    bool suspected = false;
+    for (int r = 0; r < 50 && !error; r++) {
+        swim_sim_run(sim, 100);
+        swim_get_detailed_stats(nodes[0], &stats);
+        if (stats.io_tx_bytes - tx_before > worst_round) worst_round = stats.io_tx_bytes - tx_before;
+        tx_before = stats.io_tx_bytes;
+        if (sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) != NODES * (NODES - 1)) suspected = true;
+    }
+    
+    swim_stats_t receiver;
+    swim_get_detailed_stats(nodes[1], &receiver);
+    uint64_t failures_after = 0;
+    for (int i = 1; i < NODES; i++) {
+        swim_stats_t node_stats;
+        swim_get_detailed_stats(nodes[i], &node_stats);
+        failures_after += node_stats.probe_failure;
+    }
+    printf("  %d x %zu bytes: %llu delivered, %llu deferred, %llu dropped bytes; "
+           "worst 100 ms sent %llu bytes, probe overdraft %llu\n",
+           FLOOD, sizeof(payload), (unsigned long long)receiver.user_received,
+           (unsigned long long)stats.budget_deferred_bytes, (unsigned long long)stats.budget_dropped_bytes,
+           (unsigned long long)worst_round, (unsigned long long)stats.budget_probe_overdraft);
+    if (!error && (stats.budget_deferred_bytes == 0 || stats.budget_dropped_bytes == 0)) {
+        error = "Flood was not deferred and trimmed";
+    }
+    if (!error && worst_round > 2 * BUDGET + SWIM_MAX_DATAGRAM) {
+        error = "Sent more than the budget in a round";
+    }
+    if (!error && (stats.backlog_bytes != 0 || receiver.user_received == 0 ||
+                   receiver.user_received >= FLOOD)) {
+        error = "Backlog did not drain";
+    }
+    if (!error && (failures_after != failures_before || suspected)) {
+        error = "Budget delayed failure detection";
+    }
+    
+    swim_sim_destroy(sim);
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+// Reliable channel test: what the receiver got and what the sender was told
+typedef struct {
+    int received;
+    size_t lens[8];
+    bool intact[8];
+    int delivered;
+    int failed;
+    uint32_t ids[8];
+} reliable_log_t;
+
+/**
+ * Pattern byte i of the large reliable message
+ */
+static uint8_t reliable_byte(size_t i) {
+    return (uint8_t)(i * 31 + (i >> 9) + 7);
+}
+
+/**
+ * Record a reassembled message and whether its content is as sent
+ */
+static void record_reliable_message(swim_node_t *from, const uint8_t *payload, size_t len, void *user_data) {
+    reliable_log_t *log = (reliable_log_t*)user_data;
+    if (!from || log->received >= 8) return;
+    
+    int n = log->received++;
+    log->lens[n] = len;
+    if (n == 0) {
+        log->intact[n] = true;
+        for (size_t i = 0; i < len; i++) {
+            if (payload[i] != reliable_byte(i)) log->intact[n] = false;
+        }
+    } else {
+        char expect[32];
+        snprintf(expect, sizeof(expect), "small-%d", n);
+        log->intact[n] = len == strlen(expect) + 1 && memcmp(payload, expect, len) == 0;
+    }
+}
+
+/**
+ * Record a message outcome
+ */
+static void record_reliable_done(const char *node_id, uint32_t msg_id, bool delivered, void *user_data) {
+    reliable_log_t *log = (reliable_log_t*)user_data;
+    (void)node_id;
+    if (delivered && log->delivered < 8) log->ids[log->delivered] = msg_id;
+    if (delivered) {
+        log->delivered++;
+    } else {
+        log->failed++;
+    }
+}
+
+/**
+ * Test fragmented messages arrive whole and in order over a lossy network,
+ * and that the sender learns of delivery or failure
+ */
+int test_reliable_channel(void) {
+    printf("Testing reliable channel...\n");
+    
+    enum { NODES = 3, BIG = 100000 };
+    swim_sim_t *sim = swim_sim_create(21);
+    swim_sim_set_network(sim, 1000, 0, 0.1);
+    
+    swim_context_t *nodes[NODES];
+    reliable_log_t logs[NODES];
+    memset(logs, 0, sizeof(logs));
+    for (int i = 0; i < NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "rel-%d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(3000 + i), 100);
+        swim_set_message_callback(nodes[i], record_reliable_message, &logs[i]);
+        swim_set_reliable_callback(nodes[i], record_reliable_done, &logs[i]);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 3000);
+    }
+    while (swim_sim_now_ms(sim) < 30000 &&
+           sim_count_state(nodes, NODES, NULL, NODE_STATE_ALIVE) < NODES * (NODES - 1)) {
+        swim_sim_run(sim, 100);
+    }
+    
+    const char *error = NULL;
+    uint8_t *big = (uint8_t*)malloc(BIG);
+    for (size_t i = 0; i < BIG; i++) big[i] = reliable_byte(i);
+    
+    // One large message, then small ones queued behind it
+    uint32_t ids[5];
+    if (swim_send_reliable(nodes[0], "rel-1", big, BIG, &ids[0]) != 0) {
+        error = "Large reliable message refused";
+    }
+    for (int i = 1; i < 5 && !error; i++) {
+        char msg[16];
+        snprintf(msg, sizeof(msg), "small-%d", i);
+        if (swim_send_reliable(nodes[0], "rel-1", (const uint8_t*)msg, strlen(msg) + 1, &ids[i]) != 0) {
+            error = "Small reliable message refused";
+        }
+    }
+    uint64_t start = swim_sim_now_ms(sim);
+    while (!error && logs[0].delivered < 5 && swim_sim_now_ms(sim) - start < 20000) {
+        swim_sim_run(sim, 10);
+    }
+    uint64_t elapsed_ms = swim_sim_now_ms(sim) - start;
+    
+    swim_stats_t sender, receiver;
+    swim_get_detailed_stats(nodes[0], &sender);
+    swim_get_detailed_stats(nodes[1], &receiver);
+    printf("  %d bytes + 4 small over 10%% loss: %llu ms, %llu fragments, %llu resent\n",
+           BIG, (unsigned long long)elapsed_ms, (unsigned long long)sender.channel_fragments,
+           (unsigned long long)sender.channel_retransmits);
+    
+    if (!error && (logs[1].received != 5 || logs[1].lens[0] != BIG)) {
+        error = "Reliable messages not delivered exactly once, in order";
+    }
+    for (int i = 0; i < 5 && !error; i++) {
+        if (!logs[1].intact[i]) error = "Reliable message corrupted";
+    }
+    if (!error && (logs[0].delivered != 5 || logs[0].failed != 0)) {
+        error = "Sender not told of every delivery";
+    }
+    for (int i = 0; i < 5 && !error; i++) {
+        if (logs[0].ids[i] != ids[i]) error = "Deliveries reported out of order";
+    }
+    if (!error && (sender.channel_retransmits == 0 || sender.channel_acked != 5 ||
+                   receiver.channel_received != 5)) {
+        error = "Reliable channel statistics wrong";
+    }
+    
+    // Refused up front: unknown member, oversized message
+    if (!error && (swim_send_reliable(nodes[0], "no-such-node", big, 10, NULL) != -1 ||
+                   swim_send_reliable(nodes[0], "rel-1", big, SWIM_CHANNEL_MAX_MESSAGE + 1, NULL) != -1)) {
+        error = "Invalid reliable message accepted";
+    }
+    
+    // A crashed member: the message is reported undelivered
+    swim_sim_crash(sim, 3002);
+    if (!error && swim_send_reliable(nodes[0], "rel-2", big, 5000, NULL) != 0) {
+        error = "Reliable message to crashed member refused";
+    }
+    start = swim_sim_now_ms(sim);
+    while (!error && logs[0].failed == 0 && swim_sim_now_ms(sim) - start < 30000) {
+        swim_sim_run(sim, 100);
+    }
+    if (!error && (logs[0].failed != 1 || logs[0].delivered != 5)) {
+        error = "Undeliverable message not reported";
+    }
+    
+    free(big);
+    swim_sim_destroy(sim);
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Whether a transport's descriptor is readable right now
+ */
+static bool transport_readable(swim_transport_t *t) {
+#ifdef _WIN32
+    (void)t;
+    return true;
+#else
+    struct pollfd pfd = { t->fd, POLLIN, 0 };
+    return poll(&pfd, 1, 0) > 0;
+#endif
+}
+
+/**
+ * Receive everything pending; checks in-order datagrams tagged with their index
+ * @return Datagrams received, or -1 on a lost, reordered or corrupted one
+ */
+static int drain_indexed(swim_transport_t *t, int *next) {
+    int received = 0;
+    uint32_t n;
+    const swim_io_rx_t *batch;
+    
+    while ((n = swim_transport_recv(t, &batch)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            const swim_io_rx_t *rx = &batch[i];
+            size_t len = 1 + (size_t)(*next * 37) % SWIM_IO_TX_SIZE;
+            if (rx->len != len || rx->data[0] != (uint8_t)*next || rx->data[len - 1] != (uint8_t)*next ||
+                ntohs(rx->from.sin_port) != 7980) {
+                return -1;
+            }
+            (*next)++;
+            received++;
+        }
+    }
+    return received;
+}
+
+/**
+ * Test co-located contexts exchange datagrams through shared-memory rings
+ */
+int test_shm_transport(void) {
+    printf("Testing shared-memory transport...\n");
+    
+    swim_shm_hub_t *hub = swim_shm_hub_create();
+    swim_transport_t *a = swim_transport_shm(hub, 7980);
+    swim_transport_t *b = swim_transport_shm(hub, 7981);
+    swim_transport_t *remote = swim_transport_udp(7982);
+    swim_shm_stats_t stats;
+    if (!hub || !a || !b || !remote) {
+        swim_transport_close(a);
+        swim_transport_close(b);
+        swim_transport_close(remote);
+        swim_shm_hub_destroy(hub);
+        TEST_FAIL("Failed to create transports");
+    }
+    if (!swim_transport_shm_stats(a, &stats)) {
+        printf("  Shared memory unavailable on this platform, UDP only\n");
+        swim_transport_close(a);
+        swim_transport_close(b);
+        swim_transport_close(remote);
+        swim_shm_hub_destroy(hub);
+        TEST_PASS();
+        return 0;
+    }
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(7981);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // Many laps around the ring, flushed in batches that always fit
+    const char *error = NULL;
+    int sent = 0, next = 0;
+    uint8_t payload[SWIM_IO_TX_SIZE];
+    while (sent < 2000 && !error) {
+        for (int i = 0; i < 16; i++, sent++) {
+            size_t len = 1 + (size_t)(sent * 37) % SWIM_IO_TX_SIZE;
+            memset(payload, (uint8_t)sent, len);
+            swim_transport_send(a, &to, payload, len);
+        }
+        swim_transport_flush(a);
+        if (!transport_readable(b)) {
+            error = "Receiver not woken";
+        } else if (drain_indexed(b, &next) < 0) {
+            error = "Datagram lost, reordered or corrupted";
+        } else if (next != sent) {
+            error = "Ring datagrams missing";
+        }
+    }
+    
+    swim_transport_shm_stats(a, &stats);
+    if (!error && (stats.local_tx != 2000 || stats.ring_full != 0 || a->tx_calls != stats.wakeups)) {
+        error = "Ring path used sockets";
+    }
+    
+    // A full ring spills to the socket without losing anything
+    if (!error) {
+        for (int i = 0; i < 64; i++) {
+            memset(payload, 0, 1000);
+            swim_transport_send(a, &to, payload, 1000);
+        }
+        swim_transport_flush(a);
+        sleep_ms(50);
+        
+        int received = 0;
+        uint32_t n;
+        const swim_io_rx_t *batch;
+        while ((n = swim_transport_recv(b, &batch)) > 0) {
+            received += (int)n;
+        }
+        swim_transport_shm_stats(a, &stats);
+        if (received != 64 || stats.ring_full == 0) {
+            error = "Ring overflow not sent over UDP";
+        }
+    }
+    
+    // Ports outside the hub are remote
+    if (!error) {
+        to.sin_port = htons(7982);
+        swim_transport_send(a, &to, payload, 10);
+        swim_transport_flush(a);
+        sleep_ms(20);
+        const swim_io_rx_t *batch;
+        swim_transport_shm_stats(a, &stats);
+        if (stats.remote_tx != 1 || swim_transport_recv(remote, &batch) != 1) {
+            error = "Remote datagram not sent over UDP";
+        }
+    }
+    
+    swim_transport_close(a);
+    swim_transport_close(b);
+    swim_transport_close(remote);
+    if (error) {
+        swim_shm_hub_destroy(hub);
+        TEST_FAIL(error);
+    }
+    
+    // Full protocol between co-located contexts never touches the loopback stack
+    swim_context_t *nodes[3];
+    for (int i = 0; i < 3; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "shm-node-%d", i);
+        nodes[i] = swim_init_transport(id, (uint16_t)(7983 + i), 50, swim_transport_shm(hub, (uint16_t)(7983 + i)));
+    }
+    if (!nodes[0] || !nodes[1] || !nodes[2]) {
+        for (int i = 0; i < 3; i++) swim_destroy(nodes[i]);
+        swim_shm_hub_destroy(hub);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    for (int i = 0; i < 3; i++) swim_start(nodes[i]);
+    swim_join(nodes[1], "127.0.0.1", 7983);
+    swim_join(nodes[2], "127.0.0.1", 7983);
+    
+    bool converged = false;
+    for (int i = 0; i < 60 && !converged; i++) {
+        sleep_ms(50);
+        converged = true;
+        for (int j = 0; j < 3; j++) {
+            converged = converged && swim_get_node_count(nodes[j], NODE_STATE_ALIVE) >= 3;
+        }
+    }
+    sleep_ms(200);
+    
+    uint64_t local = 0, udp = 0;
+    for (int i = 0; i < 3; i++) swim_stop(nodes[i]);
+    for (int i = 0; i < 3; i++) {
+        swim_shm_stats_t s;
+        swim_transport_shm_stats(nodes[i]->transport, &s);
+        local += s.local_tx;
+        udp += s.remote_tx + s.ring_full;
+    }
+    for (int i = 0; i < 3; i++) swim_destroy(nodes[i]);
+    swim_shm_hub_destroy(hub);
+    
+    printf("  %llu datagrams through rings, %llu over UDP\n",
+           (unsigned long long)local, (unsigned long long)udp);
+    if (!converged) {
+        TEST_FAIL("Co-located contexts did not converge");
+    }
+    if (local == 0 || udp != 0) {
+        TEST_FAIL("Co-located traffic left shared memory");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test several contexts driven by a shared reactor instead of their own threads
+ */
+int test_reactor(void) {
+    printf("Testing shared reactor...\n");
+    
+    swim_reactor_t *reactor = swim_reactor_create(2, false);
+    if (!reactor) {
+        TEST_FAIL("Failed to create reactor");
+    }
+    
+    swim_context_t *nodes[4];
+    bool attached = true;
+    for (int i = 0; i < 4; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "reactor-node-%d", i);
+        nodes[i] = swim_init(id, (uint16_t)(7986 + i), 50);
+        attached = attached && nodes[i] && swim_reactor_attach(reactor, nodes[i]) == 0;
+    }
+    if (!attached) {
+        for (int i = 0; i < 4; i++) swim_destroy(nodes[i]);
+        swim_reactor_destroy(reactor);
+        TEST_FAIL("Failed to attach contexts");
+    }
+    
+    for (int i = 0; i < 4; i++) swim_start(nodes[i]);
+    for (int i = 1; i < 4; i++) swim_join(nodes[i], "127.0.0.1", 7986);
+    
+    bool converged = false;
+    for (int i = 0; i < 60 && !converged; i++) {
+        sleep_ms(50);
+        converged = true;
+        for (int j = 0; j < 4; j++) {
+            converged = converged && swim_get_node_count(nodes[j], NODE_STATE_ALIVE) >= 4;
+        }
+    }
+    
+    // A stopped context is no longer driven: its peers suspect it
+    swim_stop(nodes[3]);
+    bool suspected = false;
+    for (int i = 0; i < 60 && !suspected; i++) {
+        sleep_ms(50);
+        swim_epoch_guard_t guard;
+        const swim_member_t *member = swim_membership_find(swim_membership_acquire(nodes[0], &guard),
+                                                           "reactor-node-3");
+        suspected = member && member->state != NODE_STATE_ALIVE;
+        swim_membership_release(nodes[0], &guard);
+    }
+    
+    swim_reactor_stats_t stats;
+    swim_reactor_get_stats(reactor, &stats);
+    
+    for (int i = 0; i < 4; i++) swim_destroy(nodes[i]);
+    swim_reactor_stats_t after;
+    swim_reactor_get_stats(reactor, &after);
+    swim_reactor_destroy(reactor);
+    
+    printf("  %u contexts on %u loops: %llu wakeups (%llu with datagrams), %llu deadline runs\n",
+           stats.contexts, stats.threads, (unsigned long long)stats.wakeups,
+           (unsigned long long)stats.io_wakeups, (unsigned long long)stats.deadlines_run);
+    if (!converged) {
+        TEST_FAIL("Reactor-driven contexts did not converge");
+    }
+    if (!suspected) {
+        TEST_FAIL("Stopped context still driven by the reactor");
+    }
+    if (stats.contexts != 4 || stats.threads != 2 || stats.io_wakeups == 0 || after.contexts != 0) {
+        TEST_FAIL("Reactor stats not recorded");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test a seed whose port is served by several SO_REUSEPORT sockets
+ */
+int test_rx_shards(void) {
+    printf("Testing SO_REUSEPORT receive shards...\n");
+    
+    swim_context_t *seed = swim_init_sharded("shard-seed", 7990, 50, 4);
+    if (!seed) {
+        TEST_FAIL("Failed to create sharded seed");
+    }
+    swim_start(seed);
+    
+    swim_context_t *clients[9];
+    for (int i = 0; i < 9; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "shard-client-%d", i);
+        clients[i] = swim_init(id, (uint16_t)(7991 + i), 50);
+        if (clients[i]) {
+            swim_start(clients[i]);
+            swim_join(clients[i], "127.0.0.1", 7990);
+        }
+    }
+    
+    bool converged = false;
+    for (int i = 0; i < 80 && !converged; i++) {
+        sleep_ms(50);
+        converged = swim_get_node_count(seed, NODE_STATE_ALIVE) >= 10;
+        for (int j = 0; j < 9; j++) {
+            converged = converged && clients[j] && swim_get_node_count(clients[j], NODE_STATE_ALIVE) >= 10;
+        }
+    }
+    
+    swim_stop(seed);
+    swim_stats_t stats;
+    swim_get_detailed_stats(seed, &stats);
+    
+    for (int i = 0; i < 9; i++) swim_destroy(clients[i]);
+    swim_destroy(seed);
+    
+    printf("  %u receive sockets: %llu datagrams, %llu on shards\n", stats.rx_shards,
+           (unsigned long long)stats.io_rx_datagrams, (unsigned long long)stats.shard_rx_datagrams);
+    if (!converged) {
+        TEST_FAIL("Cluster did not converge through a sharded seed");
+    }
+    if (stats.rx_shards > 1 && stats.shard_rx_datagrams == 0) {
+        TEST_FAIL("No datagrams received on shard sockets");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Count members whose id is a join placeholder ("seed-...")
+ */
+static uint32_t count_placeholders(swim_context_t *ctx) {
+    uint32_t count = 0;
+    swim_epoch_guard_t guard;
+    const swim_membership_t *m = swim_membership_acquire(ctx, &guard);
+    for (uint32_t i = 0; m && i < m->count; i++) {
+        if (strncmp(m->members[i].id, "seed-", 5) == 0) count++;
+    }
+    swim_membership_release(ctx, &guard);
+    return count;
+}
+
+/**
+ * Test a joining node gets the whole membership from the seed in one TCP
+ * exchange, and that a UDP join's seed placeholder is replaced by the
+ * seed's real entry without ever being gossiped
+ */
+int test_join_bootstrap(void) {
+    printf("Testing join bootstrap...\n");
+    
+    enum { MEMBERS = 24, SIM_NODES = 16 };
+    swim_context_t *seed = swim_init("boot-seed", 8200, 50);
+    if (!seed) {
+        TEST_FAIL("Failed to create seed");
+    }
+    swim_start(seed);
+    
+    const char *error = NULL;
+    swim_context_t *members[MEMBERS] = {0};
+    for (int i = 0; i < MEMBERS && !error; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "boot-member-%02d", i);
+        members[i] = swim_init(id, (uint16_t)(8201 + i), 50);
+        if (!members[i]) {
+            error = "Failed to create member";
+            break;
+        }
+        swim_start(members[i]);
+        if (swim_join(members[i], "127.0.0.1", 8200) != 0) error = "Join failed";
+    }
+    
+    // Every join was pushed to the seed, so it already knows the whole cluster
+    if (!error && swim_get_node_count(seed, NODE_STATE_ALIVE) != MEMBERS + 1) {
+        error = "Seed did not learn joiners from their bootstrap";
+    }
+    
+    // A fresh node knows everyone, under their real ids, when swim_join returns
+    swim_context_t *fresh = error ? NULL : swim_init("boot-fresh", 8200 + MEMBERS + 1, 50);
+    uint64_t join_us = 0;
+    if (fresh) {
+        swim_start(fresh);
+        uint64_t start = swim_transport_system_us();
+        if (swim_join(fresh, "127.0.0.1", 8200) != 0) error = "Fresh join failed";
+        join_us = swim_transport_system_us() - start;
+        
+        swim_stats_t stats;
+        swim_get_detailed_stats(fresh, &stats);
+        swim_node_t *seed_entry = swim_find_node(fresh, "boot-seed");
+        printf("  fresh node: %u members known %llu us after swim_join, %llu entries in %llu exchange\n",
+               swim_get_node_count(fresh, NODE_STATE_ALIVE), (unsigned long long)join_us,
+               (unsigned long long)stats.bootstrap_entries, (unsigned long long)stats.bootstrap_joins);
+        if (!error && swim_get_node_count(fresh, NODE_STATE_ALIVE) != MEMBERS + 2) {
+            error = "Fresh node did not get the full membership";
+        }
+        if (!error && (!seed_entry || seed_entry->port != 8200 || count_placeholders(fresh) != 0)) {
+            error = "Seed not known under its real id";
+        }
+        if (!error && (stats.bootstrap_joins != 1 || stats.bootstrap_failures != 0)) {
+            error = "Bootstrap counters wrong";
+        }
+    } else if (!error) {
+        error = "Failed to create fresh node";
+    }
+    
+    if (!error) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(seed, &stats);
+        if (stats.bootstrap_served != MEMBERS + 1) error = "Seed did not serve every join";
+    }
+    
+    swim_destroy(fresh);
+    for (int i = 0; i < MEMBERS; i++) swim_destroy(members[i]);
+    swim_destroy(seed);
+    
+    // The simulator has no TCP: joins fall back to UDP and a placeholder
+    swim_sim_t *sim = swim_sim_create(29);
+    swim_sim_set_network(sim, 1000, 0, 0);
+    swim_context_t *nodes[SIM_NODES];
+    for (int i = 0; i < SIM_NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "boot-sim-%02d", i);
+        nodes[i] = swim_sim_add_node(sim, id, (uint16_t)(5100 + i), 100);
+        if (i > 0) swim_join(nodes[i], "127.0.0.1", 5100);
+        if (!error && i > 0 && count_placeholders(nodes[i]) != 1) error = "UDP join added no placeholder";
+    }
+    swim_sim_run(sim, 10);
+    uint32_t placeholders = 0;
+    for (int i = 0; i < SIM_NODES; i++) placeholders += count_placeholders(nodes[i]);
+    if (!error && placeholders != 0) {
+        error = "Placeholder not replaced once the seed answered";
+    }
+    while (swim_sim_now_ms(sim) < 30000 &&
+           sim_count_state(nodes, SIM_NODES, NULL, NODE_STATE_ALIVE) < SIM_NODES * (SIM_NODES - 1)) {
+        swim_sim_run(sim, 100);
+    }
+    for (int i = 0; i < SIM_NODES && !error; i++) {
+        if (count_placeholders(nodes[i]) != 0 ||
+            swim_get_node_count(nodes[i], NODE_STATE_ALIVE) != SIM_NODES) {
+            error = "Placeholder gossiped or membership wrong after a UDP join";
+        }
+    }
+    swim_sim_destroy(sim);
+    
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test node manager instances join and serve joins over the TCP bootstrap,
+ * though their shared-memory transport comes from swim_init_transport
+ */
+int test_node_manager_join(void) {
+    printf("Testing node manager join bootstrap...\n");
+    
+    enum { MEMBERS = 20 };
+    swim_context_t *seed = swim_init("nm-seed", 8244, 50);
+    swim_transport_t *peer = swim_transport_udp(8250);
+    node_manager_t *mgr = node_manager_init("nm-server", 8245, 8249);
+    if (!seed || !peer || !mgr) {
+        swim_destroy(seed);
+        swim_transport_close(peer);
+        node_manager_destroy(mgr);
+        TEST_FAIL("Failed to create seed and manager");
+    }
+    
+    // Members the instances can only learn from the seed
+    send_members(peer, "nm-peer", 8244, "nm-member", MEMBERS);
+    sleep_ms(20);
+    swim_process(seed);
+    swim_start(seed);
+    uint32_t seed_known = swim_get_node_count(seed, NODE_STATE_ALIVE);
+    
+    // The first instance joins the seed, the second joins the first
+    const char *error = NULL;
+    node_instance_t *nodes[2] = {0};
+    for (int i = 0; i < 2 && !error; i++) {
+        node_instance_config_t config = {0};
+        snprintf(config.node_id, sizeof(config.node_id), "nm-node-%d", i);
+        config.auto_start = true;
+        strcpy(config.seed_address, "127.0.0.1");
+        config.seed_port = i == 0 ? 8244 : nodes[0]->swim_port;
+        nodes[i] = node_manager_create_node(mgr, &config);
+        if (!nodes[i]) {
+            error = "Failed to create instance";
+            break;
+        }
+        
+        // Everything is known when swim_join returns, no placeholder
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[i]->swim, &stats);
+        uint32_t known = swim_get_node_count(nodes[i]->swim, NODE_STATE_ALIVE);
+        printf("  %s: %u of %u members known after swim_join, %llu bootstrap joins\n", nodes[i]->id,
+               known, seed_known + i + 1, (unsigned long long)stats.bootstrap_joins);
+        if (stats.bootstrap_joins != 1 || stats.bootstrap_failures != 0) {
+            error = "Instance joined over UDP";
+        } else if (known < seed_known + i + 1 || count_placeholders(nodes[i]->swim) != 0) {
+            error = "Instance did not get the full membership";
+        }
+    }
+    
+    if (!error) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(nodes[0]->swim, &stats);
+        if (stats.bootstrap_served != 1) error = "Instance did not serve the join";
+    }
+    
+    node_manager_destroy(mgr);
+    swim_transport_close(peer);
+    swim_destroy(seed);
+    
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+/**
+ * Open a TCP connection to a local port
+ */
+static swim_socket_t connect_local_tcp(uint16_t port) {
+    swim_socket_t sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == SWIM_TRANSPORT_NO_FD) return sock;
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr*)&to, sizeof(to)) != 0) {
+        swim_bootstrap_close(sock);
+        return SWIM_TRANSPORT_NO_FD;
+    }
+    return sock;
+}
+
+/**
+ * Send one byte, without SIGPIPE if the peer is gone
+ */
+static bool send_byte(swim_socket_t sock, uint8_t byte) {
+#ifdef MSG_NOSIGNAL
+    return send(sock, (const char*)&byte, 1, MSG_NOSIGNAL) == 1;
+#else
+    return send(sock, (const char*)&byte, 1, 0) == 1;
+#endif
+}
+
+/**
+ * Whether the peer closes sock within timeout_ms
+ */
+static bool closed_within(swim_socket_t sock, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD pfd = { sock, POLLIN, 0 };
+    if (WSAPoll(&pfd, 1, timeout_ms) <= 0) return false;
+#else
+    struct pollfd pfd = { sock, POLLIN, 0 };
+    if (poll(&pfd, 1, timeout_ms) <= 0) return false;
+#endif
+    char byte;
+    return recv(sock, &byte, 1, 0) <= 0;
+}
+
+/**
+ * Test the bootstrap worker refuses an oversized request before reading
+ * it, drops a peer that trickles its request past the deadline, and keeps
+ * answering joiners afterwards
+ */
+int test_bootstrap_limits(void) {
+    printf("Testing bootstrap exchange limits...\n");
+    
+    swim_context_t *seed = swim_init("limit-seed", 8251, 50);
+    if (!seed) {
+        TEST_FAIL("Failed to create seed");
+    }
+    swim_start(seed);
+    
+    // A length prefix no member table needs closes the connection at once
+    const char *error = NULL;
+    const uint8_t huge[4] = { 0x00, 0xFF, 0xFF, 0xFF };
+    swim_socket_t sock = connect_local_tcp(8251);
+    if (sock == SWIM_TRANSPORT_NO_FD) {
+        error = "Failed to connect";
+    } else {
+        for (int i = 0; i < 4; i++) send_byte(sock, huge[i]);
+        if (!closed_within(sock, 500)) error = "Oversized request not refused";
+    }
+    swim_bootstrap_close(sock);
+    
+    // A byte every 100 ms would reset a per-read timeout forever
+    const uint8_t prefix[4] = { 0x00, 0x00, 0x01, 0x00 };
+    uint64_t held_ms = 0;
+    sock = error ? SWIM_TRANSPORT_NO_FD : connect_local_tcp(8251);
+    if (sock != SWIM_TRANSPORT_NO_FD) {
+        uint64_t start = swim_transport_system_us();
+        bool closed = false;
+        for (int i = 0; i < 2 * SWIM_BOOTSTRAP_TIMEOUT_MS / 100 && !closed; i++) {
+            send_byte(sock, i < 4 ? prefix[i] : 0);
+            closed = closed_within(sock, 100);
+        }
+        held_ms = (swim_transport_system_us() - start) / 1000;
+        printf("  slow peer held the worker for %llu ms\n", (unsigned long long)held_ms);
+        if (!closed) error = "Slow peer held the worker past the deadline";
+    } else if (!error) {
+        error = "Failed to connect";
+    }
+    swim_bootstrap_close(sock);
+    
+    // The worker is free again for a well-behaved joiner
+    swim_context_t *joiner = error ? NULL : swim_init("limit-joiner", 8252, 50);
+    if (joiner) {
+        swim_start(joiner);
+        swim_join(joiner, "127.0.0.1", 8251);
+        swim_stats_t stats;
+        swim_get_detailed_stats(joiner, &stats);
+        if (stats.bootstrap_joins != 1) error = "Join after a dropped peer failed";
+    } else if (!error) {
+        error = "Failed to create joiner";
+    }
+    
+    if (!error) {
+        swim_stats_t stats;
+        swim_get_detailed_stats(seed, &stats);
+        if (stats.bootstrap_served != 1) error = "Refused requests counted as served";
+    }
+    
+    swim_destroy(joiner);
+    swim_destroy(seed);
+    
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Receive replies to peer; counts ACK messages and checks datagram sizes
+ * @return ACKs received, or -1 on an oversized or malformed datagram
+ */
+static int drain_acks(swim_transport_t *peer, uint32_t mtu, int *datagrams) {
+    int acks = 0;
+    uint32_t n;
+    const swim_io_rx_t *batch;
+    
+    while ((n = swim_transport_recv(peer, &batch)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            swim_wire_reader_t r, part_reader;
+            swim_wire_header_t header;
+            const uint8_t *part;
+            size_t part_len;
+            int rc;
+            
+            if (batch[i].len > mtu) return -1;
+            (*datagrams)++;
+            swim_wire_reader_init(&r, batch[i].data, batch[i].len);
+            if (swim_wire_read_compound(&r) != 0) {
+                if (swim_wire_read_header(&r, &header) != 0) return -1;
+                acks += header.type == SWIM_MSG_ACK;
+                continue;
+            }
+            while ((rc = swim_wire_read_part(&r, &part, &part_len)) > 0) {
+                swim_wire_reader_init(&part_reader, part, part_len);
+                if (swim_wire_read_header(&part_reader, &header) != 0) return -1;
+                acks += header.type == SWIM_MSG_ACK;
+            }
+            if (rc < 0) return -1;
+        }
+    }
+    return acks;
+}
+
+/**
+ * Test replies to one peer are packed into COMPOUND datagrams within the
+ * MTU, and received COMPOUND datagrams are unpacked
+ */
+int test_compound_packing(void) {
+    printf("Testing compound packing...\n");
+    
+    swim_context_t *node = swim_init("compound-node", 8000, 1000);
+    swim_transport_t *peer = swim_transport_udp(8001);
+    if (!node || !peer) {
+        swim_destroy(node);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create node and peer");
+    }
+    swim_set_mtu(node, SWIM_MTU_MIN);
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(8000);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // A burst of PINGs handled in one batch: the ACKs share datagrams
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    for (uint32_t seq = 1; seq <= 20; seq++) {
+        size_t len = encode_ping(msg, sizeof(msg), "compound-peer", "compound-node", seq);
+        swim_transport_send(peer, &to, msg, len);
+    }
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(node);
+    sleep_ms(20);
+    
+    int datagrams = 0;
+    int acks = drain_acks(peer, SWIM_MTU_MIN, &datagrams);
+    swim_stats_t stats;
+    swim_get_detailed_stats(node, &stats);
+    printf("  20 ACKs in %d datagrams (%llu compound, %llu parts, mtu %u)\n", datagrams,
+           (unsigned long long)stats.compound_sent, (unsigned long long)stats.compound_parts, stats.mtu);
+    
+    const char *error = NULL;
+    if (acks != 20) {
+        error = "ACKs lost, oversized or malformed";
+    } else if (datagrams >= 10 || stats.compound_sent == 0 || stats.datagrams_sent != (uint64_t)datagrams) {
+        error = "ACKs not packed";
+    }
+    
+    // A COMPOUND of PINGs is unpacked and each one answered
+    if (!error) {
+        uint8_t compound[SWIM_MAX_DATAGRAM];
+        swim_wire_writer_t w;
+        swim_wire_writer_init(&w, compound, sizeof(compound));
+        swim_wire_write_compound(&w);
+        for (uint32_t seq = 21; seq <= 23; seq++) {
+            size_t len = encode_ping(msg, sizeof(msg), "compound-peer", "compound-node", seq);
+            swim_wire_write_part(&w, msg, len);
+        }
+        swim_transport_send(peer, &to, compound, w.len);
+        swim_transport_flush(peer);
+        sleep_ms(20);
+        swim_process(node);
+        sleep_ms(20);
+        
+        datagrams = 0;
+        acks = drain_acks(peer, SWIM_MTU_MIN, &datagrams);
+        swim_get_detailed_stats(node, &stats);
+        if (acks != 3 || datagrams != 1 || stats.compound_received != 1 || stats.messages_received != 23) {
+            error = "Compound PINGs not unpacked";
+        }
+    }
+    
+    // A truncated part is malformed, not a short read
+    if (!error) {
+        swim_wire_reader_t r;
+        const uint8_t *part;
+        size_t part_len;
+        uint8_t truncated[] = { SWIM_WIRE_VERSION, SWIM_MSG_COMPOUND, 10, 1, 2, 3 };
+        swim_wire_reader_init(&r, truncated, sizeof(truncated));
+        if (swim_wire_read_compound(&r) != 0 || swim_wire_read_part(&r, &part, &part_len) != -1) {
+            error = "Truncated part accepted";
+        }
+    }
+    
+    swim_destroy(node);
+    swim_transport_close(peer);
+    if (error) {
+        TEST_FAIL(error);
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+static void count_data(const swim_wire_header_t *header, swim_wire_reader_t *body, void *arg) {
+    (void)body;
+    *(int*)arg += header->type == SWIM_MSG_DATA;
+}
+
+/**
+ * Test reliable channel fragments are cut to the configured MTU
+ */
+int test_channel_mtu(void) {
+    printf("Testing channel fragments within the MTU...\n");
+    
+    enum { LEN = 3000 };
+    swim_context_t *node = swim_init("mtu-node", 8234, 1000);
+    swim_transport_t *peer = swim_transport_udp(8235);
+    if (!node || !peer) {
+        swim_destroy(node);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create node and peer");
+    }
+    swim_set_mtu(node, SWIM_MTU_MIN);
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(8234);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // A PING makes the peer a member
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    size_t len = encode_ping(msg, sizeof(msg), "mtu-peer", "mtu-node", 1);
+    swim_transport_send(peer, &to, msg, len);
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(node);
+    sleep_ms(20);
+    int ignored = 0;
+    drain_messages(peer, SWIM_MTU_MIN, count_data, &ignored);
+    
+    uint8_t *payload = (uint8_t*)calloc(1, LEN);
+    int sent = payload ? swim_send_reliable(node, "mtu-peer", payload, LEN, NULL) : -1;
+    free(payload);
+    sleep_ms(20);
+    
+    int fragments = 0;
+    int datagrams = drain_messages(peer, SWIM_MTU_MIN, count_data, &fragments);
+    
+    swim_destroy(node);
+    swim_transport_close(peer);
+    
+    printf("  %d bytes in %d DATA fragments of at most %d bytes\n", LEN, fragments, SWIM_MTU_MIN);
+    if (sent != 0) {
+        TEST_FAIL("Reliable message refused");
+    }
+    if (datagrams < 0) {
+        TEST_FAIL("Fragment over the MTU or malformed");
+    }
+    if (fragments < LEN / SWIM_MTU_MIN + 1) {
+        TEST_FAIL("Fragments missing");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test exact copies of a message are dropped after the header, while the
+ * same seq with another type still gets through
+ */
+int test_duplicate_suppression(void) {
+    printf("Testing duplicate suppression...\n");
+    
+    // The filter forgets keys once they leave the window
+    swim_dedup_t *dedup = (swim_dedup_t*)malloc(sizeof(swim_dedup_t));
+    if (!dedup) TEST_FAIL("Out of memory");
+    swim_dedup_init(dedup, 0);
+    bool first = swim_dedup_seen(dedup, 7, 1, SWIM_MSG_PING, 0);
+    bool again = swim_dedup_seen(dedup, 7, 1, SWIM_MSG_PING, 10);
+    bool other_type = swim_dedup_seen(dedup, 7, 1, SWIM_MSG_ACK, 10);
+    bool other_sender = swim_dedup_seen(dedup, 8, 1, SWIM_MSG_PING, 10);
+    bool later = swim_dedup_seen(dedup, 7, 1, SWIM_MSG_PING, SWIM_DEDUP_WINDOW_MS + 5);
+    bool expired = swim_dedup_seen(dedup, 7, 1, SWIM_MSG_PING, 3 * SWIM_DEDUP_WINDOW_MS + 20);
+    bool zero_first = swim_dedup_seen(dedup, 7, 0, SWIM_MSG_SYNC, 3 * SWIM_DEDUP_WINDOW_MS + 20);
+    bool zero_again = swim_dedup_seen(dedup, 7, 0, SWIM_MSG_SYNC, 3 * SWIM_DEDUP_WINDOW_MS + 20);
+    free(dedup);
+    if (first || !again || other_type || other_sender || !later || expired || zero_first || !zero_again) {
+        TEST_FAIL("Filter window wrong");
+    }
+    
+    swim_context_t *node = swim_init("dedup-node", 8230, 1000);
+    swim_transport_t *peer = swim_transport_udp(8231);
+    if (!node || !peer) {
+        swim_destroy(node);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create node and peer");
+    }
+    
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_port = htons(8230);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    // PING 1 three times and PING 2 once: two ACKs
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    size_t len = encode_ping(msg, sizeof(msg), "dedup-peer", "dedup-node", 1);
+    for (int i = 0; i < 3; i++) {
+        swim_transport_send(peer, &to, msg, len);
+    }
+    len = encode_ping(msg, sizeof(msg), "dedup-peer", "dedup-node", 2);
+    swim_transport_send(peer, &to, msg, len);
+    
+    // An ACK reusing seq 1 is a different message
+    swim_wire_writer_t w;
+    swim_wire_header_t header = {0};
+    header.type = SWIM_MSG_ACK;
+    header.seq_num = 1;
+    header.incarnation = 1;
+    strcpy(header.sender_id, "dedup-peer");
+    swim_wire_writer_init(&w, msg, sizeof(msg));
+    swim_wire_write_header(&w, &header);
+    swim_transport_send(peer, &to, msg, w.len);
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(node);
+    sleep_ms(20);
+    
+    int datagrams = 0;
+    int acks = drain_acks(peer, SWIM_MAX_DATAGRAM, &datagrams);
+    swim_stats_t stats;
+    swim_get_detailed_stats(node, &stats);
+    printf("  %llu of %llu copies dropped (%.0f%%), %d ACKs\n",
+           (unsigned long long)stats.duplicates_dropped,
+           (unsigned long long)(stats.duplicates_dropped + stats.messages_received),
+           stats.duplicate_rate * 100.0, acks);
+    
+    swim_destroy(node);
+    swim_transport_close(peer);
+    if (acks != 2) {
+        TEST_FAIL("Duplicate PINGs answered");
+    }
+    if (stats.duplicates_dropped != 2 || stats.messages_received != 3 ||
+        fabs(stats.duplicate_rate - 0.4) > 1e-9) {
+        TEST_FAIL("Duplicates not counted");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test every page of a multi-page SYNC diff gets past duplicate
+ * suppression: the pages a node sends in answer to a digest are relayed
+ * to a third node, which must merge them all
+ */
+int test_sync_pages_dedup(void) {
+    printf("Testing SYNC pages past duplicate suppression...\n");
+    
+    enum { MEMBERS = 400 };
+    swim_context_t *a = swim_init("pages-a", 8236, 1000);
+    swim_context_t *c = swim_init("pages-c", 8238, 1000);
+    swim_transport_t *peer = swim_transport_udp(8237);
+    if (!a || !c || !peer) {
+        swim_destroy(a);
+        swim_destroy(c);
+        swim_transport_close(peer);
+        TEST_FAIL("Failed to create nodes and peer");
+    }
+    
+    send_members(peer, "pages-peer", 8236, "pages-member", MEMBERS);
+    swim_process(a);
+    
+    struct sockaddr_in to_a, to_c;
+    memset(&to_a, 0, sizeof(to_a));
+    to_a.sin_family = AF_INET;
+    to_a.sin_port = htons(8236);
+    to_a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    to_c = to_a;
+    to_c.sin_port = htons(8238);
+    
+    // An empty digest: a answers with everything it knows
+    uint32_t empty[SWIM_SYNC_BUCKETS] = {0};
+    uint8_t msg[SWIM_MAX_DATAGRAM];
+    size_t len = encode_digest(msg, sizeof(msg), "pages-peer", 1000, empty, SWIM_SYNC_BUCKETS);
+    swim_transport_send(peer, &to_a, msg, len);
+    swim_transport_flush(peer);
+    sleep_ms(20);
+    swim_process(a);
+    sleep_ms(20);
+    
+    uint32_t n;
+    const swim_io_rx_t *batch;
+    while ((n = swim_transport_recv(peer, &batch)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            swim_transport_send(peer, &to_c, batch[i].data, batch[i].len);
+        }
+        swim_transport_flush(peer);
+    }
+    sleep_ms(20);
+    swim_process(c);
+    
+    swim_stats_t sent, merged;
+    swim_get_detailed_stats(a, &sent);
+    swim_get_detailed_stats(c, &merged);
+    uint32_t known_a = a->node_count;
+    uint32_t known_c = c->node_count;
+    
+    swim_destroy(a);
+    swim_destroy(c);
+    swim_transport_close(peer);
+    
+    printf("  %llu pages: %u of %u members merged, %llu dropped as duplicates\n",
+           (unsigned long long)sent.sync_pages, known_c - 1, known_a,
+           (unsigned long long)merged.duplicates_dropped);
+    if (known_a < MEMBERS || sent.sync_pages < 2) {
+        TEST_FAIL("Diff did not take several pages");
+    }
+    if (known_c < known_a + 1 || merged.duplicates_dropped != 0) {
+        TEST_FAIL("SYNC pages dropped as duplicates");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test membership spreads through piggybacked updates (no periodic SYNC)
+ */
+int test_dissemination(void) {
+    printf("Testing piggyback dissemination...\n");
+    
+    swim_context_t *a = swim_init("dissem-a", 7951, 50);
+    swim_context_t *b = swim_init("dissem-b", 7952, 50);
+    swim_context_t *c = swim_init("dissem-c", 7953, 50);
+    if (!a || !b || !c) {
+        swim_destroy(a);
+        swim_destroy(b);
+        swim_destroy(c);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_start(c);
+    
+    // B and C only ever talk to A directly
+    swim_join(b, "127.0.0.1", 7951);
+    swim_join(c, "127.0.0.1", 7951);
+    
+    bool converged = false;
+    for (int i = 0; i < 100 && !converged; i++) {
+        sleep_ms(50);
+        converged = swim_find_node(b, "dissem-c") != NULL &&
+                    swim_find_node(c, "dissem-b") != NULL;
+    }
+    
+    swim_destroy(c);
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    if (!converged) {
+        TEST_FAIL("Members did not learn about each other via A");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+/**
+ * Test failed member is probed and suspected within one probe pass
+ */
+int test_probe_scheduler(void) {
+    printf("Testing probe scheduler failure detection...\n");
+    
+    swim_context_t *a = swim_init("probe-a", 7954, 50);
+    swim_context_t *b = swim_init("probe-b", 7955, 50);
+    swim_context_t *c = swim_init("probe-c", 7956, 50);
+    if (!a || !b || !c) {
+        swim_destroy(a);
+        swim_destroy(b);
+        swim_destroy(c);
+        TEST_FAIL("Failed to create SWIM contexts");
+    }
+    
+    swim_start(a);
+    swim_start(b);
+    swim_start(c);
+    swim_join(b, "127.0.0.1", 7954);
+    swim_join(c, "127.0.0.1", 7954);
+    
+    for (int i = 0; i < 40 && swim_get_node_count(a, NODE_STATE_ALIVE) < 3; i++) {
+        sleep_ms(50);
+    }
+    
+    // Kill C and wait for A to notice
+    swim_destroy(c);
+    
+    bool detected = false;
+    swim_stats_t stats;
+    for (int i = 0; i < 60 && !detected; i++) {
+        sleep_ms(50);
+        swim_node_t *node = swim_find_node(a, "probe-c");
+        swim_get_detailed_stats(a, &stats);
+        detected = node && node->state != NODE_STATE_ALIVE && stats.first_probe_samples > 0;
+    }
+    
+    swim_destroy(b);
+    swim_destroy(a);
+    
+    if (!detected) {
+        TEST_FAIL("Failed member not suspected");
+    }
+    if (stats.first_probe_samples == 0 || stats.probe_passes == 0) {
+        TEST_FAIL("Probe scheduler stats not recorded");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
+// Timer wheel test state
+typedef struct {
+    swim_timer_wheel_t *wheel;
+    int fired;
+    int late;
+} timer_test_t;
+
+static void timer_test_cb(swim_timer_t *timer, void *arg) {
+    timer_test_t *t = (timer_test_t*)arg;
+    t->fired++;
+    if (t->wheel->now != timer->expires) t->late++;
+}
+
+/**
+ * Test timer wheel fires every timer exactly at its deadline across cascades
+ */
+int test_timer_wheel(void) {
+    printf("Testing swim_timer wheel...\n");
+    
+    enum { COUNT = 2000 };
+    static swim_timer_wheel_t wheel;
+    static swim_timer_t timers[COUNT];
+    timer_test_t state = { &wheel, 0, 0 };
+    
+    swim_timer_wheel_init(&wheel, 1000);
+    srand(7);
+    for (int i = 0; i < COUNT; i++) {
+        swim_timer_init(&timers[i], NULL, 0);
+        // Mix of near (level 0) and far (levels 1-3) deadlines
+        uint64_t delay = (i % 4 == 0) ? (uint64_t)(rand() % 64) + 1 : (uint64_t)(rand() % 600000) + 1;
+        swim_timer_schedule(&wheel, &timers[i], 1000 + delay);
+    }
+    
+    // Cancel a tenth of them
+    for (int i = 0; i < COUNT; i += 10) {
+        swim_timer_cancel(&wheel, &timers[i]);
+    }
+    
+    // Next expiry must never be later than the earliest live deadline
+    uint64_t earliest = SWIM_TIMER_NEVER;
+    for (int i = 0; i < COUNT; i++) {
+        if (timers[i].active && timers[i].expires < earliest) earliest = timers[i].expires;
+    }
+    if (swim_timer_next_expiry(&wheel) > earliest) {
+        TEST_FAIL("Next expiry later than earliest deadline");
+    }
+    
+    // Advance in irregular steps
+    uint64_t now = 1000;
+    while (now < 1000 + 600001) {
+        now += (uint64_t)(rand() % 5000) + 1;
+        swim_timer_advance(&wheel, now, timer_test_cb, &state);
+    }
+    
+    if (state.fired != COUNT - COUNT / 10) {
+        TEST_FAIL("Not every armed timer fired exactly once");
+    }
+    if (state.late != 0) {
+        TEST_FAIL("Timer fired at the wrong tick");
+    }
+    if (wheel.active != 0) {
+        TEST_FAIL("Wheel still has active timers");
+    }
+    
+    TEST_PASS();
+    return 0;
+}
+
 /**
  * Test main node setting
  */
@@ -179,8 +3060,40 @@ int main(void) {
     failures += test_swim_init();
     failures += test_node_count();
     failures += test_node_lookup();
+    failures += test_node_index();
+    failures += test_timer_wheel();
+    failures += test_wire_format();
+    failures += test_batched_io();
     failures += test_main_node();
     failures += test_statistics();
+    failures += test_dissemination();
+    failures += test_probe_scheduler();
+    failures += test_ack_latency();
+    failures += test_failure_detector();
+    failures += test_indirect_probe();
+    failures += test_anti_entropy();
+    failures += test_digest_mtu();
+    failures += test_membership_snapshot();
+    failures += test_event_queue();
+    failures += test_rtt_tracking();
+    failures += test_network_coordinates();
+    failures += test_simulated_network();
+    failures += test_user_messages();
+    failures += test_user_restart();
+    failures += test_user_origin_collision();
+    failures += test_reliable_channel();
+    failures += test_broadcast_tree();
+    failures += test_bandwidth_budget();
+    failures += test_shm_transport();
+    failures += test_reactor();
+    failures += test_rx_shards();
+    failures += test_join_bootstrap();
+    failures += test_node_manager_join();
+    failures += test_bootstrap_limits();
+    failures += test_compound_packing();
+    failures += test_channel_mtu();
+    failures += test_duplicate_suppression();
+    failures += test_sync_pages_dedup();
     
     printf("\n----------------------------------------\n");
     if (failures == 0) {